@@ -0,0 +1,30 @@
+// file      : abbreviation-separator/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test option abbreviations without the option separator.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    if (o.verbose ())
+      cout << "--verbose" << endl;
+
+    if (o.version ())
+      cout << "--version" << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,49 @@
+// file      : abbreviation/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test option abbreviations.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    int end;
+    options o (argc, argv, end);
+
+    if (o.verbose ())
+      cout << "--verbose" << endl;
+
+    if (o.version ())
+      cout << "--version" << endl;
+
+    if (o.dir ())
+      cout << "--dir" << endl;
+
+    if (!o.dirty ().empty ())
+      cout << "--dirty " << o.dirty () << endl;
+
+    if (!o.output ().empty ())
+      cout << "--output " << o.output () << endl;
+
+    if (o.a ())
+      cout << "-a" << endl;
+
+    if (o.b ())
+      cout << "-b" << endl;
+
+    for (int i (end); i < argc; ++i)
+      cout << argv[i] << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,76 @@
+// file      : argv/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test options serialization. Print the command line arguments and the
+// options file produced from the parsed options and verify that both
+// parse back into the same options.
+//
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    cli::argv_buffer b;
+    o.to_argv (b, "driver");
+
+    for (int i (0); i < b.argc (); ++i)
+      cout << '[' << b.argv ()[i] << ']' << endl;
+
+    string f;
+    o.to_options_file (f);
+    cout << f;
+
+    // Round trip through the command line arguments.
+    //
+    {
+      int ac (b.argc ());
+      options x (ac, b.argv ());
+
+      cli::argv_buffer xb;
+      x.to_argv (xb, "driver");
+
+      string xf;
+      x.to_options_file (xf);
+
+      if (xf != f || xb.argc () != b.argc ())
+        cerr << "argv round trip mismatch" << endl;
+    }
+
+    // Round trip through the options file.
+    //
+    {
+      {
+        ofstream os ("test.ops");
+        os << f;
+      }
+
+      char* args[] = {argv[0],
+                      const_cast<char*> ("--options-file"),
+                      const_cast<char*> ("test.ops")};
+      int ac (3);
+      cli::argv_file_scanner s (ac, args, "--options-file");
+      options x (s);
+
+      string xf;
+      x.to_options_file (xf);
+
+      if (xf != f)
+        cerr << "options file round trip mismatch" << endl;
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
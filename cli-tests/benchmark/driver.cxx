@@ -0,0 +1,313 @@
+// file      : benchmark/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Benchmark the generated runtime. Print the results one per line in the
+// '<benchmark> <value> <unit>' form suitable for tracking regressions
+// across releases.
+//
+// Usage: driver [--iterations <n>] [--file-size <MiB>]
+//
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>   // remove()
+#include <cstdlib>  // strtoul()
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "bench.hxx"
+
+using namespace std;
+
+typedef chrono::steady_clock clock_type;
+
+// Static initialization cost is approximated as the time between the
+// initialization of this object, which is arranged to happen before any
+// other static object, and the start of main().
+//
+#if defined(__GNUC__) && !defined(_WIN32)
+static const clock_type::time_point init_start
+__attribute__ ((init_priority (101))) (clock_type::now ());
+#  define BENCH_INIT_START
+#elif defined(_MSC_VER)
+#  pragma warning (disable: 4073)
+#  pragma init_seg (lib)
+static const clock_type::time_point init_start (clock_type::now ());
+#  define BENCH_INIT_START
+#endif
+
+static double
+ns (clock_type::time_point s, clock_type::time_point e)
+{
+  return static_cast<double> (
+    chrono::duration_cast<chrono::nanoseconds> (e - s).count ());
+}
+
+static void
+report (const char* name, double value, const char* unit)
+{
+  cout << name << ' ' << value << ' ' << unit << endl;
+}
+
+// Command line arguments that can be parsed repeatedly.
+//
+struct arguments
+{
+  vector<string> strings;
+  vector<char*> pointers;
+
+  void
+  add (const string& a)
+  {
+    strings.push_back (a);
+  }
+
+  char**
+  argv ()
+  {
+    pointers.clear ();
+    pointers.push_back (const_cast<char*> ("driver"));
+
+    for (size_t i (0); i != strings.size (); ++i)
+      pointers.push_back (const_cast<char*> (strings[i].c_str ()));
+
+    pointers.push_back (0);
+    return &pointers[0];
+  }
+
+  size_t
+  size () const
+  {
+    return strings.size ();
+  }
+};
+
+// Parse the arguments into options class O the specified number of times
+// and report nanoseconds per argument.
+//
+template <typename O>
+static void
+parse (const char* name, arguments& args, size_t iterations)
+{
+  char** argv (args.argv ());
+
+  clock_type::time_point s (clock_type::now ());
+
+  for (size_t i (0); i != iterations; ++i)
+  {
+    int argc (static_cast<int> (args.size () + 1));
+    O o (argc, argv);
+  }
+
+  clock_type::time_point e (clock_type::now ());
+
+  report (name, ns (s, e) / (iterations * args.size ()), "ns/arg");
+}
+
+int
+main (int argc, char* argv[])
+{
+  clock_type::time_point main_start (clock_type::now ());
+
+  size_t iterations (100);
+  size_t file_size (4); // MiB.
+
+  for (int i (1); i < argc; ++i)
+  {
+    string a (argv[i]);
+
+    if (i + 1 < argc && a == "--iterations")
+      iterations = strtoul (argv[++i], 0, 10);
+    else if (i + 1 < argc && a == "--file-size")
+      file_size = strtoul (argv[++i], 0, 10);
+    else
+    {
+      cerr << "usage: " << argv[0] << " [--iterations <n>] "
+           << "[--file-size <MiB>]" << endl;
+      return 1;
+    }
+  }
+
+  if (iterations == 0)
+    iterations = 1;
+
+  try
+  {
+#ifdef BENCH_INIT_START
+    report ("startup.static-init", ns (init_start, main_start), "ns");
+#else
+    (void) main_start;
+#endif
+
+    // Default construction.
+    //
+    {
+      clock_type::time_point s (clock_type::now ());
+
+      for (size_t i (0); i != iterations; ++i)
+      {
+        options_10 o10;
+        options_100 o100;
+        options_1000 o1000;
+        deep_31 d;
+      }
+
+      clock_type::time_point e (clock_type::now ());
+      report ("startup.construct", ns (s, e) / iterations, "ns");
+    }
+
+    // Per-argument throughput for each kind of argument. Spread the
+    // options over the whole class.
+    //
+    const size_t n (10000);
+
+    arguments flags, strings, numerics, combined, deep;
+
+    for (size_t i (0); i != n; ++i)
+    {
+      size_t j ((i * 4 * 7) % 1000); // Multiple of 4.
+
+      ostringstream f, s, in, d;
+      f << "--flag-" << j;
+      s << "--string-" << j + 1;
+      in << "--int-" << j + 2;
+      d << "--double-" << j + 3;
+
+      flags.add (f.str ());
+
+      strings.add (s.str ());
+      strings.add ("value");
+
+      numerics.add (in.str ());
+      numerics.add ("12345");
+      numerics.add (d.str ());
+      numerics.add ("1.5");
+
+      combined.add (s.str () + "=value");
+      combined.add (in.str () + "=12345");
+
+      ostringstream df, ds;
+      df << "--deep-flag-" << i % 32;
+      ds << "--deep-string-" << i % 32;
+      deep.add (df.str ());
+      deep.add (ds.str ());
+      deep.add ("value");
+    }
+
+    parse<options_1000> ("parse.flag", flags, iterations);
+    parse<options_1000> ("parse.string", strings, iterations);
+    parse<options_1000> ("parse.numeric", numerics, iterations);
+    parse<options_1000> ("parse.combined", combined, iterations);
+    parse<deep_31> ("parse.deep-inheritance", deep, iterations);
+
+    // Smaller classes.
+    //
+    {
+      arguments a10, a100;
+
+      for (size_t i (0); i != n; ++i)
+      {
+        ostringstream f10, f100;
+        f10 << "--string-" << (i % 2) * 4 + 1;
+        f100 << "--string-" << (i % 25) * 4 + 1;
+
+        a10.add (f10.str ());
+        a10.add ("value");
+        a100.add (f100.str ());
+        a100.add ("value");
+      }
+
+      parse<options_10> ("parse.string-10", a10, iterations);
+      parse<options_100> ("parse.string-100", a100, iterations);
+    }
+
+    // The group_scanner overhead compared to the argv_scanner.
+    //
+    {
+      char** av (flags.argv ());
+
+      clock_type::time_point s (clock_type::now ());
+
+      for (size_t i (0); i != iterations; ++i)
+      {
+        int ac (static_cast<int> (flags.size () + 1));
+        cli::argv_scanner as (ac, av);
+        cli::group_scanner gs (as);
+        options_1000 o (gs);
+      }
+
+      clock_type::time_point e (clock_type::now ());
+
+      report ("parse.group-scanner",
+              ns (s, e) / (iterations * flags.size ()),
+              "ns/arg");
+    }
+
+    // The argv_file_scanner throughput on a large file.
+    //
+    {
+      const char* path ("benchmark.ops");
+      size_t size (0);
+      {
+        ofstream ofs (path);
+
+        for (size_t i (0); size < file_size * 1024 * 1024; ++i)
+        {
+          ostringstream l;
+          size_t j ((i * 4 * 7) % 1000);
+
+          switch (i % 3)
+          {
+          case 0: l << "--flag-" << j << '\n'; break;
+          case 1: l << "--string-" << j + 1 << " \"some value\"\n"; break;
+          case 2: l << "--int-" << j + 2 << " 12345\n"; break;
+          }
+
+          ofs << l.str ();
+          size += l.str ().size ();
+        }
+      }
+
+      size_t fi (iterations / 10 != 0 ? iterations / 10 : 1);
+
+      clock_type::time_point s (clock_type::now ());
+
+      for (size_t i (0); i != fi; ++i)
+      {
+        cli::argv_file_scanner fs (path, "--options-file");
+        options_1000 o (fs);
+      }
+
+      clock_type::time_point e (clock_type::now ());
+
+      std::remove (path);
+
+      report ("file-scanner.throughput",
+              (static_cast<double> (size) * fi / (1024 * 1024)) /
+              (ns (s, e) / 1e9),
+              "MiB/s");
+    }
+
+    // Usage printing.
+    //
+    {
+      clock_type::time_point s (clock_type::now ());
+
+      for (size_t i (0); i != iterations; ++i)
+      {
+        ostringstream os;
+        options_1000::print_usage (os);
+      }
+
+      clock_type::time_point e (clock_type::now ());
+      report ("usage.print-1000", ns (s, e) / iterations, "ns");
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,67 @@
+// file      : benchmark/generator.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Generate the benchmark options classes: options_10, options_100, and
+// options_1000 with the respective number of options of the bool,
+// std::string, int, and double types as well as the deep_0 ... deep_31
+// inheritance chain with two options per class.
+//
+#include <cstddef>
+#include <iostream>
+
+using namespace std;
+
+static const size_t depth = 32;
+
+static void
+generate (size_t n)
+{
+  cout << "class options_" << n << endl
+       << "{" << endl;
+
+  for (size_t i (0); i != n; ++i)
+  {
+    switch (i % 4)
+    {
+    case 0: cout << "  bool --flag-"; break;
+    case 1: cout << "  std::string --string-"; break;
+    case 2: cout << "  int --int-"; break;
+    case 3: cout << "  double --double-"; break;
+    }
+
+    cout << i << " {\"Option " << i << ".\"};" << endl;
+  }
+
+  cout << "};" << endl
+       << endl;
+}
+
+int
+main ()
+{
+  cout << "// Generated by the benchmark generator, do not edit." << endl
+       << "//" << endl
+       << endl
+       << "include <string>;" << endl
+       << endl;
+
+  generate (10);
+  generate (100);
+  generate (1000);
+
+  for (size_t i (0); i != depth; ++i)
+  {
+    cout << "class deep_" << i;
+
+    if (i != 0)
+      cout << ": deep_" << i - 1;
+
+    cout << endl
+         << "{" << endl
+         << "  bool --deep-flag-" << i << " {\"Option " << i << ".\"};" << endl
+         << "  std::string --deep-string-" << i << " {\"Option " << i << ".\"};"
+         << endl
+         << "};" << endl
+         << endl;
+  }
+}
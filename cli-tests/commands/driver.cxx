@@ -0,0 +1,83 @@
+// file      : commands/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test subcommand dispatch.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+using namespace tool;
+
+struct handler
+{
+  void
+  operator() (const build_options& o) const
+  {
+    cout << "target " << o.target () << endl
+         << "jobs " << o.jobs () << endl;
+
+    if (o.verbose ())
+      cout << "verbose" << endl;
+  }
+
+  void
+  operator() (const clean_options& o) const
+  {
+    if (o.all ())
+      cout << "all" << endl;
+
+    if (o.verbose ())
+      cout << "verbose" << endl;
+  }
+};
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    cli::argv_scanner s (argc, argv);
+
+    if (!s.more ())
+    {
+      cerr << "command expected" << endl;
+      return 1;
+    }
+
+    bool usage (false);
+    if (string (s.peek ()) == "help")
+    {
+      s.next ();
+      usage = true;
+    }
+
+    const char* n (s.next ());
+
+    command::value c;
+    if (!command::find (n, c))
+    {
+      cerr << "unknown command '" << n << "'" << endl;
+      return 1;
+    }
+
+    cout << command::name (c) << endl;
+
+    if (usage)
+    {
+      command::print_usage (c, cout);
+      return 0;
+    }
+
+    command::dispatch (c, s, handler ());
+
+    while (s.more ())
+      cout << s.next () << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
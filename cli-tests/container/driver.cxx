@@ -0,0 +1,88 @@
+// file      : container/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test hash-based, multi, and flat container options.
+//
+
+#include <string>
+
+#include "test.hxx"
+
+#undef NDEBUG
+#include <cassert>
+
+using namespace std;
+
+template <int N>
+static options
+parse (const char* (&av)[N])
+{
+  int ac (N);
+  return options (ac, const_cast<char**> (av));
+}
+
+int
+main ()
+{
+  // Parsing.
+  //
+  {
+    const char* a[] = {"",
+                       "-s", "b", "-s", "a", "-s", "b",
+                       "-m", "x=1", "-m", "y=2", "-m", "x=3",
+                       "-M", "k=1", "-M", "k=2", "-M", "j",
+                       "-f", "3", "-f", "1", "-f", "2", "-f", "1",
+                       "-l", "c,a,b,a", "-l", "d,a"};
+    options o (parse (a));
+
+    assert (o.s_specified () && o.s ().size () == 2 &&
+            o.s ().count ("a") == 1 && o.s ().count ("b") == 1);
+
+    assert (o.m_specified () && o.m ().size () == 2 &&
+            o.m ().find ("x")->second == 3 &&
+            o.m ().find ("y")->second == 2);
+
+    assert (o.M_specified () && o.M ().size () == 3 &&
+            o.M ().count ("k") == 2 && o.M ().count ("j") == 1);
+
+    {
+      multimap<string, string>::const_iterator i (o.M ().find ("k"));
+      assert (i->second == "1" && (++i)->second == "2");
+    }
+
+    const cli::flat_set<int>& f (o.f ());
+    assert (o.f_specified () && f.size () == 3);
+    assert (f.begin ()[0] == 1 && f.begin ()[1] == 2 && f.begin ()[2] == 3);
+    assert (f.count (2) == 1 && f.find (4) == f.end ());
+
+    const cli::flat_set<string>& l (o.l ());
+    assert (o.l_specified () && l.size () == 4);
+    assert (*l.begin () == "a" && *(l.end () - 1) == "d");
+    assert (l.count ("c") == 1 && l.count ("e") == 0);
+  }
+
+  // Merging.
+  //
+  {
+    const char* a1[] = {"", "-s", "a", "-m", "x=1", "-M", "k=1", "-f", "2"};
+    const char* a2[] = {"", "-s", "b", "-m", "x=2", "-M", "k=2", "-f", "1",
+                        "-f", "2"};
+    options o (parse (a1));
+    o.merge (parse (a2));
+
+    assert (o.s ().size () == 2);
+    assert (o.m ().size () == 1 && o.m ().find ("x")->second == 2);
+    assert (o.M ().count ("k") == 2);
+    assert (o.f ().size () == 2 && *o.f ().begin () == 1);
+  }
+
+  // Empty.
+  //
+  {
+    const char* a[] = {""};
+    options o (parse (a));
+
+    assert (o.s ().empty () && o.m ().empty () && o.M ().empty ());
+    assert (o.f ().empty () && o.f ().size () == 0);
+  }
+}
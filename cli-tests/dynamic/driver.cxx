@@ -0,0 +1,83 @@
+// file      : dynamic/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test dynamic options. Register a few options as a plugin would and parse
+// them together with the options class. If the first argument is 'dup',
+// then also try to register an option that clashes with the class. If it
+// is 'late', then register an option after the values are created.
+//
+#include <string>
+#include <cstring>
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    using cli::option;
+    using cli::option_names;
+    using cli::dynamic_kind;
+
+    cli::dynamic_options d;
+    d.reserve (options::description ());
+
+    option_names a;
+    a.push_back ("-p");
+    size_t name (d.add (option ("--plugin-name", a, false, "none"),
+                        dynamic_kind::string));
+
+    a.clear ();
+    size_t count (d.add (option ("--plugin-count", a, false, "3"),
+                         dynamic_kind::integer));
+    size_t ratio (d.add (option ("--plugin-ratio", a, false, ""),
+                         dynamic_kind::real));
+    size_t tag (d.add (option ("--plugin-tag", a, false, ""),
+                       dynamic_kind::strings));
+    size_t debug (d.add (option ("--plugin-debug", a, true, ""),
+                         dynamic_kind::flag));
+
+    int i (1);
+    if (argc > 1 && strcmp (argv[1], "dup") == 0)
+    {
+      i++;
+      d.add (option ("--level", a, false, ""), dynamic_kind::integer);
+    }
+
+    cli::dynamic_values v (d);
+
+    if (argc > 1 && strcmp (argv[1], "late") == 0)
+    {
+      i++;
+      d.add (option ("--plugin-late", a, true, ""), dynamic_kind::flag);
+    }
+
+    cli::argv_scanner s (i, argc, argv);
+    options c (s, v);
+
+    cout << "verbose: " << c.verbose () << endl
+         << "level: " << c.level () << endl
+         << "name: " << c.name () << endl
+         << "plugin-name: " << v.string (name)
+         << (v.specified (name) ? "" : " (default)") << endl
+         << "plugin-count: " << v.integer (count)
+         << (v.specified (count) ? "" : " (default)") << endl
+         << "plugin-ratio: " << v.real (ratio) << endl
+         << "plugin-debug: " << v.flag (debug) << endl;
+
+    for (size_t j (0); j != v.strings (tag).size (); ++j)
+      cout << "plugin-tag: " << v.strings (tag)[j] << endl;
+
+    while (s.more ())
+      cout << "argument: " << s.next () << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
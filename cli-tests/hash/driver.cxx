@@ -0,0 +1,42 @@
+// file      : hash/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test options comparison and hashing. The arguments before and after '+'
+// are parsed into two options instances which are then compared.
+//
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    vector<char*> a (1, argv[0]), b (1, argv[0]);
+
+    for (int i (1), s (0); i < argc; ++i)
+    {
+      if (strcmp (argv[i], "+") == 0)
+        s = 1;
+      else
+        (s == 0 ? a : b).push_back (argv[i]);
+    }
+
+    int ac (static_cast<int> (a.size ())), bc (static_cast<int> (b.size ()));
+    options x (ac, &a[0]), y (bc, &b[0]);
+
+    cout << (x == y ? "equal" : "different") << endl
+         << (x != y ? "different" : "equal") << endl
+         << (x.hash () == y.hash () ? "same hash" : "different hash") << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,26 @@
+// file      : include/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test options files that include other options files.
+//
+
+#include "test.hxx"
+
+#undef NDEBUG
+#include <cassert>
+
+using namespace std;
+
+int
+main ()
+{
+  const char* a[] = {
+    "", "--name", "x", "-f", "2", "-f", "1", "-f", "2", "-m", "3"};
+  int ac (11);
+  options o (ac, const_cast<char**> (a));
+
+  assert (o.name () == "x");
+  assert (o.f ().size () == 2 &&
+          *o.f ().begin () == 1 && *(o.f ().begin () + 1) == 2);
+  assert (o.m ().size () == 1 && o.m ().count (3) == 1);
+}
@@ -0,0 +1,43 @@
+// file      : instrumentation/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test parse instrumentation. Options from the test.ops file, if any, are
+// expanded with --options-file. Print the option and scanner counts
+// collected by the parse_statistics observer.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+print (const cli::parse_statistics::entries& es, const char* what)
+{
+  for (cli::parse_statistics::entries::const_iterator i (es.begin ());
+       i != es.end (); ++i)
+    cout << what << ' ' << i->first << ' ' << i->second.count << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    cli::parse_statistics st;
+    cli::parse_observer::current = &st;
+
+    cli::argv_file_scanner s (argc, argv, "--options-file");
+    options o (s);
+
+    cli::parse_observer::current = 0;
+
+    print (st.options (), "option");
+    print (st.scanners (), "scanner");
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,57 @@
+// file      : lazy/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test lazy default values.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+print (const options& o)
+{
+  cout << o.name () << endl;
+
+  for (size_t i (0); i != o.path ().size (); ++i)
+    cout << o.path ()[i] << endl;
+
+  for (size_t i (0); i != o.level ().size (); ++i)
+    cout << o.level ()[i] << endl;
+
+  cout << o.count () << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    int end;
+    options o (argc, argv, end);
+
+    // Print the parsed options, if any, or the merge and modification
+    // results otherwise.
+    //
+    if (argc > 1)
+      print (o);
+    else
+    {
+      options a;
+      a.name ("set");
+      a.name_specified (true);
+
+      options b;
+      b.path ().push_back ("/opt/include");
+      b.merge (a);
+
+      print (b);
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,48 @@
+// file      : map/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test map option value parsing.
+//
+#include <map>
+#include <string>
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+template <typename K, typename V>
+static void
+print (const char* n, const map<K, V>& m)
+{
+  cout << n << ":";
+  for (typename map<K, V>::const_iterator i (m.begin ()); i != m.end (); ++i)
+    cout << " '" << i->first << "'='" << i->second << "'";
+  cout << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    if (o.s_specified ())
+      print ("s", o.s ());
+
+    if (o.i_specified ())
+      print ("i", o.i ());
+
+    if (o.k_specified ())
+      print ("k", o.k ());
+
+    if (o.n_specified ())
+      print ("n", o.n ());
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,43 @@
+// file      : prefetch/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test argv_file_scanner with options file prefetching.
+//
+// Usage: driver <threads> <args>
+//
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+#include "test.hxx"
+
+#undef NDEBUG
+#include <cassert>
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  assert (argc > 1);
+
+  try
+  {
+    cli::argv_file_scanner s (2, argc, argv, "--file");
+    s.prefetch_threads (static_cast<size_t> (atoi (argv[1])));
+
+    while (s.more ())
+    {
+      const string& f (s.peek_file ());
+
+      if (!f.empty ())
+        cout << f << ':' << s.peek_line () << ": ";
+
+      cout << s.next () << endl;
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+  }
+}
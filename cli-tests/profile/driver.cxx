@@ -0,0 +1,40 @@
+// file      : profile/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test profile-guided option dispatch. The hot options must be parsed the
+// same as the rest.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    cout << "verbose: " << o.verbose () << endl
+         << "level: " << o.level () << endl
+         << "ratio: " << o.ratio () << endl
+         << "name: " << o.name () << endl;
+
+    for (size_t i (0); i != o.include ().size (); ++i)
+      cout << "include: " << o.include ()[i] << endl;
+
+    for (map<string, string>::const_iterator i (o.define ().begin ());
+         i != o.define ().end (); ++i)
+      cout << "define: " << i->first << '=' << i->second << endl;
+
+    for (size_t i (0); i != o.list ().size (); ++i)
+      cout << "list: " << o.list ()[i] << endl;
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
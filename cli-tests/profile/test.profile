@@ -0,0 +1,10 @@
+# Option frequency profile in the cli::parse_statistics format.
+#
+option -I 900 123456
+option --verbose 500 2345
+option --define 500 2345
+--level 40
+--name 400
+option --unknown 0 0
+--ratio 1
+scanner argv 1000 3456
@@ -0,0 +1,64 @@
+// file      : separator/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test the separator option attribute.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    if (o.i_specified ())
+    {
+      cout << "i:";
+      for (int i: o.i ())
+        cout << " " << i;
+      cout << endl;
+    }
+
+    if (o.s_specified ())
+    {
+      cout << "s:";
+      for (const string& s: o.s ())
+        cout << " '" << s << "'";
+      cout << endl;
+    }
+
+    if (o.t_specified ())
+    {
+      cout << "t:";
+      for (const string& t: o.t ())
+        cout << " '" << t << "'";
+      cout << endl;
+    }
+
+    if (o.m_specified ())
+    {
+      cout << "m:";
+      for (const auto& m: o.m ())
+        cout << " '" << m.first << "'=" << m.second;
+      cout << endl;
+    }
+
+    if (o.v_specified ())
+    {
+      cout << "v:";
+      for (const string& v: o.v ())
+        cout << " '" << v << "'";
+      cout << endl;
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
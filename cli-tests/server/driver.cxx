@@ -0,0 +1,210 @@
+// file      : server/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Stand-in build system client for the compiler server (--server). Start cli
+// in the server mode, send it the requests read from stdin one at a time,
+// and print the responses.
+//
+// usage: driver <cli> <socket>|-
+//
+// The requests are read in the --server format with each request sent
+// once its terminating empty line is read (so the arguments used in the
+// tests cannot contain newlines). Additionally, the line in the form:
+//
+// %copy <from> <to>
+//
+// Copies the file between the requests.
+//
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#undef NDEBUG
+#include <cassert>
+
+using namespace std;
+
+static void
+write_all (int fd, string const& s)
+{
+  for (size_t i (0); i != s.size (); )
+  {
+    ssize_t n (write (fd, s.data () + i, s.size () - i));
+    assert (n > 0);
+    i += static_cast<size_t> (n);
+  }
+}
+
+static char
+read_char (int fd)
+{
+  char c;
+  ssize_t n;
+  while ((n = read (fd, &c, 1)) < 0 && errno == EINTR) ;
+  assert (n == 1);
+  return c;
+}
+
+// Read the response and print it to stdout.
+//
+static void
+read_response (int fd)
+{
+  string h;
+  for (char c; (c = read_char (fd)) != '\n'; )
+    h += c;
+
+  int status;
+  size_t on, dn;
+  istringstream is (h);
+  is >> status >> on >> dn;
+  assert (is);
+
+  cout << h << '\n';
+
+  for (size_t i (0); i != on + dn; ++i)
+    cout << read_char (fd);
+}
+
+int
+main (int argc, char* argv[])
+{
+  assert (argc == 3);
+
+  const char* cli (argv[1]);
+  string socket (argv[2]);
+  bool pipes (socket == "-");
+
+  int in[2], out[2];
+
+  if (pipes)
+  {
+    assert (pipe (in) == 0);
+    assert (pipe (out) == 0);
+  }
+
+  pid_t pid (fork ());
+  assert (pid != -1);
+
+  if (pid == 0)
+  {
+    if (pipes)
+    {
+      dup2 (in[0], 0);
+      dup2 (out[1], 1);
+      close (in[0]); close (in[1]); close (out[0]); close (out[1]);
+    }
+
+    execl (cli, cli, "--server", socket.c_str (), static_cast<char*> (0));
+    _exit (127);
+  }
+
+  // The file descriptors for sending the requests and reading the
+  // responses.
+  //
+  int wfd, rfd;
+
+  if (pipes)
+  {
+    close (in[0]);
+    close (out[1]);
+    wfd = in[1];
+    rfd = out[0];
+  }
+  else
+  {
+    sockaddr_un a;
+    memset (&a, 0, sizeof (a));
+    a.sun_family = AF_UNIX;
+    strcpy (a.sun_path, socket.c_str ());
+
+    // Wait for the server to start listening.
+    //
+    for (size_t i (0);; ++i)
+    {
+      wfd = ::socket (AF_UNIX, SOCK_STREAM, 0);
+      assert (wfd != -1);
+
+      if (connect (wfd, reinterpret_cast<sockaddr*> (&a), sizeof (a)) == 0)
+        break;
+
+      close (wfd);
+
+      // If the server failed to start, then return its exit status.
+      //
+      int s;
+      pid_t r (waitpid (pid, &s, WNOHANG));
+      assert (r != -1);
+
+      if (r == pid)
+        return WIFEXITED (s) ? WEXITSTATUS (s) : 1;
+
+      assert (i != 1000);
+      usleep (10000);
+    }
+
+    rfd = wfd;
+  }
+
+  string rq;
+
+  for (string l; getline (cin, l); )
+  {
+    if (l.compare (0, 6, "%copy ") == 0)
+    {
+      istringstream is (l.substr (6));
+      string f, t;
+      is >> f >> t;
+
+      ifstream ifs (f);
+      ofstream ofs (t);
+      ofs << ifs.rdbuf ();
+      continue;
+    }
+
+    rq += l;
+    rq += '\n';
+
+    if (l.empty ())
+    {
+      write_all (wfd, rq);
+      read_response (rfd);
+      rq.clear ();
+    }
+  }
+
+  // Terminate the session and the server.
+  //
+  int s;
+
+  if (pipes)
+  {
+    close (wfd);
+    assert (waitpid (pid, &s, 0) == pid);
+    close (rfd);
+    return WIFEXITED (s) ? WEXITSTATUS (s) : 1;
+  }
+
+  // Also make sure the socket is only accessible by the owner and is
+  // removed on termination.
+  //
+  struct stat st;
+  assert (stat (socket.c_str (), &st) == 0 && (st.st_mode & 0077) == 0);
+
+  close (wfd);
+  kill (pid, SIGTERM);
+  assert (waitpid (pid, &s, 0) == pid);
+  assert (access (socket.c_str (), F_OK) != 0);
+  return 0;
+}
@@ -0,0 +1,119 @@
+// file      : snapshot/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test options snapshot saving and loading.
+//
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+print (const options& o)
+{
+  if (o.verbose ())
+    cout << "--verbose" << endl;
+
+  if (o.name_specified ())
+    cout << "--name " << o.name () << endl;
+
+  cout << "level " << o.level () << (o.level_specified () ? "" : " (default)")
+       << endl;
+
+  if (o.ratio_specified ())
+    cout << "--ratio " << o.ratio () << endl;
+
+  for (size_t i (0); i != o.include ().size (); ++i)
+    cout << "-I " << o.include ()[i] << endl;
+
+  for (map<string, int>::const_iterator i (o.define ().begin ());
+       i != o.define ().end ();
+       ++i)
+    cout << "-D " << i->first << '=' << i->second << endl;
+
+  for (set<int>::const_iterator i (o.id ().begin ()); i != o.id ().end (); ++i)
+    cout << "--id " << *i << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  try
+  {
+    options o (argc, argv);
+
+    cli::snapshot_buffer b;
+    o.save (b);
+
+    options r;
+    r.load (&b[0], b.size ());
+    print (r);
+
+    // Truncated snapshot.
+    //
+    try
+    {
+      options t;
+      t.load (&b[0], b.size () - 1);
+      cout << "truncated snapshot loaded" << endl;
+    }
+    catch (const cli::invalid_snapshot& e)
+    {
+      cout << e << endl;
+    }
+
+    // Snapshot of a different class.
+    //
+    try
+    {
+      other t;
+      t.load (&b[0], b.size ());
+      cout << "other snapshot loaded" << endl;
+    }
+    catch (const cli::invalid_snapshot& e)
+    {
+      cout << e << endl;
+    }
+
+    // Snapshot with a corrupt container size. Find the size byte as the
+    // one that differs between the snapshots of an empty and a single
+    // element container and replace it with a size that cannot be
+    // reserved.
+    //
+    try
+    {
+      int ac (3);
+      char* av[] = {argv[0], const_cast<char*> ("--tag"),
+                    const_cast<char*> ("1")};
+
+      tags x, y (ac, av);
+
+      cli::snapshot_buffer xb, yb;
+      x.save (xb);
+      y.save (yb);
+
+      size_t i (0);
+      while (xb[i] == yb[i])
+        ++i;
+
+      const char n[] = {
+        '\x80', '\x80', '\x80', '\x80', '\x80', '\x80', '\x7f'};
+
+      xb.erase (xb.begin () + i);
+      xb.insert (xb.begin () + i, n, n + sizeof (n));
+
+      x.load (&xb[0], xb.size ());
+      cout << "corrupt snapshot loaded" << endl;
+    }
+    catch (const cli::invalid_snapshot& e)
+    {
+      cout << e << endl;
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,60 @@
+// file      : string/driver.cxx
+// license   : MIT; see accompanying LICENSE file
+
+// Test string_scanner. The first argument is the command line string that
+// is scanned in place and, if the second argument is 'copy', a copy of it.
+//
+#include <string>
+#include <cstring>
+#include <iostream>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+print (cli::scanner& s)
+{
+  options o (s, cli::unknown_mode::fail, cli::unknown_mode::stop);
+
+  cout << "verbose: " << o.verbose () << endl
+       << "name: [" << o.name () << "]" << endl;
+
+  for (size_t i (0); i != o.include ().size (); ++i)
+    cout << "include: [" << o.include ()[i] << "]" << endl;
+
+  while (s.more ())
+  {
+    size_t p (s.position ());
+    cout << "argument " << p << ": [" << s.next () << "]" << endl;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    cerr << "usage: " << argv[0] << " <command-line> [copy]" << endl;
+    return 1;
+  }
+
+  try
+  {
+    if (argc > 2 && strcmp (argv[2], "copy") == 0)
+    {
+      cli::string_scanner s (string (argv[1]), 1);
+      print (s);
+    }
+    else
+    {
+      cli::string_scanner s (argv[1], 1);
+      print (s);
+    }
+  }
+  catch (const cli::exception& e)
+  {
+    cerr << e << endl;
+    return 1;
+  }
+}
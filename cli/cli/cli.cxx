@@ -2,20 +2,28 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <memory>   // unique_ptr
 #include <fstream>
-#include <utility>  // move()
+#include <sstream>
+#include <utility>  // move(), pair
 #include <iostream>
 
+#include <libcutl/compiler/type-info.hxx>
 #include <libcutl/compiler/code-stream.hxx>
 
-#include "semantics/doc.hxx"
+#include "semantics.hxx"
 
 #include "pregenerated/cli/options.hxx"
 #include "parser.hxx"
 #include "generator.hxx"
+#include "server.hxx"
+#include "unit-cache.hxx"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -32,12 +40,174 @@
 using namespace std;
 using namespace cutl;
 
-int
-main (int argc, char* argv[])
+// Compile the input file writing the output requested with --stdout and
+// diagnostics to the specified streams. Return false if compilation failed.
+//
+static bool
+compile (options ops, // Modified by the generator.
+         parser::paths const& include_paths,
+         unit_cache* cache,
+         const char* file,
+         ostream& o,
+         ostream& e)
 {
-  ostream& e (cerr);
-  const char* file (0);
+  try
+  {
+    // Open the input file.
+    //
+    semantics::path path (file);
+
+    ifstream ifs (path.string ().c_str ());
+    if (!ifs.is_open ())
+    {
+      e << path << ": error: unable to open in read mode" << endl;
+      return false;
+    }
+
+    ifs.exceptions (ifstream::failbit | ifstream::badbit);
+
+    // Only scan for the dependencies.
+    //
+    if (ops.generate_dep_only ())
+    {
+      parser p (include_paths, true, e);
+      parser::paths deps (p.parse_dependencies (ifs, path));
+
+      generator g;
+      g.generate_dep (ops, move (deps), path, e);
+      return true;
+    }
+
+    // Parse and generate.
+    //
+    parser p (include_paths, ops.generate_dep (), e, cache);
+    parser::parse_result r (p.parse (ifs, path));
+    unique_ptr<semantics::cli_unit>& unit (r.unit);
+
+    // Merge documentation variables from the command line.
+    //
+    for (map<string, string>::const_iterator i (ops.docvar ().begin ());
+         i != ops.docvar ().end ();
+         ++i)
+    {
+      using semantics::doc;
+
+      // Values specified in the .cli file override command line.
+      //
+      if (unit->lookup<doc> ("", "var: " + i->first) != 0)
+        continue;
+
+      doc& d (unit->new_node<doc> (semantics::path ("<command line>"), 0, 0));
+      unit->new_edge<semantics::names> (*unit, d, "var: " + i->first);
+      d.push_back (i->second);
+    }
+
+    generator g;
+    g.generate (ops, move (*unit), move (r.dependencies), path, o, e);
+  }
+  catch (semantics::invalid_path const& ex)
+  {
+    e << "error: '" << ex.path () << "' is not a valid filesystem path"
+      << endl;
+    return false;
+  }
+  catch (std::ios_base::failure const&)
+  {
+    e << file << ": error: read failure" << endl;
+    return false;
+  }
+  catch (parser::invalid_input const&)
+  {
+    // Diagnostics has already been issued by the parser.
+    //
+    return false;
+  }
+  catch (generator::failed const&)
+  {
+    // Diagnostics has already been issued by the generator.
+    //
+    return false;
+  }
+
+  return true;
+}
+
+// Unit caches that are kept between server requests, one per the parse
+// cache directory and include search paths combination.
+//
+class unit_caches
+{
+public:
+  unit_cache&
+  find (string const& dir, parser::paths const& include_paths)
+  {
+    lock_guard<mutex> l (mutex_);
+
+    unique_ptr<unit_cache>& c (map_[key (dir, include_paths)]);
+
+    if (c == nullptr)
+      c.reset (new unit_cache (semantics::path (dir), include_paths));
+
+    return *c;
+  }
+
+private:
+  typedef pair<string, parser::paths> key;
+  typedef map<key, unique_ptr<unit_cache>> map_type;
+
+  mutex mutex_;
+  map_type map_;
+};
+
+// Perform the invocation with the specified command line writing the
+// output and diagnostics to the specified streams and returning the exit
+// status. If caches is not NULL, then this is a server request.
+//
+static int
+invoke (int argc, char* argv[], ostream& o, ostream& e, unit_caches*);
+
+// Run the server (see --server) returning the exit status.
+//
+static int
+serve (string const& socket, ostream& e)
+{
+  unit_caches caches;
+
+  server s (
+    [&caches] (vector<string> const& args, ostream& o, ostream& e)
+    {
+      vector<string> as (1, "cli");
+      as.insert (as.end (), args.begin (), args.end ());
+
+      vector<char*> argv;
+      for (string& a: as)
+        argv.push_back (&a[0]);
+      argv.push_back (0);
+
+      int argc (static_cast<int> (as.size ()));
+      return invoke (argc, argv.data (), o, e, &caches);
+    });
+
+  try
+  {
+    if (socket == "-")
+      s.serve (cin, cout);
+    else
+      s.listen (socket, e);
+  }
+  catch (server::failed const&)
+  {
+    // Diagnostics has already been issued by the server.
+    //
+    return 1;
+  }
+
+  return 0;
+}
 
+static int
+invoke (int argc, char* argv[], ostream& o, ostream& e, unit_caches* caches)
+{
   try
   {
     cli::argv_file_scanner scan (argc, argv, "--options-file");
@@ -47,8 +217,6 @@ main (int argc, char* argv[])
     //
     if (ops.build2_metadata_specified ())
     {
-      ostream& o (cout);
-
       // Note that the export.metadata variable should be the first non-
       // blank/comment line.
       //
@@ -65,8 +233,6 @@ main (int argc, char* argv[])
     //
     if (ops.version ())
     {
-      ostream& o (cout);
-
       o << "CLI (command line interface compiler) " << CLI_VERSION_ID << endl
         << "Copyright (c) " << CLI_COPYRIGHT << "." << endl;
 
@@ -81,9 +247,7 @@ main (int argc, char* argv[])
     //
     if (ops.help ())
     {
-      ostream& o (cout);
-
-      o << "Usage: " << argv[0] << " [options] file" << endl
+      o << "Usage: " << argv[0] << " [options] file [file ...]" << endl
         << "Options:" << endl;
 
       options::print_usage (o);
@@ -91,6 +255,26 @@ main (int argc, char* argv[])
       return 0;
     }
 
+    // Handle --server.
+    //
+    if (ops.server_specified ())
+    {
+      if (caches != 0)
+      {
+        e << "error: --server cannot be specified in a server request"
+          << endl;
+        return 1;
+      }
+
+      if (scan.more ())
+      {
+        e << "error: input file specified with --server" << endl;
+        return 1;
+      }
+
+      return serve (ops.server (), e);
+    }
+
     if (!scan.more ())
     {
       e << "error: no input file specified" << endl
@@ -110,46 +294,125 @@ main (int argc, char* argv[])
       include_paths.push_back (semantics::path (*i));
     }
 
-    // Open the input file.
+    // Collect the input files.
     //
-    file = scan.next ();
-    semantics::path path (file);
+    vector<const char*> files;
+    while (scan.more ())
+      files.push_back (scan.next ());
 
-    ifstream ifs (path.string ().c_str ());
-    if (!ifs.is_open ())
+    size_t n (files.size ());
+
+    if (n > 1)
     {
-      e << path << ": error: unable to open in read mode" << endl;
-      return 1;
+      if (ops.stdout_ ())
+      {
+        e << "error: --stdout cannot be used with multiple input files"
+          << endl;
+        return 1;
+      }
+
+      if (ops.dep_file_specified ())
+      {
+        e << "error: --dep-file cannot be used with multiple input files"
+          << endl;
+        return 1;
+      }
     }
 
-    ifs.exceptions (ifstream::failbit | ifstream::badbit);
+    // Included units are shared between the input files as well as between
+    // the server requests through the in-memory cache even if --parse-cache
+    // is not specified.
+    //
+    unique_ptr<unit_cache> own;
+    unit_cache* cache (0);
 
-    // Parse and generate.
+    if (caches != 0)
+      cache = &caches->find (ops.parse_cache (), include_paths);
+    else if (ops.parse_cache_specified () || n > 1)
+    {
+      own.reset (new unit_cache (semantics::path (ops.parse_cache ()),
+                                 include_paths));
+      cache = own.get ();
+    }
+
+    if (n == 1)
+      return compile (ops, include_paths, cache, files[0], o, e) ? 0 : 1;
+
+    // Compile multiple input files, potentially in parallel. Diagnostics
+    // for each file is buffered and then printed in the input order
+    // followed by the name of the file it belongs to.
     //
-    parser p (include_paths, ops.generate_dep ());
-    parser::parse_result r (p.parse (ifs, path));
-    unique_ptr<semantics::cli_unit>& unit (r.unit);
+    struct result
+    {
+      result (): done (false), failed (false) {}
 
-    // Merge documentation variables from the command line.
+      bool done;
+      bool failed;
+      string diag;
+    };
+
+    vector<result> rs (n);
+
+    // The input files are compiled in parallel so generate the output files
+    // of each sequentially.
     //
-    for (map<string, string>::const_iterator i (ops.docvar ().begin ());
-         i != ops.docvar ().end ();
-         ++i)
+    options iops (ops);
+    iops.jobs (1);
+
+    mutex m; // Protects rs and printed.
+    size_t printed (0);
+    atomic<size_t> next (0);
+
+    auto work = [&] ()
     {
-      using semantics::doc;
+      for (size_t i; (i = next++) < n; )
+      {
+        ostringstream d;
+        bool r (compile (iops, include_paths, cache, files[i], o, d));
 
-      // Values specified in the .cli file override command line.
-      //
-      if (unit->lookup<doc> ("", "var: " + i->first) != 0)
-        continue;
+        lock_guard<mutex> l (m);
 
-      doc& d (unit->new_node<doc> (semantics::path ("<command line>"), 0, 0));
-      unit->new_edge<semantics::names> (*unit, d, "var: " + i->first);
-      d.push_back (i->second);
+        rs[i].done = true;
+        rs[i].failed = !r;
+        rs[i].diag = d.str ();
+
+        for (; printed != n && rs[printed].done; ++printed)
+        {
+          result const& pr (rs[printed]);
+
+          if (!pr.diag.empty ())
+            e << pr.diag
+              << files[printed] << ": info: while compiling this file"
+              << endl;
+        }
+      }
+    };
+
+    size_t jobs (ops.jobs () != 0
+                 ? ops.jobs ()
+                 : static_cast<size_t> (thread::hardware_concurrency ()));
+
+    if (jobs == 0)
+      jobs = 1;
+    else if (jobs > n)
+      jobs = n;
+
+    vector<thread> ts;
+    for (size_t i (1); i < jobs; ++i)
+      ts.push_back (thread (work));
+
+    work ();
+
+    for (thread& t: ts)
+      t.join ();
+
+    for (result const& r: rs)
+    {
+      if (r.failed)
+        return 1;
     }
 
-    generator g;
-    g.generate (ops, move (*unit), move (r.dependencies), path);
+    return 0;
   }
   catch (cli::exception const& ex)
   {
@@ -162,21 +425,40 @@ main (int argc, char* argv[])
       << endl;
     return 1;
   }
-  catch (std::ios_base::failure const&)
-  {
-    e << file << ": error: read failure" << endl;
-    return 1;
-  }
-  catch (parser::invalid_input const&)
-  {
-    // Diagnostics has already been issued by the parser.
-    //
-    return 1;
-  }
-  catch (generator::failed const&)
-  {
-    // Diagnostics has already been issued by the generator.
-    //
-    return 1;
-  }
+}
+
+// The semantic graph type information caches the base type lookups on the
+// first use. Resolve them upfront so that the graphs can be traversed
+// concurrently (see --jobs and --server).
+//
+static void
+resolve_bases (compiler::type_info const& ti)
+{
+  for (compiler::type_info::base_iterator i (ti.begin_base ());
+       i != ti.end_base (); ++i)
+    resolve_bases (i->type_info ());
+}
+
+int
+main (int argc, char* argv[])
+{
+  using namespace semantics;
+  using compiler::lookup;
+
+  resolve_bases (lookup (typeid (cli_unit)));
+  resolve_bases (lookup (typeid (cxx_unit)));
+  resolve_bases (lookup (typeid (cli_includes)));
+  resolve_bases (lookup (typeid (cxx_includes)));
+  resolve_bases (lookup (typeid (class_)));
+  resolve_bases (lookup (typeid (inherits)));
+  resolve_bases (lookup (typeid (names)));
+  resolve_bases (lookup (typeid (commands)));
+  resolve_bases (lookup (typeid (option)));
+  resolve_bases (lookup (typeid (belongs)));
+  resolve_bases (lookup (typeid (initialized)));
+  resolve_bases (lookup (typeid (expression)));
+  resolve_bases (lookup (typeid (doc)));
+  resolve_bases (lookup (typeid (type)));
+
+  return invoke (argc, argv, cout, cerr, 0);
 }
@@ -3,6 +3,7 @@
 // license   : MIT; see accompanying LICENSE file
 
 #include <stack>
+#include <cctype>   // isalnum()
 #include <vector>
 #include <cstring>  // strncmp()
 #include <fstream>
@@ -98,19 +99,23 @@ namespace
 
 context::
 context (ostream& os_,
+         ostream& diag_,
          output_type ot_,
          semantics::cli_unit& unit_,
          options_type const& ops)
     : data_ (new (shared) data),
       os (os_),
+      diag (diag_),
       unit (unit_),
       options (ops),
       ot (ot_),
       gen_modifier (options.generate_modifier ()),
       gen_specifier (options.generate_specifier () ||
-                     options.generate_merge ()),
+                     options.generate_merge () ||
+                     options.generate_argv ()),
       gen_parse (options.generate_parse ()),
       gen_merge (options.generate_merge ()),
+      gen_lazy (options.lazy_defaults ()),
       inl (data_->inl_),
       opt_prefix (options.option_prefix ()),
       opt_sep (options.option_separator ()),
@@ -168,7 +173,7 @@ context (ostream& os_,
     }
     catch (const regex_format& e)
     {
-      cerr << "error: invalid regex '" << *i << "': " << e.what () << endl;
+      diag << "error: invalid regex '" << *i << "': " << e.what () << endl;
       throw generation_failed ();
     }
   }
@@ -180,6 +185,7 @@ context::
 context (context& c)
     : data_ (c.data_),
       os (c.os),
+      diag (c.diag),
       unit (c.unit),
       options (c.options),
       ot (c.ot),
@@ -187,6 +193,7 @@ context (context& c)
       gen_specifier (c.gen_specifier),
       gen_parse (c.gen_parse),
       gen_merge (c.gen_merge),
+      gen_lazy (c.gen_lazy),
       gen_usage (c.gen_usage),
       inl (c.inl),
       opt_prefix (c.opt_prefix),
@@ -281,7 +288,7 @@ process_link_target (const string& tg)
   bool t (options.link_regex_trace ());
 
   if (t)
-    cerr << "link: '" << tg << "'" << endl;
+    diag << "link: '" << tg << "'" << endl;
 
   string r;
   bool found (false);
@@ -290,7 +297,7 @@ process_link_target (const string& tg)
        i != link_regex.end (); ++i)
   {
     if (t)
-      cerr << "try: '" << i->regex () << "' : ";
+      diag << "try: '" << i->regex () << "' : ";
 
     if (i->match (tg))
     {
@@ -298,11 +305,11 @@ process_link_target (const string& tg)
       found = true;
 
       if (t)
-        cerr << "'" << r << "' : ";
+        diag << "'" << r << "' : ";
     }
 
     if (t)
-      cerr << (found ? '+' : '-') << endl;
+      diag << (found ? '+' : '-') << endl;
 
     if (found)
       break;
@@ -745,7 +752,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
             if (!t.empty ())
             {
-              cerr << "error: nested links in documentation paragraph '"
+              diag << "error: nested links in documentation paragraph '"
                    << string (l, 0, n) << "'" << endl;
               throw generation_failed ();
             }
@@ -775,7 +782,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
             if (t.empty ())
             {
-              cerr << "error: missing link target in documentation paragraph '"
+              diag << "error: missing link target in documentation paragraph '"
                    << string (l, 0, n) << "'" << endl;
               throw generation_failed ();
             }
@@ -790,7 +797,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
               if (t[t.size () - 1] != ')' || link_section.empty ())
               {
-                cerr << "error: missing man section in '" << t << "'" << endl;
+                diag << "error: missing man section in '" << t << "'" << endl;
                 throw generation_failed ();
               }
 
@@ -798,7 +805,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
               if (n.empty ())
               {
-                cerr << "error: missing man page in '" << t << "'" << endl;
+                diag << "error: missing man page in '" << t << "'" << endl;
                 throw generation_failed ();
               }
 
@@ -878,7 +885,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
         }
       default:
         {
-          cerr << "error: unknown escape sequence '\\" << c << "' in "
+          diag << "error: unknown escape sequence '\\" << c << "' in "
                << "documentation paragraph '" << string (l, 0, n) << "'"
                << endl;
           throw generation_failed ();
@@ -940,7 +947,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
               if (pt.empty ())
               {
-                cerr << "error: link '" << t << "' became empty" << endl;
+                diag << "error: link '" << t << "' became empty" << endl;
                 throw generation_failed ();
               }
 
@@ -965,7 +972,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
           {
             if ((s & note) != 0)
             {
-              cerr << "error: \\N{} in man output not yet supported" << endl;
+              diag << "error: \\N{} in man output not yet supported" << endl;
               throw generation_failed ();
             }
 
@@ -1036,7 +1043,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
                   {
                     if (link_empty)
                     {
-                      cerr << "error: link target '" << t << "' became empty "
+                      diag << "error: link target '" << t << "' became empty "
                            << "and link text is also empty" << endl;
                       throw generation_failed ();
                     }
@@ -1135,7 +1142,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
                   {
                     if (link_empty)
                     {
-                      cerr << "error: link target '" << t << "' became empty "
+                      diag << "error: link target '" << t << "' became empty "
                            << "and link text is also empty" << endl;
                       throw generation_failed ();
                     }
@@ -1190,7 +1197,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
 
   if (escape)
   {
-    cerr << "error: unterminated escape sequence in documentation "
+    diag << "error: unterminated escape sequence in documentation "
          << "paragraph '" << string (l, 0, n) << "'" << endl;
     throw generation_failed ();
   }
@@ -1207,7 +1214,7 @@ format_line (output_type ot, string& r, const char* l, size_t n)
     if (b & note) bs  = 'N';
 
 
-    cerr << "error: unterminated formatting span '\\" << bs << "' "
+    diag << "error: unterminated formatting span '\\" << bs << "' "
          << "in documentation paragraph '" << string (l, 0, n) << "'" << endl;
     throw generation_failed ();
   }
@@ -1400,7 +1407,7 @@ format (semantics::scope& scope, string const& s, bool para)
           //
           if (!v.empty () || !last)
           {
-            cerr << "error: TOC variable should be in its own documentation "
+            diag << "error: TOC variable should be in its own documentation "
                  << "string" << endl;
             throw generation_failed ();
           }
@@ -1473,7 +1480,7 @@ format (semantics::scope& scope, string const& s, bool para)
       {
         if (l[2] != '0' && l[2] != '1' && l[2] != '2')
         {
-          cerr << "error: '0', '1', or '2' expected in \\hN| in '"
+          diag << "error: '0', '1', or '2' expected in \\hN| in '"
                << string (ol, 0, on) << "'" << endl;
           throw generation_failed ();
         }
@@ -1539,7 +1546,7 @@ format (semantics::scope& scope, string const& s, bool para)
 
         if (n == 0)
         {
-          cerr << "error: paragraph begin '|' expected after id in '"
+          diag << "error: paragraph begin '|' expected after id in '"
                << string (ol, 0, on) << "'" << endl;
           throw generation_failed ();
         }
@@ -1612,7 +1619,7 @@ format (semantics::scope& scope, string const& s, bool para)
 
       if (!good)
       {
-        cerr << "error: " << k << " inside " << ok << " "
+        diag << "error: " << k << " inside " << ok << " "
              << "in documentation string '" << s << "'" << endl;
         throw generation_failed ();
       }
@@ -1624,7 +1631,7 @@ format (semantics::scope& scope, string const& s, bool para)
     {
       if (!id_set.insert (id).second)
       {
-        cerr << "error: duplicate id '" << id << "' in documentation "
+        diag << "error: duplicate id '" << id << "' in documentation "
              << "string '" << s << "'" << endl;
         throw generation_failed ();
       }
@@ -1641,7 +1648,7 @@ format (semantics::scope& scope, string const& s, bool para)
         //
         if (!para)
         {
-          cerr << "error: paragraph '" << string (ol, 0, on) << "' "
+          diag << "error: paragraph '" << string (ol, 0, on) << "' "
                << "not allowed in '" << s << "'" << endl;
           throw generation_failed ();
         }
@@ -1650,7 +1657,7 @@ format (semantics::scope& scope, string const& s, bool para)
         //
         if (pop == 0)
         {
-          cerr << "error: '|' expected at the end of paragraph '"
+          diag << "error: '|' expected at the end of paragraph '"
                << string (ol, 0, on) << "'" << endl;
           throw generation_failed ();
         }
@@ -1659,7 +1666,7 @@ format (semantics::scope& scope, string const& s, bool para)
         //
         if (n == 0)
         {
-          cerr << "error: empty paragraph '" << string (ol, 0, on) << "' "
+          diag << "error: empty paragraph '" << string (ol, 0, on) << "' "
                << "in documentation string '" << s << "'" << endl;
           throw generation_failed ();
         }
@@ -1672,14 +1679,14 @@ format (semantics::scope& scope, string const& s, bool para)
       {
         if (pop != 0)
         {
-          cerr << "error: empty list '" << string (ol, 0, on) << "' "
+          diag << "error: empty list '" << string (ol, 0, on) << "' "
                << "in documentation string '" << s << "'" << endl;
           throw generation_failed ();
         }
 
         if (n != 0)
         {
-          cerr << "error: unexpected text after " << k << "| "
+          diag << "error: unexpected text after " << k << "| "
                << "in paragraph '" << string (ol, 0, on) << "'" << endl;
           throw generation_failed ();
         }
@@ -1692,7 +1699,7 @@ format (semantics::scope& scope, string const& s, bool para)
         {
           if (n == 0)
           {
-            cerr << "error: term text missing in paragraph '"
+            diag << "error: term text missing in paragraph '"
                  << string (ol, 0, on) << "'" << endl;
             throw generation_failed ();
           }
@@ -1934,7 +1941,7 @@ format (semantics::scope& scope, string const& s, bool para)
     //
     if (pop >= blocks.size ()) // >= to account for top-level.
     {
-      cerr << "error: extraneous '|' at the end of paragraph '"
+      diag << "error: extraneous '|' at the end of paragraph '"
            << string (ol, 0, on) << "'" << endl;
       throw generation_failed ();
     }
@@ -1966,7 +1973,7 @@ format (semantics::scope& scope, string const& s, bool para)
 
               if (pi.empty ())
               {
-                cerr << "error: TOC heading '" << pv << "' has no id" << endl;
+                diag << "error: TOC heading '" << pv << "' has no id" << endl;
                 throw generation_failed ();
               }
 
@@ -2334,7 +2341,7 @@ format (semantics::scope& scope, string const& s, bool para)
             }
           case block::note:
             {
-              cerr << "error: " << pb.kind << "| in man output not yet "
+              diag << "error: " << pb.kind << "| in man output not yet "
                    << "supported" << endl;
               throw generation_failed ();
             }
@@ -2352,7 +2359,7 @@ format (semantics::scope& scope, string const& s, bool para)
 
   if (blocks.size () > 1)
   {
-    cerr << "error: unterminated paragraph " << blocks.top ().kind << " "
+    diag << "error: unterminated paragraph " << blocks.top ().kind << " "
          << "in documentation string '" << s << "'" << endl;
     throw generation_failed ();
   }
@@ -2437,7 +2444,7 @@ verify_id_ref ()
     {
       if (id_set.find (*i) == id_set.end ())
       {
-        cerr << "error: no id for fragment link '#" << *i << "'" << endl;
+        diag << "error: no id for fragment link '#" << *i << "'" << endl;
         f = true;
       }
     }
@@ -2519,7 +2526,7 @@ substitute (const string& s, const path* d)
           ifstream ifs (p.string ().c_str (), ifstream::in | ifstream::binary);
           if (!ifs.is_open ())
           {
-            cerr << p << ": error: unable to open in read mode" << endl;
+            diag << p << ": error: unable to open in read mode" << endl;
             throw generation_failed ();
           }
 
@@ -2538,7 +2545,7 @@ substitute (const string& s, const path* d)
           {
             if (!r.empty () || p + 1 != n)
             {
-              cerr << "error: TOC variable should be on its own line" << endl;
+              diag << "error: TOC variable should be on its own line" << endl;
               throw generation_failed ();
             }
 
@@ -2560,7 +2567,7 @@ substitute (const string& s, const path* d)
             r += d->front ();
           else
           {
-            cerr << "error: undefined variable '" << v << "' in '" << s << "'"
+            diag << "error: undefined variable '" << v << "' in '" << s << "'"
                  << endl;
             throw generation_failed ();
           }
@@ -2610,7 +2617,7 @@ substitute (semantics::scope& scope, const char* s, size_t n, string& result)
 
         if (p == n)
         {
-          cerr << "error: missing closing '$' in '" << string (s, n) << "'"
+          diag << "error: missing closing '$' in '" << string (s, n) << "'"
                << endl;
           throw generation_failed ();
         }
@@ -2628,7 +2635,7 @@ substitute (semantics::scope& scope, const char* s, size_t n, string& result)
         {
           if (!result.empty () || p + 1 != n)
           {
-            cerr << "error: TOC variable should be its own paragraph" << endl;
+            diag << "error: TOC variable should be its own paragraph" << endl;
             throw generation_failed ();
           }
 
@@ -2650,7 +2657,7 @@ substitute (semantics::scope& scope, const char* s, size_t n, string& result)
           result += d->front ();
         else
         {
-          cerr << "error: undefined variable '" << v << "' in '"
+          diag << "error: undefined variable '" << v << "' in '"
                << string (s, n) << "'" << endl;
           throw generation_failed ();
         }
@@ -2767,11 +2774,39 @@ class_doc (semantics::class_& c)
     return cd_long;
   else
   {
-    cerr << "error: unknown --class-doc kind value '" << k << "'" << endl;
+    diag << "error: unknown --class-doc kind value '" << k << "'" << endl;
     throw generation_failed ();
   }
 }
 
+bool context::
+lazy (semantics::option& o)
+{
+  if (!gen_lazy || !o.initialized_p ())
+    return false;
+
+  // Fundamental types are cheap to initialize.
+  //
+  static const char* const fund[] = {
+    "bool", "char", "wchar_t", "short", "int", "long", "float", "double",
+    "signed", "unsigned", "size_t", "std::size_t"};
+
+  istringstream is (o.type ().name ());
+
+  for (string w; is >> w;)
+  {
+    bool f (false);
+
+    for (size_t i (0); !f && i != sizeof (fund) / sizeof (fund[0]); ++i)
+      f = (w == fund[i]);
+
+    if (!f)
+      return true;
+  }
+
+  return false;
+}
+
 string context::
 first_sentence (string const& s)
 {
@@ -2808,3 +2843,94 @@ post (type& ns)
   if (!ns.name ().empty ())
     os << "}";
 }
+
+// has_option_attribute, has_option_type
+//
+
+namespace
+{
+  struct option_test: traversal::option
+  {
+    option_test (bool (*f) (semantics::option&, string const&),
+                 string const& a,
+                 bool& r)
+        : f_ (f), a_ (a), r_ (r) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      if (!r_ && f_ (o, a_))
+        r_ = true;
+    }
+
+  private:
+    bool (*f_) (semantics::option&, string const&);
+    string const& a_;
+    bool& r_;
+  };
+
+  bool
+  test_options (semantics::cli_unit& u,
+                bool (*f) (semantics::option&, string const&),
+                string const& a)
+  {
+    bool r (false);
+
+    traversal::cli_unit unit;
+    traversal::names unit_names;
+    traversal::namespace_ ns;
+    traversal::class_ cl;
+
+    unit >> unit_names >> ns;
+    unit_names >> cl;
+
+    traversal::names ns_names;
+    ns >> ns_names >> ns;
+    ns_names >> cl;
+
+    traversal::names cl_names;
+    option_test o (f, a, r);
+    cl >> cl_names >> o;
+
+    unit.dispatch (u);
+    return r;
+  }
+
+  bool
+  option_attribute (semantics::option& o, string const& a)
+  {
+    return o.attribute_p (a);
+  }
+
+  bool
+  option_type (semantics::option& o, string const& n)
+  {
+    // Look for the name as a complete identifier (so that, for example,
+    // set does not match unordered_set).
+    //
+    string const& t (o.type ().name ());
+
+    for (size_t p (t.find (n)); p != string::npos; p = t.find (n, p + 1))
+    {
+      size_t e (p + n.size ());
+
+      if ((p == 0 || !(isalnum (t[p - 1]) || t[p - 1] == '_')) &&
+          (e == t.size () || !(isalnum (t[e]) || t[e] == '_')))
+        return true;
+    }
+
+    return false;
+  }
+}
+
+bool
+has_option_attribute (semantics::cli_unit& u, string const& a)
+{
+  return test_options (u, &option_attribute, a);
+}
+
+bool
+has_option_type (semantics::cli_unit& u, string const& n)
+{
+  return test_options (u, &option_type, n);
+}
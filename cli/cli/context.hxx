@@ -68,6 +68,7 @@ private:
 
 public:
   std::ostream& os;
+  std::ostream& diag; // Diagnostics stream.
   semantics::cli_unit& unit;
   options_type const& options;
 
@@ -86,6 +87,7 @@ public:
   bool       gen_specifier;
   bool       gen_parse;
   bool       gen_merge;
+  bool       gen_lazy;
   usage_type gen_usage;
 
   string const& inl;
@@ -213,27 +215,46 @@ public:
   static string const&
   ename (semantics::nameable& n)
   {
-    return n.context ().get<string> ("name");
+    return n.cxx_name ();
   }
 
   static string const&
-  especifier (semantics::nameable& n)
+  especifier (semantics::option& o)
   {
-    return n.context ().get<string> ("specifier");
+    return o.cxx_specifier ();
   }
 
   static string const&
-  emember (semantics::nameable& n)
+  emember (semantics::option& o)
   {
-    return n.context ().get<string> ("member");
+    return o.cxx_member ();
   }
 
   static string const&
-  especifier_member (semantics::nameable& n)
+  especifier_member (semantics::option& o)
   {
-    return n.context ().get<string> ("specifier-member");
+    return o.cxx_specifier_member ();
   }
 
+  static string const&
+  edefault (semantics::option& o)
+  {
+    return o.cxx_default ();
+  }
+
+  static string const&
+  ematerialized_member (semantics::option& o)
+  {
+    return o.cxx_materialized_member ();
+  }
+
+public:
+  // Return true if the option's member is initialized lazily (see
+  // --lazy-defaults).
+  //
+  bool
+  lazy (semantics::option&);
+
 public:
   // Return fully-qualified C++ or CLI name.
   //
@@ -261,6 +282,7 @@ public:
 
 public:
   context (std::ostream&,
+           std::ostream& diag,
            output_type,
            semantics::cli_unit&,
            options_type const&);
@@ -286,6 +308,18 @@ has (Y& y)
   return false;
 }
 
+// Checks if any option in the unit (but not in the units it includes) has
+// the specified attribute.
+//
+bool
+has_option_attribute (semantics::cli_unit&, std::string const&);
+
+// Checks if the type of any option in the unit (but not in the units it
+// includes) refers to the specified name, for example, unordered_map.
+//
+bool
+has_option_type (semantics::cli_unit&, std::string const&);
+
 // Standard namespace traverser.
 //
 struct namespace_: traversal::namespace_, context
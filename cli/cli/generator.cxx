@@ -2,11 +2,27 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#ifndef _WIN32
+#  include <unistd.h>  // getpid()
+#else
+#  include <process.h> // _getpid()
+#endif
+
 #include <cctype>   // toupper, is{alpha,upper,lower}
+#include <cstdio>   // rename(), remove()
+#include <map>
+#include <atomic>
+#include <memory>     // unique_ptr
 #include <string>
+#include <thread>
+#include <vector>
+#include <exception>  // exception_ptr
 #include <fstream>
-#include <utility>  // move()
+#include <sstream>
+#include <utility>    // move()
 #include <iostream>
+#include <iterator>   // istreambuf_iterator
+#include <functional> // greater, function
 
 #include <libcutl/fs/auto-remove.hxx>
 
@@ -68,13 +84,13 @@ namespace
   }
 
   void
-  open (ifstream& ifs, string const& path)
+  open (ifstream& ifs, string const& path, ostream& diag)
   {
     ifs.open (path.c_str (), ios_base::in | ios_base::binary);
 
     if (!ifs.is_open ())
     {
-      cerr << path << ": error: unable to open in read mode" << endl;
+      diag << path << ": error: unable to open in read mode" << endl;
       throw generator::failed ();
     }
   }
@@ -113,7 +129,7 @@ namespace
     if (!file.empty ())
     {
       ifstream ifs;
-      open (ifs, file);
+      open (ifs, file, ctx.diag);
 
       path p (file);
       path d (p.directory ());
@@ -129,6 +145,403 @@ namespace
         pdeps->push_back (move (p.normalize ()));
     }
   }
+
+  // Load the option frequency profile and store the hot option names, in
+  // the decreasing frequency order, in the unit's context. The profile
+  // contains '<option> <count>' lines, optionally preceded with the
+  // 'option' keyword and followed by other fields (the format printed by
+  // cli::parse_statistics). Blank lines, lines starting with '#', and the
+  // 'scanner' lines are ignored. Counts for the same option are summed.
+  //
+  void
+  load_profile (semantics::cli_unit& unit,
+                string const& file,
+                vector<path>* pdeps,
+                ostream& diag)
+  {
+    ifstream ifs;
+    open (ifs, file, diag);
+
+    typedef map<string, unsigned long long> counts;
+    counts cs;
+    unsigned long long total (0);
+
+    size_t ln (0);
+    for (string l; getline (ifs, l); )
+    {
+      ln++;
+
+      istringstream is (l);
+      string n;
+
+      if (!(is >> n) || n[0] == '#' || n == "scanner")
+        continue;
+
+      if (n == "option" && !(is >> n))
+        n.clear ();
+
+      unsigned long long c;
+      if (n.empty () || !(is >> c))
+      {
+        diag << file << ":" << ln << ": error: invalid option profile entry"
+             << endl;
+        throw generator::failed ();
+      }
+
+      cs[n] += c;
+      total += c;
+    }
+
+    // Order by the decreasing count and then by name (equal keys keep the
+    // insertion order) so that the result does not depend on the order of
+    // the profile entries.
+    //
+    typedef multimap<unsigned long long,
+                     string,
+                     greater<unsigned long long> > ordered;
+    ordered os;
+
+    for (counts::const_iterator i (cs.begin ()); i != cs.end (); ++i)
+    {
+      if (i->second != 0)
+        os.insert (ordered::value_type (i->second, i->first));
+    }
+
+    // Consider hot the most frequent options that together account for 95%
+    // of occurrences but no more than 16 of them.
+    //
+    vector<string> hot;
+    unsigned long long sum (0);
+
+    for (ordered::const_iterator i (os.begin ());
+         i != os.end () && hot.size () != 16 && sum * 100 < total * 95;
+         ++i)
+    {
+      hot.push_back (i->second);
+      sum += i->first;
+    }
+
+    unit.context ().set ("hot-options", hot);
+
+    if (pdeps != nullptr)
+      pdeps->push_back (move (path (file).normalize ()));
+  }
+
+  // Output generation job. The back-ends producing different files only
+  // read the semantic graph and each creates its own context so they can
+  // run concurrently. Each job has its own diagnostics, dependencies, and
+  // files to remove on failure which are merged in the job order.
+  //
+  struct job
+  {
+    typedef std::function<void (job&)> function;
+
+    job (bool dep, bool buf, function const& f)
+        : run (f), pdeps (dep ? &deps : nullptr), buffer (buf) {}
+
+    function run;
+
+    ostringstream diag;
+    vector<path> deps;   // Dependencies (prologue/epilogue files).
+    vector<path>* pdeps; // &deps if collecting dependencies, NULL otherwise.
+    vector<path> depts;  // Dependents (generated files).
+    fs::auto_removes rm; // Generated files to remove on failure.
+    exception_ptr error;
+
+    // The generated file. If buffer is true, then its content is generated
+    // into buf and written later (see write_if_changed()).
+    //
+    path file;
+    ofstream ofs;
+    bool buffer;
+    ostringstream buf;
+  };
+
+  struct jobs: vector<unique_ptr<job>>
+  {
+    explicit
+    jobs (bool buf): buffer (buf) {}
+
+    void
+    add (bool dep, job::function const& f)
+    {
+      push_back (unique_ptr<job> (new job (dep, buffer, f)));
+    }
+
+    bool buffer;
+  };
+
+  void
+  execute (job& j)
+  {
+    try
+    {
+      j.run (j);
+    }
+    catch (...)
+    {
+      j.error = current_exception ();
+    }
+
+    // Close the file before it is potentially removed.
+    //
+    if (j.ofs.is_open ())
+      j.ofs.close ();
+  }
+
+  // Run the jobs using up to the specified number of threads, 0 meaning the
+  // number of hardware threads. Then issue their diagnostics in the job
+  // order and rethrow the first failure. The result is the same as if the
+  // jobs were run sequentially, stopping at the first failure.
+  //
+  void
+  run_jobs (jobs& js, size_t n, ostream& diag)
+  {
+    if (n == 0)
+      n = thread::hardware_concurrency ();
+
+    if (n > js.size ())
+      n = js.size ();
+
+    if (n > 1)
+    {
+      atomic<size_t> next (0);
+
+      auto work = [&js, &next] ()
+      {
+        for (size_t i; (i = next++) < js.size (); )
+          execute (*js[i]);
+      };
+
+      vector<thread> ts;
+      for (size_t i (1); i < n; ++i)
+        ts.push_back (thread (work));
+
+      work ();
+
+      for (thread& t: ts)
+        t.join ();
+    }
+
+    for (unique_ptr<job> const& j: js)
+    {
+      if (n <= 1)
+        execute (*j);
+
+      diag << j->diag.str ();
+
+      if (j->error)
+        rethrow_exception (j->error);
+    }
+  }
+
+  // Open the job's output file registering it for removal on failure and,
+  // if requested, as a dependent. Return the stream to generate the file
+  // content into.
+  //
+  ostream&
+  open (path p, job& j, bool dep)
+  {
+    j.file = p;
+
+    if (!j.buffer)
+    {
+      j.ofs.open (p.string ().c_str ());
+
+      if (!j.ofs.is_open ())
+      {
+        j.diag << "error: unable to open '" << p << "' in write mode" << endl;
+        throw generator::failed ();
+      }
+
+      j.rm.add (p);
+    }
+
+    if (dep)
+      j.depts.push_back (move (p.normalize ()));
+
+    return j.buffer ? static_cast<ostream&> (j.buf) : j.ofs;
+  }
+
+  // Write the content to the file unless it already contains exactly that,
+  // in which case leave it (and its modification time) untouched. The new
+  // content is written into a temporary file which is then renamed over the
+  // existing file so that the file is never observed partially written.
+  //
+  void
+  write_if_changed (path const& p, string const& s, ostream& diag)
+  {
+    string const& f (p.string ());
+
+    {
+      ifstream ifs (f.c_str ());
+
+      if (ifs.is_open ())
+      {
+        string c ((istreambuf_iterator<char> (ifs)),
+                  istreambuf_iterator<char> ());
+
+        if (!ifs.bad () && c == s)
+          return;
+      }
+    }
+
+    // Make the temporary file name unique so that concurrent invocations
+    // (or jobs) writing the same file do not clobber each other's content.
+    //
+    string t;
+    {
+      ostringstream os;
+#ifndef _WIN32
+      os << f << '.' << getpid () << '.' << this_thread::get_id () << ".tmp";
+#else
+      os << f << '.' << _getpid () << '.' << this_thread::get_id () << ".tmp";
+#endif
+      t = os.str ();
+    }
+
+    {
+      ofstream ofs (t.c_str ());
+
+      if (!ofs.is_open ())
+      {
+        diag << "error: unable to open '" << t << "' in write mode" << endl;
+        throw generator::failed ();
+      }
+
+      ofs << s;
+      ofs.close ();
+
+      if (ofs.fail ())
+      {
+        diag << "error: unable to write to '" << t << "'" << endl;
+        remove (t.c_str ());
+        throw generator::failed ();
+      }
+    }
+
+#ifdef _WIN32
+    // On Windows rename() does not replace an existing file.
+    //
+    remove (f.c_str ());
+#endif
+
+    if (rename (t.c_str (), f.c_str ()) != 0)
+    {
+      diag << "error: unable to rename '" << t << "' to '" << f << "'"
+           << endl;
+      remove (t.c_str ());
+      throw generator::failed ();
+    }
+  }
+
+  // The kinds of output requested on the command line.
+  //
+  struct outputs
+  {
+    bool cxx;
+    bool man;
+    bool html;
+    bool txt;
+  };
+
+  outputs
+  requested_outputs (options const& ops, ostream& diag)
+  {
+    outputs r {ops.generate_cxx (),
+               ops.generate_man (),
+               ops.generate_html (),
+               ops.generate_txt ()};
+
+    if (!r.cxx && !r.man && !r.html && !r.txt)
+      r.cxx = true;
+
+    if (ops.stdout_ ())
+    {
+      if (r.cxx)
+      {
+        diag << "error: --stdout cannot be used with C++ output" << endl;
+        throw generator::failed ();
+      }
+
+      if ((r.man  && r.html) ||
+          (r.man  && r.txt)  ||
+          (r.html && r.txt))
+      {
+        diag << "error: --stdout cannot only be used with one output format"
+             << endl;
+        throw generator::failed ();
+      }
+    }
+
+    return r;
+  }
+
+  // Return the path of the generated file with the specified suffix.
+  //
+  path
+  output_path (options const& ops, string const& base, string const& suffix)
+  {
+    path r (ops.output_prefix () + base + ops.output_suffix () + suffix);
+
+    if (!ops.output_dir ().empty ())
+      r = path (ops.output_dir ()) / r;
+
+    return r;
+  }
+
+  path
+  dep_file_path (options const& ops, string const& base)
+  {
+    return ops.dep_file ().empty ()
+      ? output_path (ops, base, ops.dep_suffix ())
+      : path (ops.dep_file ());
+  }
+
+  // Write the make rule with the dependents as targets and the dependencies
+  // as prerequisites.
+  //
+  void
+  write_dep (ostream& os, vector<path> const& depts, vector<path> const& deps)
+  {
+    // Write the specified path to the dependencies file stream, escaping
+    // colons and backslashes.
+    //
+    auto write = [&os] (path const& p)
+    {
+      for (char c: p.string ())
+      {
+        if (c == ':' || c == '\\')
+          os << '\\';
+
+        os << c;
+      }
+    };
+
+    // Note that we don't add the dependency file as a dependent, but in the
+    // future may invent some option which triggers that.
+    //
+    bool first (true);
+    for (const auto& p: depts)
+    {
+      if (!first)
+        os << " \\" << endl;
+      else
+        first = false;
+
+      write (p);
+    }
+
+    os << ':';
+
+    for (const auto& p: deps)
+    {
+      os << " \\" << endl
+         << "  "; write (p);
+    }
+
+    os << endl;
+  }
 }
 
 generator::
@@ -140,11 +553,33 @@ void generator::
 generate (options& ops,
           semantics::cli_unit&& unit,
           vector<path>&& deps,
-          path const& p)
+          path const& p,
+          ostream& out,
+          ostream& diag)
 {
   if (ops.generate_group_scanner ())
     ops.generate_vector_scanner (true);
 
+  if (ops.generate_dynamic_options ())
+    ops.generate_description (true);
+
+  if (ops.generate_file_prefetch ())
+  {
+    if (ops.std () < cxx_version::cxx11)
+    {
+      diag << "error: --generate-file-prefetch requires --std c++11 or later"
+           << endl;
+      throw failed ();
+    }
+
+    ops.generate_file_scanner (true);
+  }
+
+  // The graph is complete at this point so index the names for the doc
+  // variable and class lookups done by the back-ends.
+  //
+  unit.build_index ();
+
   try
   {
     path file (p.leaf ());
@@ -153,36 +588,22 @@ generate (options& ops,
     const string& pfx (ops.output_prefix ());
     const string& sfx (ops.output_suffix ());
 
-    bool gen_cxx (ops.generate_cxx ());
-    bool gen_man (ops.generate_man ());
-    bool gen_html (ops.generate_html ());
-    bool gen_txt (ops.generate_txt ());
-
-    if (!gen_cxx && !gen_man && !gen_html && !gen_txt)
-      gen_cxx = true;
-
-    if (ops.stdout_ ())
-    {
-      if (gen_cxx)
-      {
-        cerr << "error: --stdout cannot be used with C++ output" << endl;
-        throw failed ();
-      }
+    outputs o (requested_outputs (ops, diag));
 
-      if ((gen_man  && gen_html) ||
-          (gen_man  && gen_txt)  ||
-          (gen_html && gen_txt))
-      {
-        cerr << "error: --stdout cannot only be used with one output format"
-             << endl;
-        throw failed ();
-      }
-    }
+    bool gen_cxx (o.cxx);
+    bool gen_man (o.man);
+    bool gen_html (o.html);
+    bool gen_txt (o.txt);
 
     bool gen_dep (ops.generate_dep ());
     vector<path>* pdeps (gen_dep ? &deps : nullptr);
     vector<path>  depts; // Dependents.
 
+    // If requested, generate the files in memory and only write those that
+    // have changed once all of them are successfully generated.
+    //
+    bool buf (ops.write_if_changed ());
+
     fs::auto_removes auto_rm;
 
     // gen_dep
@@ -193,34 +614,34 @@ generate (options& ops,
     // Note that we will write the dependency file content later, when all the
     // dependents and dependencies are determined.
     //
-    ofstream dep;
+    path dep_path;
+    ofstream dep_file;
+    ostringstream dep_buf;
+    ostream& dep (buf ? static_cast<ostream&> (dep_buf) : dep_file);
 
     if (gen_dep)
     {
-      path dep_path;
+      dep_path = dep_file_path (ops, base);
 
-      if (ops.dep_file ().empty ())
+      if (!buf)
       {
-        dep_path = path (pfx + base + sfx + ops.dep_suffix ());
-
-        if (!ops.output_dir ().empty ())
-          dep_path = path (ops.output_dir ()) / dep_path;
-      }
-      else
-        dep_path = path (ops.dep_file ());
+        dep_file.open (dep_path.string ().c_str (), ios_base::out);
 
-      dep.open (dep_path.string ().c_str (), ios_base::out);
-
-      if (!dep.is_open ())
-      {
-        cerr << "error: unable to open '" << dep_path << "' in write mode"
-             << endl;
-        throw failed ();
+        if (!dep_file.is_open ())
+        {
+          diag << "error: unable to open '" << dep_path << "' in write mode"
+               << endl;
+          throw failed ();
+        }
       }
 
       auto_rm.add (dep_path);
     }
 
+    // The output generation jobs, one per generated file (see run_jobs()).
+    //
+    jobs js (buf);
+
     // C++ output.
     //
     if (gen_cxx)
@@ -231,26 +652,22 @@ generate (options& ops,
       string ixx_name (pfx + base + sfx + ops.ixx_suffix ());
       string cxx_name (pfx + base + sfx + ops.cxx_suffix ());
 
-      path hxx_path (hxx_name);
-      path ixx_path (ixx_name);
-      path cxx_path (cxx_name);
-
-      if (!ops.output_dir ().empty ())
-      {
-        path dir (ops.output_dir ());
-
-        hxx_path = dir / hxx_path;
-        ixx_path = dir / ixx_path;
-        cxx_path = dir / cxx_path;
-      }
+      path hxx_path (output_path (ops, base, ops.hxx_suffix ()));
+      path ixx_path (output_path (ops, base, ops.ixx_suffix ()));
+      path cxx_path (output_path (ops, base, ops.cxx_suffix ()));
 
       // Process names.
       //
       {
-        context ctx (cerr, context::ot_plain, unit, ops);
+        context ctx (diag, diag, context::ot_plain, unit, ops);
         process_names (ctx);
       }
 
+      // Load the option profile.
+      //
+      if (!ops.option_profile ().empty ())
+        load_profile (unit, ops.option_profile (), pdeps, diag);
+
       // Check if we need to generate the runtime code. If we include
       // another options file, then we assume the runtime is generated
       // there. However, to reduce the number of standard headers we
@@ -273,66 +690,6 @@ generate (options& ops,
         }
       }
 
-      //
-      //
-      ofstream hxx (hxx_path.string ().c_str ());
-
-      if (!hxx.is_open ())
-      {
-        cerr << "error: unable to open '" << hxx_path << "' in write mode"
-             << endl;
-        throw failed ();
-      }
-
-      auto_rm.add (hxx_path);
-
-      if (gen_dep)
-        depts.push_back (move (hxx_path.normalize ()));
-
-      //
-      //
-      ofstream ixx;
-
-      if (inl)
-      {
-        ixx.open (ixx_path.string ().c_str (), ios_base::out);
-
-        if (!ixx.is_open ())
-        {
-          cerr << "error: unable to open '" << ixx_path << "' in write mode"
-               << endl;
-          throw failed ();
-        }
-
-        auto_rm.add (ixx_path);
-
-        if (gen_dep)
-          depts.push_back (move (ixx_path.normalize ()));
-      }
-
-      //
-      //
-      ofstream cxx (cxx_path.string ().c_str ());
-
-      if (!cxx.is_open ())
-      {
-        cerr << "error: unable to open '" << cxx_path << "' in write mode"
-             << endl;
-        throw failed ();
-      }
-
-      auto_rm.add (cxx_path);
-
-      if (gen_dep)
-        depts.push_back (move (cxx_path.normalize ()));
-
-      // Print headers.
-      //
-      hxx << cxx_header;
-      if (inl)
-        ixx << cxx_header;
-      cxx << cxx_header;
-
       typedef
         compiler::ostream_filter<compiler::cxx_indenter, char>
         cxx_filter;
@@ -351,328 +708,323 @@ generate (options& ops,
 
       // HXX
       //
-      {
-        context ctx (hxx, context::ot_plain, unit, ops);
+      js.add (
+        gen_dep,
+        [=, &ops, &unit] (job& j)
+        {
+          ostream& hxx (open (hxx_path, j, gen_dep));
 
-        string guard (make_guard (gp + hxx_name, ctx));
+          hxx << cxx_header;
 
-        hxx << "#ifndef " << guard << endl
-            << "#define " << guard << endl
-            << endl;
+          context ctx (hxx, j.diag, context::ot_plain, unit, ops);
 
-        // Copy prologue.
-        //
-        hxx << "// Begin prologue." << endl
-            << "//" << endl;
-        append (ctx, ops.hxx_prologue (), ops.hxx_prologue_file (), pdeps);
-        hxx << "//" << endl
-            << "// End prologue." << endl
-            << endl;
+          string guard (make_guard (gp + hxx_name, ctx));
 
-        {
-          // We don't want to indent prologues/epilogues.
+          hxx << "#ifndef " << guard << endl
+              << "#define " << guard << endl
+              << endl;
+
+          // Copy prologue.
           //
-          cxx_filter filt (ctx.os);
+          hxx << "// Begin prologue." << endl
+              << "//" << endl;
+          append (ctx, ops.hxx_prologue (), ops.hxx_prologue_file (), j.pdeps);
+          hxx << "//" << endl
+              << "// End prologue." << endl
+              << endl;
 
-          if (runtime)
-            generate_runtime_header (ctx);
+          {
+            // We don't want to indent prologues/epilogues.
+            //
+            cxx_filter filt (ctx.os);
 
-          generate_header (ctx);
-        }
+            if (!ops.suppress_cli ())
+              generate_runtime_header (ctx, runtime);
 
-        if (inl)
-        {
-          hxx << "#include " << (br ? '<' : '"') << ip << ixx_name <<
-            (br ? '>' : '"') << endl
-              << endl;
-        }
+            generate_header (ctx);
+          }
 
-        // Copy epilogue.
-        //
-        hxx << "// Begin epilogue." << endl
-            << "//" << endl;
-        append (ctx, ops.hxx_epilogue (), ops.hxx_epilogue_file (), pdeps);
-        hxx << "//" << endl
-            << "// End epilogue." << endl
-            << endl;
+          if (inl)
+          {
+            hxx << "#include " << (br ? '<' : '"') << ip << ixx_name <<
+              (br ? '>' : '"') << endl
+                << endl;
+          }
 
-        hxx << "#endif // " << guard << endl;
-      }
+          // Copy epilogue.
+          //
+          hxx << "// Begin epilogue." << endl
+              << "//" << endl;
+          append (ctx, ops.hxx_epilogue (), ops.hxx_epilogue_file (), j.pdeps);
+          hxx << "//" << endl
+              << "// End epilogue." << endl
+              << endl;
+
+          hxx << "#endif // " << guard << endl;
+        });
 
       // IXX
       //
       if (inl)
       {
-        context ctx (ixx, context::ot_plain, unit, ops);
-
-        // Copy prologue.
-        //
-        ixx << "// Begin prologue." << endl
-            << "//" << endl;
-        append (ctx, ops.ixx_prologue (), ops.ixx_prologue_file (), pdeps);
-        ixx << "//" << endl
-            << "// End prologue." << endl
-            << endl;
-
-        {
-          // We don't want to indent prologues/epilogues.
-          //
-          cxx_filter filt (ctx.os);
-
-          if (runtime)
-            generate_runtime_inline (ctx);
-
-          generate_inline (ctx);
-        }
-
-        // Copy epilogue.
-        //
-        ixx << "// Begin epilogue." << endl
-            << "//" << endl;
-        append (ctx, ops.ixx_epilogue (), ops.ixx_epilogue_file (), pdeps);
-        ixx << "//" << endl
-            << "// End epilogue." << endl;
+        js.add (
+          gen_dep,
+          [=, &ops, &unit] (job& j)
+          {
+            ostream& ixx (open (ixx_path, j, gen_dep));
+
+            ixx << cxx_header;
+
+            context ctx (ixx, j.diag, context::ot_plain, unit, ops);
+
+            // Copy prologue.
+            //
+            ixx << "// Begin prologue." << endl
+                << "//" << endl;
+            append (ctx,
+                    ops.ixx_prologue (),
+                    ops.ixx_prologue_file (),
+                    j.pdeps);
+            ixx << "//" << endl
+                << "// End prologue." << endl
+                << endl;
+
+            {
+              // We don't want to indent prologues/epilogues.
+              //
+              cxx_filter filt (ctx.os);
+
+              if (runtime)
+                generate_runtime_inline (ctx);
+
+              generate_inline (ctx);
+            }
+
+            // Copy epilogue.
+            //
+            ixx << "// Begin epilogue." << endl
+                << "//" << endl;
+            append (ctx,
+                    ops.ixx_epilogue (),
+                    ops.ixx_epilogue_file (),
+                    j.pdeps);
+            ixx << "//" << endl
+                << "// End epilogue." << endl;
+          });
       }
 
       // CXX
       //
-      {
-        context ctx (cxx, context::ot_plain, unit, ops);
+      js.add (
+        gen_dep,
+        [=, &ops, &unit] (job& j)
+        {
+          ostream& cxx (open (cxx_path, j, gen_dep));
 
-        // Copy prologue.
-        //
-        cxx << "// Begin prologue." << endl
-            << "//" << endl;
-        append (ctx, ops.cxx_prologue (), ops.cxx_prologue_file (), pdeps);
-        cxx << "//" << endl
-            << "// End prologue." << endl
-            << endl;
+          cxx << cxx_header;
 
-        cxx << "#include " << (br ? '<' : '"') << ip << hxx_name <<
-          (br ? '>' : '"') << endl
-            << endl;
+          context ctx (cxx, j.diag, context::ot_plain, unit, ops);
 
-        {
-          // We don't want to indent prologues/epilogues.
+          // Copy prologue.
           //
-          cxx_filter filt (ctx.os);
+          cxx << "// Begin prologue." << endl
+              << "//" << endl;
+          append (ctx, ops.cxx_prologue (), ops.cxx_prologue_file (), j.pdeps);
+          cxx << "//" << endl
+              << "// End prologue." << endl
+              << endl;
+
+          cxx << "#include " << (br ? '<' : '"') << ip << hxx_name <<
+            (br ? '>' : '"') << endl
+              << endl;
 
-          if (runtime && !inl)
-            generate_runtime_inline (ctx);
+          {
+            // We don't want to indent prologues/epilogues.
+            //
+            cxx_filter filt (ctx.os);
 
-          if (!ops.suppress_cli ())
-            generate_runtime_source (ctx, runtime);
+            if (runtime && !inl)
+              generate_runtime_inline (ctx);
 
-          if (!inl)
-            generate_inline (ctx);
+            if (!ops.suppress_cli ())
+              generate_runtime_source (ctx, runtime);
 
-          generate_source (ctx);
-        }
+            if (!inl)
+              generate_inline (ctx);
 
-        // Copy epilogue.
-        //
-        cxx << "// Begin epilogue." << endl
-            << "//" << endl;
-        append (ctx, ops.cxx_epilogue (), ops.cxx_epilogue_file (), pdeps);
-        cxx << "//" << endl
-            << "// End epilogue." << endl
-            << endl;
-      }
+            generate_source (ctx);
+          }
+
+          // Copy epilogue.
+          //
+          cxx << "// Begin epilogue." << endl
+              << "//" << endl;
+          append (ctx, ops.cxx_epilogue (), ops.cxx_epilogue_file (), j.pdeps);
+          cxx << "//" << endl
+              << "// End epilogue." << endl
+              << endl;
+        });
     }
 
     // man output
     //
     if (gen_man)
     {
-      ofstream man;
-
-      if (!ops.stdout_ ())
-      {
-        path man_path (pfx + base + sfx + ops.man_suffix ());
-
-        if (!ops.output_dir ().empty ())
-          man_path = path (ops.output_dir ()) / man_path;
-
-        man.open (man_path.string ().c_str ());
-
-        if (!man.is_open ())
+      js.add (
+        gen_dep,
+        [=, &ops, &unit, &out] (job& j)
         {
-          cerr << "error: unable to open '" << man_path << "' in write mode"
-               << endl;
-          throw failed ();
-        }
-
-        auto_rm.add (man_path);
+          ostream* os (&out);
 
-        if (gen_dep)
-          depts.push_back (move (man_path.normalize ()));
-      }
-
-      // The explicit cast helps VC++ 8.0 overcome its issues.
-      //
-      ostream& os (ops.stdout_ () ? cout : static_cast<ostream&> (man));
-      context ctx (os, context::ot_man, unit, ops);
+          if (!ops.stdout_ ())
+          {
+            os = &open (output_path (ops, base, ops.man_suffix ()),
+                        j,
+                        gen_dep);
+          }
 
-      for (bool first (true); first || ctx.toc; first = false)
-      {
-        append (ctx, ops.man_prologue (), ops.man_prologue_file (), pdeps);
-        generate_man (ctx);
-        append (ctx, ops.man_epilogue (), ops.man_epilogue_file (), pdeps);
+          context ctx (*os, j.diag, context::ot_man, unit, ops);
 
-        if (ctx.toc)
-        {
-          assert (first); // Second run should end in non-TOC mode.
-          ctx.toc++; // TOC phase after restart.
-        }
-      }
+          for (bool first (true); first || ctx.toc; first = false)
+          {
+            append (ctx,
+                    ops.man_prologue (),
+                    ops.man_prologue_file (),
+                    j.pdeps);
+            generate_man (ctx);
+            append (ctx,
+                    ops.man_epilogue (),
+                    ops.man_epilogue_file (),
+                    j.pdeps);
+
+            if (ctx.toc)
+            {
+              assert (first); // Second run should end in non-TOC mode.
+              ctx.toc++; // TOC phase after restart.
+            }
+          }
 
-      ctx.verify_id_ref ();
+          ctx.verify_id_ref ();
+        });
     }
 
     // HTML output
     //
     if (gen_html)
     {
-      ofstream html;
-
-      if (!ops.stdout_ ())
-      {
-        // May have to update link derivation in format_line() if changing
-        // this.
-        //
-        path html_path (pfx + base + sfx + ops.html_suffix ());
-
-        if (!ops.output_dir ().empty ())
-          html_path = path (ops.output_dir ()) / html_path;
-
-        html.open (html_path.string ().c_str ());
-
-        if (!html.is_open ())
+      js.add (
+        gen_dep,
+        [=, &ops, &unit, &out] (job& j)
         {
-          cerr << "error: unable to open '" << html_path << "' in write mode"
-               << endl;
-          throw failed ();
-        }
-
-        auto_rm.add (html_path);
-
-        if (gen_dep)
-          depts.push_back (move (html_path.normalize ()));
-      }
+          ostream* os (&out);
 
-      // The explicit cast helps VC++ 8.0 overcome its issues.
-      //
-      ostream& os (ops.stdout_ () ? cout : static_cast<ostream&> (html));
-      context ctx (os, context::ot_html, unit, ops);
+          if (!ops.stdout_ ())
+          {
+            // May have to update link derivation in format_line() if
+            // changing this.
+            //
+            os = &open (output_path (ops, base, ops.html_suffix ()),
+                        j,
+                        gen_dep);
+          }
 
-      for (bool first (true); first || ctx.toc; first = false)
-      {
-        append (ctx, ops.html_prologue (), ops.html_prologue_file (), pdeps);
-        generate_html (ctx);
-        append (ctx, ops.html_epilogue (), ops.html_epilogue_file (), pdeps);
+          context ctx (*os, j.diag, context::ot_html, unit, ops);
 
-        if (ctx.toc)
-        {
-          assert (first); // Second run should end in non-TOC mode.
-          ctx.toc++; // TOC phase after restart.
-        }
-      }
+          for (bool first (true); first || ctx.toc; first = false)
+          {
+            append (ctx,
+                    ops.html_prologue (),
+                    ops.html_prologue_file (),
+                    j.pdeps);
+            generate_html (ctx);
+            append (ctx,
+                    ops.html_epilogue (),
+                    ops.html_epilogue_file (),
+                    j.pdeps);
+
+            if (ctx.toc)
+            {
+              assert (first); // Second run should end in non-TOC mode.
+              ctx.toc++; // TOC phase after restart.
+            }
+          }
 
-      ctx.verify_id_ref ();
+          ctx.verify_id_ref ();
+        });
     }
 
     // txt output
     //
     if (gen_txt)
     {
-      ofstream txt;
-
-      if (!ops.stdout_ ())
-      {
-        path txt_path (pfx + base + sfx + ops.txt_suffix ());
-
-        if (!ops.output_dir ().empty ())
-          txt_path = path (ops.output_dir ()) / txt_path;
-
-        txt.open (txt_path.string ().c_str ());
-
-        if (!txt.is_open ())
+      js.add (
+        gen_dep,
+        [=, &ops, &unit, &out] (job& j)
         {
-          cerr << "error: unable to open '" << txt_path << "' in write mode"
-               << endl;
-          throw failed ();
-        }
+          ostream* os (&out);
 
-        auto_rm.add (txt_path);
+          if (!ops.stdout_ ())
+          {
+            os = &open (output_path (ops, base, ops.txt_suffix ()),
+                        j,
+                        gen_dep);
+          }
 
-        if (gen_dep)
-          depts.push_back (move (txt_path.normalize ()));
-      }
+          context ctx (*os, j.diag, context::ot_plain, unit, ops);
 
-      // The explicit cast helps VC++ 8.0 overcome its issues.
-      //
-      ostream& os (ops.stdout_ () ? cout : static_cast<ostream&> (txt));
-      context ctx (os, context::ot_plain, unit, ops);
+          for (bool first (true); first || ctx.toc; first = false)
+          {
+            append (ctx,
+                    ops.txt_prologue (),
+                    ops.txt_prologue_file (),
+                    j.pdeps);
+            generate_txt (ctx);
+            append (ctx,
+                    ops.txt_epilogue (),
+                    ops.txt_epilogue_file (),
+                    j.pdeps);
+
+            if (ctx.toc)
+            {
+              assert (first); // Second run should end in non-TOC mode.
+              ctx.toc++; // TOC phase after restart.
+            }
+          }
 
-      for (bool first (true); first || ctx.toc; first = false)
-      {
-        append (ctx, ops.txt_prologue (), ops.txt_prologue_file (), pdeps);
-        generate_txt (ctx);
-        append (ctx, ops.txt_epilogue (), ops.txt_epilogue_file (), pdeps);
+          ctx.verify_id_ref ();
+        });
+    }
 
-        if (ctx.toc)
-        {
-          assert (first); // Second run should end in non-TOC mode.
-          ctx.toc++; // TOC phase after restart.
-        }
-      }
+    run_jobs (js, ops.jobs (), diag);
 
-      ctx.verify_id_ref ();
+    // Collect the dependents and dependencies in the job order.
+    //
+    for (unique_ptr<job> const& j: js)
+    {
+      depts.insert (depts.end (), j->depts.begin (), j->depts.end ());
+      deps.insert (deps.end (), j->deps.begin (), j->deps.end ());
     }
 
     // gen_dep
     //
     if (gen_dep)
-    {
-      // Write the specified path to the dependencies file stream, escaping
-      // colons and backslashes.
-      //
-      auto write = [&dep] (path const& p)
-      {
-        for (char c: p.string ())
-        {
-          if (c == ':' || c == '\\')
-            dep << '\\';
-
-          dep << c;
-        }
-      };
+      write_dep (dep, depts, deps);
 
-      // Note that we don't add the dependency file as a dependent, but in the
-      // future may invent some option which triggers that.
-      //
-      bool first (true);
-      for (const auto& p: depts)
-      {
-        if (!first)
-          dep << " \\" << endl;
-        else
-          first = false;
-
-        write (p);
-      }
-
-      dep << ':';
-
-      for (const auto& p: deps)
+    if (buf)
+    {
+      for (unique_ptr<job> const& j: js)
       {
-        dep << " \\" << endl
-            << "  "; write (p);
+        if (!j->file.empty ())
+          write_if_changed (j->file, j->buf.str (), diag);
       }
 
-      dep << endl;
+      if (gen_dep)
+        write_if_changed (dep_path, dep_buf.str (), diag);
     }
 
+    for (unique_ptr<job> const& j: js)
+      j->rm.cancel ();
+
     auto_rm.cancel ();
   }
   catch (const generation_failed&)
@@ -683,7 +1035,7 @@ generate (options& ops,
   }
   catch (semantics::invalid_path const& e)
   {
-    cerr << "error: '" << e.path () << "' is not a valid filesystem path"
+    diag << "error: '" << e.path () << "' is not a valid filesystem path"
          << endl;
     throw failed ();
   }
@@ -694,3 +1046,107 @@ generate (options& ops,
     throw failed ();
   }
 }
+
+void generator::
+generate_dep (options& ops,
+              vector<path>&& deps,
+              path const& p,
+              ostream& diag)
+{
+  try
+  {
+    string base (p.leaf ().base ().string ());
+
+    outputs o (requested_outputs (ops, diag));
+
+    // Determine the dependents and the additional dependencies in the same
+    // order as generate() does but without reading any of the files.
+    //
+    vector<path> depts;
+
+    auto add = [&deps] (string const& f)
+    {
+      if (!f.empty ())
+        deps.push_back (move (path (f).normalize ()));
+    };
+
+    if (o.cxx)
+    {
+      bool inl (!ops.suppress_inline ());
+
+      add (ops.option_profile ());
+
+      depts.push_back (output_path (ops, base, ops.hxx_suffix ()));
+      add (ops.hxx_prologue_file ());
+      add (ops.hxx_epilogue_file ());
+
+      if (inl)
+      {
+        depts.push_back (output_path (ops, base, ops.ixx_suffix ()));
+        add (ops.ixx_prologue_file ());
+        add (ops.ixx_epilogue_file ());
+      }
+
+      depts.push_back (output_path (ops, base, ops.cxx_suffix ()));
+      add (ops.cxx_prologue_file ());
+      add (ops.cxx_epilogue_file ());
+    }
+
+    if (o.man)
+    {
+      if (!ops.stdout_ ())
+        depts.push_back (output_path (ops, base, ops.man_suffix ()));
+
+      add (ops.man_prologue_file ());
+      add (ops.man_epilogue_file ());
+    }
+
+    if (o.html)
+    {
+      if (!ops.stdout_ ())
+        depts.push_back (output_path (ops, base, ops.html_suffix ()));
+
+      add (ops.html_prologue_file ());
+      add (ops.html_epilogue_file ());
+    }
+
+    if (o.txt)
+    {
+      if (!ops.stdout_ ())
+        depts.push_back (output_path (ops, base, ops.txt_suffix ()));
+
+      add (ops.txt_prologue_file ());
+      add (ops.txt_epilogue_file ());
+    }
+
+    for (path& d: depts)
+      d.normalize ();
+
+    path dep_path (dep_file_path (ops, base));
+
+    ostringstream os;
+    write_dep (os, depts, deps);
+
+    if (ops.write_if_changed ())
+      write_if_changed (dep_path, os.str (), diag);
+    else
+    {
+      ofstream dep (dep_path.string ().c_str (), ios_base::out);
+
+      if (!dep.is_open ())
+      {
+        diag << "error: unable to open '" << dep_path << "' in write mode"
+             << endl;
+        throw failed ();
+      }
+
+      dep << os.str ();
+    }
+  }
+  catch (semantics::invalid_path const& e)
+  {
+    diag << "error: '" << e.path () << "' is not a valid filesystem path"
+         << endl;
+    throw failed ();
+  }
+}
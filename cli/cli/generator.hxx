@@ -6,6 +6,7 @@
 #define CLI_GENERATOR_HXX
 
 #include <vector>
+#include <ostream>
 
 #include "pregenerated/cli/options.hxx"
 #include "semantics/unit.hxx"
@@ -17,11 +18,25 @@ public:
 
   class failed {};
 
+  // Output requested with --stdout is written to the out stream and
+  // diagnostics to the diag stream.
+  //
   void
   generate (options&,
             semantics::cli_unit&&,
             std::vector<semantics::path>&& dependencies,
-            semantics::path const&);
+            semantics::path const&,
+            std::ostream& out,
+            std::ostream& diag);
+
+  // Only write the dependency file (see --generate-dep-only) for the
+  // dependencies determined by parser::parse_dependencies().
+  //
+  void
+  generate_dep (options&,
+                std::vector<semantics::path>&& dependencies,
+                semantics::path const&,
+                std::ostream& diag);
 
 private:
   generator (generator const&);
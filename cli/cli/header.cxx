@@ -65,6 +65,10 @@ namespace
 
       os << type << " " << member << ";";
 
+      if (lazy (o))
+        os << "bool " << ematerialized_member (o) << ";"
+           << "static const " << type << "& " << edefault (o) << " ();";
+
       if (gen_specifier && type != "bool")
         os << "bool " << especifier_member (o) << ";";
     }
@@ -182,6 +186,16 @@ namespace
            << um << " option = " << um << "::fail," << endl
            << um << " argument = " << um << "::stop);"
            << endl;
+
+        if (options.generate_dynamic_options ())
+          os << "// Parse the options of this class together with the dynamic" << endl
+             << "// options." << endl
+             << "//" << endl
+             << n << " (" << cli << "::scanner&," << endl
+             << cli << "::dynamic_values&," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
       }
 
 
@@ -198,6 +212,44 @@ namespace
            << "merge (const " << name << "&);"
            << endl;
 
+      if (options.generate_snapshot ())
+        os << "// Save the options into a binary snapshot and restore them from" << endl
+           << "// such a snapshot. Throw invalid_snapshot if the snapshot is" << endl
+           << "// truncated or was saved by a different options class." << endl
+           << "//" << endl
+           << "void" << endl
+           << "save (" << cli << "::snapshot_buffer&) const;"
+           << endl
+           << "void" << endl
+           << "load (const void*, std::size_t);"
+           << endl;
+
+      if (options.generate_hash ())
+        os << "// Compare and hash the option values and specifiers, including" << endl
+           << "// inherited, except for the transient options." << endl
+           << "//" << endl
+           << "bool" << endl
+           << "operator== (const " << name << "&) const;"
+           << endl
+           << "bool" << endl
+           << "operator!= (const " << name << "&) const;"
+           << endl
+           << "std::size_t" << endl
+           << "hash () const;"
+           << endl;
+
+      if (options.generate_argv ())
+        os << "// Serialize the specified options, including inherited, into" << endl
+           << "// the command line arguments or options file form." << endl
+           << "//" << endl
+           << "void" << endl
+           << "to_argv (" << cli << "::argv_buffer&," << endl
+           << "const char* program = \"\") const;"
+           << endl
+           << "void" << endl
+           << "to_options_file (std::string&) const;"
+           << endl;
+
       //
       //
       os << "// Option accessors" << (gen_modifier ? " and modifiers." : ".") << endl
@@ -263,6 +315,30 @@ namespace
          << "_parse (const char*, " << cli << "::scanner&);"
          << endl;
 
+      // _hash ()
+      //
+      if (options.generate_hash ())
+        os << "void" << endl
+           << "_hash (std::size_t&) const;"
+           << endl;
+
+      // _to_argv ()
+      //
+      if (options.generate_argv ())
+        os << "void" << endl
+           << "_to_argv (" << cli << "::argument_sink&) const;"
+           << endl;
+
+      // _save (), _load ()
+      //
+      if (options.generate_snapshot ())
+        os << "void" << endl
+           << "_save (" << cli << "::snapshot_buffer&) const;"
+           << endl
+           << "void" << endl
+           << "_load (const char*&, const char*);"
+           << endl;
+
       // _parse ()
       //
       if (!abst)
@@ -270,7 +346,10 @@ namespace
            << "bool" << endl
            << "_parse (" << cli << "::scanner&," << endl
            << um << " option," << endl
-           << um << " argument);"
+           << um << " argument" <<
+          (options.generate_dynamic_options ()
+           ? ",\n" + cli + "::dynamic_values* = 0"
+           : "") << ");"
            << endl;
 
       // Data members.
@@ -290,6 +369,120 @@ namespace
     traversal::names names_option_data_;
   };
 
+  //
+  //
+  struct commands: traversal::commands, context
+  {
+    commands (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      typedef std::vector<string> strings;
+
+      string name (escape (c.name ()));
+      string um (cli + "::unknown_mode");
+      strings const& es (c.cxx_enumerators ());
+
+      os << "class " << exp << name
+         << "{"
+         << "public:" << endl
+         << "enum value"
+         << "{";
+
+      for (strings::const_iterator i (es.begin ()); i != es.end ();)
+      {
+        os << *i;
+        os << (++i != es.end () ? "," : "") << endl;
+      }
+
+      os << "};";
+
+      os << "// Find the command by any of its names. Return false if there" << endl
+         << "// is no such command." << endl
+         << "//" << endl
+         << "static bool" << endl
+         << "find (const char* name, value&);"
+         << endl;
+
+      os << "// Return the primary name of the command." << endl
+         << "//" << endl
+         << "static const char*" << endl
+         << "name (value);"
+         << endl;
+
+      os << "// Construct the options class instance of the command, parse it" << endl
+         << "// from the scanner, and call f with it. Only the selected" << endl
+         << "// command's options class is instantiated." << endl
+         << "//" << endl
+         << "template <typename F>" << endl
+         << "static F" << endl
+         << "dispatch (value," << endl
+         << cli << "::scanner&," << endl
+         << "F f," << endl
+         << um << " option = " << um << "::fail," << endl
+         << um << " argument = " << um << "::stop);"
+         << endl;
+
+      if (gen_usage != ut_none)
+      {
+        string up (cli + "::usage_para");
+        string const& ost (options.ostream_type ());
+
+        os << "// Print the command's usage information." << endl
+           << "//" << endl
+           << "static " << up << endl
+           << "print_usage (value," << endl
+           << ost << "&," << endl
+           << up << " = " << up << "::none);"
+           << endl;
+      }
+
+      os << "};";
+
+      // dispatch()
+      //
+      // This has to be in the header since it is a template.
+      //
+      os << "template <typename F>" << endl
+         << "inline F " << name << "::" << endl
+         << "dispatch (value c," << endl
+         << cli << "::scanner& s," << endl
+         << "F f," << endl
+         << um << " option," << endl
+         << um << " argument)"
+         << "{"
+         << "switch (c)"
+         << "{";
+
+      strings::const_iterator e (es.begin ());
+      for (semantics::commands::command_list::const_iterator i (
+             c.list ().begin ()); i != c.list ().end (); ++i, ++e)
+      {
+        semantics::class_& oc (*i->options);
+        string t (fq_name (oc));
+
+        os << "case " << *e << ":"
+           << "{";
+
+        if (gen_parse)
+          os << t << " o;"
+             << "o." << (escape (oc.name ()) != "parse" ? "parse" : "parse_") <<
+            " (s, option, argument);";
+        else
+          os << t << " o (s, option, argument);";
+
+        os << "f (o);"
+           << "break;"
+           << "}";
+      }
+
+      os << "}"
+         << "return f;"
+         << "}";
+    }
+  };
+
   //
   //
   struct includes_: traversal::cxx_includes,
@@ -342,15 +535,18 @@ generate_header (context& ctx)
   traversal::names unit_names;
   namespace_ ns (ctx);
   class_ cl (ctx);
+  commands cmds (ctx);
 
   unit >> includes;
   unit >> unit_names >> ns;
   unit_names >> cl;
+  unit_names >> cmds;
 
   traversal::names ns_names;
 
   ns >> ns_names >> ns;
   ns_names >> cl;
+  ns_names >> cmds;
 
   unit.dispatch (ctx.unit);
 
@@ -344,7 +344,7 @@ generate_html (context& ctx)
         cl.traverse (*c);
       else
       {
-        cerr << "error: class '" << *i << "' not found" << endl;
+        ctx.diag << "error: class '" << *i << "' not found" << endl;
         throw generation_failed ();
       }
     }
@@ -19,25 +19,54 @@ namespace
       string type (o.type ().name ());
       string scope (escape (o.scope ().name ()));
 
+      string member (emember (o));
+      bool l (lazy (o));
+
       os << inl << "const " << type << "& " << scope << "::" << endl
          << name << " () const"
-         << "{"
-         << "return this->" << emember (o) << ";"
-         << "}";
+         << "{";
+
+      // Until the lazy member is materialized, return the default value
+      // constant.
+      //
+      if (l)
+        os << "return this->" << ematerialized_member (o) << endl
+           << "? this->" << member << endl
+           << ": " << edefault (o) << " ();";
+      else
+        os << "return this->" << member << ";";
+
+      os << "}";
 
       if (gen_modifier)
       {
         os << inl << type << "& " << scope << "::" << endl
            << name << " ()"
-           << "{"
-           << "return this->" << emember (o) << ";"
+           << "{";
+
+        if (l)
+        {
+          string m (ematerialized_member (o));
+
+          os << "if (!this->" << m << ")"
+             << "{"
+             << "this->" << member << " = " << edefault (o) << " ();"
+             << "this->" << m << " = true;"
+             << "}";
+        }
+
+        os << "return this->" << member << ";"
            << "}";
 
         os << inl << "void " << scope << "::" << endl
            << name << " (const " << type << "& x)"
            << "{"
-           << "this->" << emember (o) << " = x;"
-           << "}";
+           << "this->" << member << " = x;";
+
+        if (l)
+          os << "this->" << ematerialized_member (o) << " = true;";
+
+        os << "}";
       }
 
       if (gen_specifier && type != "bool")
@@ -80,6 +109,13 @@ namespace
          << endl;
 
       names (c, names_option_);
+
+      if (options.generate_hash ())
+        os << inl << "bool " << name << "::" << endl
+           << "operator!= (const " << name << "& x) const"
+           << "{"
+           << "return !(*this == x);"
+           << "}";
     }
 
   private:
@@ -8,99 +8,152 @@
 
 using namespace std;
 
+// Character classes in the "C" locale, indexed with unsigned char.
+//
+#define A (cc_alpha | cc_ident)
+#define H (cc_alpha | cc_xdigit | cc_ident)
+#define O (cc_digit | cc_odigit | cc_xdigit | cc_ident)
+#define D (cc_digit | cc_xdigit | cc_ident)
+#define S (cc_space)
+#define I (cc_ident)
+
+unsigned char const lexer::char_class_[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, S, S, S, S, S, 0, 0, // 0x00  \t \n \v \f \r
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+  S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, I, 0, 0, // 0x20  ' ' -
+  O, O, O, O, O, O, O, O, D, D, 0, 0, 0, 0, 0, 0, // 0x30  0-9
+  0, H, H, H, H, H, H, A, A, A, A, A, A, A, A, A, // 0x40  A-O
+  A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, I, // 0x50  P-Z _
+  0, H, H, H, H, H, H, A, A, A, A, A, A, A, A, A, // 0x60  a-o
+  A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0  // 0x70  p-z
+                                                  // 0x80-0xFF
+};
+
+#undef A
+#undef H
+#undef O
+#undef D
+#undef S
+#undef I
+
 lexer::
-lexer (istream& is, string const& id)
-    : loc_ ("C"),
-      is_ (is),
-      id_ (id),
+lexer (istream& is, string const& id, ostream& diag)
+    : id_ (id),
+      diag_ (diag),
       l_ (1),
-      c_(1),
-      eos_ (false),
+      c_ (1),
       include_ (false),
-      valid_ (true),
-      buf_ (0, 0, 0),
-      unget_ (false)
+      valid_ (true)
 {
-  keyword_map_["source"]    = token::k_source;
-  keyword_map_["include"]   = token::k_include;
-  keyword_map_["namespace"] = token::k_namespace;
-  keyword_map_["class"]     = token::k_class;
-  keyword_map_["signed"]    = token::k_signed;
-  keyword_map_["unsigned"]  = token::k_unsigned;
-  keyword_map_["bool"]      = token::k_bool;
-  keyword_map_["char"]      = token::k_char;
-  keyword_map_["wchar_t"]   = token::k_wchar;
-  keyword_map_["short"]     = token::k_short;
-  keyword_map_["int"]       = token::k_int;
-  keyword_map_["long"]      = token::k_long;
-  keyword_map_["float"]     = token::k_float;
-  keyword_map_["double"]    = token::k_double;
-}
+  // Reaching eos while reading the stream sets the failbit which may
+  // trigger an exception so we suspend them while reading. Afterwards we
+  // leave the stream in the same state as reading it to eos one character
+  // at a time would (that is, only with the eofbit set unless the read
+  // failed).
+  //
+  ios_base::iostate x (is.exceptions ());
+  is.exceptions (ios_base::goodbit);
 
-lexer::xchar lexer::
-peek ()
-{
-  if (unget_)
-    return buf_;
-  else
-  {
-    if (eos_)
-      return xchar (xchar::traits_type::eof (), l_, c_);
-    else
-    {
-      xchar::int_type i (is_.peek ());
+  char buf[8192];
+  while (is.read (buf, sizeof (buf)) || is.gcount () != 0)
+    data_.append (buf, static_cast<size_t> (is.gcount ()));
 
-      if (i == xchar::traits_type::eof ())
-        eos_ = true;
+  is.clear (is.bad () ? ios_base::badbit : ios_base::eofbit);
+  is.exceptions (x); // Throws if the read failed and badbit is enabled.
 
-      return xchar (i, l_, c_);
-    }
-  }
+  p_ = data_.c_str ();
+  e_ = p_ + data_.size ();
 }
 
-lexer::xchar lexer::
-get ()
+lexer::
+lexer (char const* b, size_t n, string const& id, ostream& diag)
+    : p_ (b),
+      e_ (b + n),
+      id_ (id),
+      diag_ (diag),
+      l_ (1),
+      c_ (1),
+      include_ (false),
+      valid_ (true)
 {
-  if (unget_)
-  {
-    unget_ = false;
-    return buf_;
-  }
-  else
-  {
-    // When is_.get () returns eof, the failbit is also set (stupid,
-    // isn't?) which may trigger an exception. To work around this
-    // we will call peek() first and only call get() if it is not
-    // eof. But we can only call peek() on eof once; any subsequent
-    // calls will spoil the failbit (even more stupid).
-    //
-    xchar c (peek ());
+}
 
-    if (!is_eos (c))
+token::keyword_type lexer::
+keyword (string const& s)
+{
+  // Dispatch on the length and then on the first character so that at
+  // most two string comparisons are made.
+  //
+  switch (s.size ())
+  {
+  case 3:
     {
-      is_.get ();
+      if (s == "int")
+        return token::k_int;
 
-      if (c == '\n')
+      break;
+    }
+  case 4:
+    {
+      switch (s[0])
       {
-        l_++;
-        c_ = 1;
+      case 'b': if (s == "bool") return token::k_bool; break;
+      case 'c': if (s == "char") return token::k_char; break;
+      case 'l': if (s == "long") return token::k_long; break;
       }
-      else
-        c_++;
+      break;
+    }
+  case 5:
+    {
+      switch (s[0])
+      {
+      case 'c': if (s == "class") return token::k_class; break;
+      case 's': if (s == "short") return token::k_short; break;
+      case 'f': if (s == "float") return token::k_float; break;
+      }
+      break;
     }
+  case 6:
+    {
+      switch (s[0])
+      {
+      case 's':
+        {
+          if (s == "source") return token::k_source;
+          if (s == "signed") return token::k_signed;
+          break;
+        }
+      case 'd': if (s == "double") return token::k_double; break;
+      }
+      break;
+    }
+  case 7:
+    {
+      switch (s[0])
+      {
+      case 'i': if (s == "include") return token::k_include; break;
+      case 'w': if (s == "wchar_t") return token::k_wchar; break;
+      }
+      break;
+    }
+  case 8:
+    {
+      if (s == "unsigned")
+        return token::k_unsigned;
+
+      break;
+    }
+  case 9:
+    {
+      if (s == "namespace")
+        return token::k_namespace;
 
-    return c;
+      break;
+    }
   }
-}
 
-void lexer::
-unget (xchar c)
-{
-  // Because iostream::unget cannot work once eos is reached,
-  // we have to provide our own implementation.
-  //
-  buf_ = c;
-  unget_ = true;
+  return token::k_invalid;
 }
 
 token lexer::
@@ -166,6 +219,14 @@ next ()
         {
           return token (token::p_rcbrace, c.line (), c.column ());
         }
+      case '[':
+        {
+          return token (token::p_lsbrace, c.line (), c.column ());
+        }
+      case ']':
+        {
+          return token (token::p_rsbrace, c.line (), c.column ());
+        }
       case '(':
         {
           return call_expression (c);
@@ -197,8 +258,8 @@ next ()
 
             // Stray '-'.
             //
-            cerr << id_ << ':' << c.line () << ':' << c.column ()
-                 << ": error: unexpected character '-'" << endl;
+            diag_ << id_ << ':' << c.line () << ':' << c.column ()
+                  << ": error: unexpected character '-'" << endl;
             throw invalid_input ();
           }
 
@@ -216,8 +277,8 @@ next ()
         return int_literal (c);
       }
 
-      cerr << id_ << ':' << c.line () << ':' << c.column ()
-           << ": error: unexpected character '" << c << "'" << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column ()
+            << ": error: unexpected character '" << c << "'" << endl;
       throw invalid_input ();
     }
     catch (invalid_input const&)
@@ -269,9 +330,9 @@ skip_spaces ()
         {
           if (is_eos (c))
           {
-            cerr << id_ << ':' << c.line () << ':' << c.column ()
-                 << ": error: end of stream reached while reading "
-                 << "C-style comment" << endl;
+            diag_ << id_ << ':' << c.line () << ':' << c.column ()
+                  << ": error: end of stream reached while reading "
+                  << "C-style comment" << endl;
             throw invalid_input ();
           }
 
@@ -305,18 +366,21 @@ token lexer::
 identifier (xchar c)
 {
   size_t ln (c.line ()), cl (c.column ());
-  string lexeme;
-  lexeme += c;
 
-  bool check (c == '-' || c == '/');
+  // The first character has just been got so the identifier starts right
+  // before the current position. Since identifiers cannot span lines, we
+  // only need to advance the column.
+  //
+  char const* b (p_ - 1);
+  char const* e (p_);
 
-  for (c = peek ();
-       !is_eos (c) && (is_alnum (c) || c == '_' || c == '-');
-       c = peek ())
-  {
-    get ();
-    lexeme += c;
-  }
+  for (; e != e_ && is_ident (*e); ++e) ;
+
+  c_ += e - p_;
+  p_ = e;
+
+  string lexeme (b, e);
+  bool check (c == '-' || c == '/');
 
   // Check for invalid identifiers.
   //
@@ -330,20 +394,20 @@ identifier (xchar c)
 
     if (i == lexeme.size ())
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "invalid character sequence '" << lexeme << "'" << endl;
+      diag_ << id_ << ':' << l_ << ':' << c_ << ": error: "
+            << "invalid character sequence '" << lexeme << "'" << endl;
       throw invalid_input ();
     }
   }
 
-  keyword_map::const_iterator i (keyword_map_.find (lexeme));
+  token::keyword_type k (keyword (lexeme));
 
-  if (i != keyword_map_.end ())
+  if (k != token::k_invalid)
   {
-    if (i->second == token::k_include || i->second == token::k_source)
+    if (k == token::k_include || k == token::k_source)
       include_ = true;
 
-    return token (i->second, ln, cl);
+    return token (k, ln, cl);
   }
 
   if (lexeme == "true" || lexeme == "false")
@@ -376,8 +440,7 @@ token lexer::
 char_literal (xchar c)
 {
   size_t ln (c.line ()), cl (c.column ());
-  string lexeme;
-  lexeme += c;
+  char const* b (p_ - 1); // The opening character has just been got.
 
   char p (c);
 
@@ -387,13 +450,11 @@ char_literal (xchar c)
 
     if (is_eos (c))
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "end of stream reached while reading character literal" << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column () << ": error: "
+            << "end of stream reached while reading character literal" << endl;
       throw invalid_input ();
     }
 
-    lexeme += c;
-
     if (c == '\'' && p != '\\')
       break;
 
@@ -406,6 +467,7 @@ char_literal (xchar c)
       p = c;
   }
 
+  string lexeme (b, p_);
   return token (token::t_char_lit, lexeme, ln, cl);
 }
 
@@ -439,7 +501,7 @@ string_literal (xchar c)
 string lexer::
 string_literal_trailer ()
 {
-  string r;
+  char const* b (p_);
   char p ('\0');
 
   while (true)
@@ -448,13 +510,11 @@ string_literal_trailer ()
 
     if (is_eos (c))
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "end of stream reached while reading string literal" << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column () << ": error: "
+            << "end of stream reached while reading string literal" << endl;
       throw invalid_input ();
     }
 
-    r += c;
-
     if (c == '"' && p != '\\')
       break;
 
@@ -467,15 +527,14 @@ string_literal_trailer ()
       p = c;
   }
 
-  return r;
+  return string (b, p_);
 }
 
 token lexer::
 path_literal (xchar c)
 {
   size_t ln (c.line ()), cl (c.column ());
-  string lexeme;
-  lexeme += c;
+  char const* b (p_ - 1); // The opening character has just been got.
 
   char end (c == '<' ? '>' : '"');
 
@@ -485,17 +544,16 @@ path_literal (xchar c)
 
     if (is_eos (c))
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "end of stream reached while reading path literal" << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column () << ": error: "
+            << "end of stream reached while reading path literal" << endl;
       throw invalid_input ();
     }
 
-    lexeme += c;
-
     if (c == end)
       break;
   }
 
+  string lexeme (b, p_);
   token::token_type tt;
 
   if (lexeme.compare (1, 4, "c++:") == 0)
@@ -528,8 +586,7 @@ token lexer::
 call_expression (xchar c)
 {
   size_t ln (c.line ()), cl (c.column ());
-  string lexeme;
-  lexeme += c;
+  char const* b (p_ - 1); // The opening character has just been got.
   size_t balance (1);
 
   while (balance != 0)
@@ -538,13 +595,11 @@ call_expression (xchar c)
 
     if (is_eos (c))
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "end of stream reached while reading call expression" << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column () << ": error: "
+            << "end of stream reached while reading call expression" << endl;
       throw invalid_input ();
     }
 
-    lexeme += c;
-
     switch (c)
     {
     case '(':
@@ -560,6 +615,7 @@ call_expression (xchar c)
     }
   }
 
+  string lexeme (b, p_);
   return token (token::t_call_expr, lexeme, ln, cl);
 }
 
@@ -567,8 +623,7 @@ token lexer::
 template_expression (xchar c)
 {
   size_t ln (c.line ()), cl (c.column ());
-  string lexeme;
-  lexeme += c;
+  char const* b (p_ - 1); // The opening character has just been got.
   size_t balance (1);
 
   while (balance != 0)
@@ -577,14 +632,12 @@ template_expression (xchar c)
 
     if (is_eos (c))
     {
-      cerr << id_ << ':' << c.line () << ':' << c.column () << ": error: "
-           << "end of stream reached while reading template expression"
-           << endl;
+      diag_ << id_ << ':' << c.line () << ':' << c.column () << ": error: "
+            << "end of stream reached while reading template expression"
+            << endl;
       throw invalid_input ();
     }
 
-    lexeme += c;
-
     switch (c)
     {
     case '<':
@@ -600,5 +653,6 @@ template_expression (xchar c)
     }
   }
 
+  string lexeme (b, p_);
   return token (token::t_template_expr, lexeme, ln, cl);
 }
@@ -5,18 +5,28 @@
 #ifndef CLI_LEXER_HXX
 #define CLI_LEXER_HXX
 
-#include <map>
 #include <string>
-#include <locale>
 #include <cstddef> // std::size_t
 #include <istream>
+#include <ostream>
 
 #include "token.hxx"
 
+// The lexer reads the whole stream into a buffer on construction and then
+// scans it directly. Diagnostics is written to the diag stream.
+//
 class lexer
 {
 public:
-  lexer (std::istream& is, std::string const& id);
+  lexer (std::istream& is, std::string const& id, std::ostream& diag);
+
+  // Scan the specified buffer which should remain valid while the lexer
+  // is in use.
+  //
+  lexer (char const* b,
+         std::size_t n,
+         std::string const& id,
+         std::ostream& diag);
 
   token
   next ();
@@ -109,6 +119,11 @@ protected:
   bool
   is_alnum (char c) const;
 
+  // Alphanumeric, '_', or '-' (that is, can appear inside an identifier).
+  //
+  bool
+  is_ident (char c) const;
+
   bool
   is_space (char c) const;
 
@@ -118,23 +133,41 @@ protected:
   char
   to_upper (char c) const;
 
+  // Return k_invalid if the identifier is not a keyword.
+  //
+  static token::keyword_type
+  keyword (std::string const&);
+
 private:
-  typedef std::map<std::string, token::keyword_type> keyword_map;
+  // Character classes in the "C" locale.
+  //
+  enum
+  {
+    cc_alpha  = 0x01,
+    cc_digit  = 0x02,
+    cc_odigit = 0x04,
+    cc_xdigit = 0x08,
+    cc_space  = 0x10,
+    cc_ident  = 0x20
+  };
+
+  static unsigned char const char_class_[256];
+
+  bool
+  is_class (char c, unsigned char cc) const;
+
+private:
+  std::string data_; // Stream contents if constructed from a stream.
+  char const* p_;    // Next character.
+  char const* e_;    // End of buffer.
 
-  std::locale loc_;
-  std::istream& is_;
   std::string id_;
+  std::ostream& diag_;
   std::size_t l_;
   std::size_t c_;
 
-  keyword_map keyword_map_;
-
-  bool eos_;
   bool include_; // Literal in include or source.
   bool valid_;
-
-  xchar buf_;
-  bool unget_;
 };
 
 #include "lexer.ixx"
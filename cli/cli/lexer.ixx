@@ -42,40 +42,89 @@ valid () const
   return valid_;
 }
 
+inline lexer::xchar lexer::
+peek ()
+{
+  return p_ != e_
+    ? xchar (xchar::traits_type::to_int_type (*p_), l_, c_)
+    : xchar (xchar::traits_type::eof (), l_, c_);
+}
+
+inline lexer::xchar lexer::
+get ()
+{
+  xchar c (peek ());
+
+  if (p_ != e_)
+  {
+    if (*p_++ == '\n')
+    {
+      l_++;
+      c_ = 1;
+    }
+    else
+      c_++;
+  }
+
+  return c;
+}
+
+inline void lexer::
+unget (xchar c)
+{
+  // We can only unget the character that we have just got.
+  //
+  p_--;
+  l_ = c.line ();
+  c_ = c.column ();
+}
+
+inline bool lexer::
+is_class (char c, unsigned char cc) const
+{
+  return (char_class_[static_cast<unsigned char> (c)] & cc) != 0;
+}
+
 inline bool lexer::
 is_alpha (char c) const
 {
-  return std::isalpha (c, loc_);
+  return is_class (c, cc_alpha);
 }
 
 inline bool lexer::
 is_oct_digit (char c) const
 {
-  return std::isdigit (c, loc_) && c != '8' && c != '9';
+  return is_class (c, cc_odigit);
 }
 
 inline bool lexer::
 is_dec_digit (char c) const
 {
-  return std::isdigit (c, loc_);
+  return is_class (c, cc_digit);
 }
 
 inline bool lexer::
 is_hex_digit (char c) const
 {
-  return std::isxdigit (c, loc_);
+  return is_class (c, cc_xdigit);
 }
 
 inline bool lexer::
 is_alnum (char c) const
 {
-  return std::isalnum (c, loc_);
+  return is_class (c, cc_alpha | cc_digit);
+}
+
+inline bool lexer::
+is_ident (char c) const
+{
+  return is_class (c, cc_ident);
 }
 
 inline bool lexer::
 is_space (char c) const
 {
-  return std::isspace (c, loc_);
+  return is_class (c, cc_space);
 }
 
 inline bool lexer::
@@ -87,5 +136,5 @@ is_eos (xchar const& c) const
 inline char lexer::
 to_upper (char c) const
 {
-  return std::toupper (c, loc_);
+  return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
 }
@@ -2,7 +2,12 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#include <chrono>
+#include <string>
+#include <cstdlib>  // strtoul()
+#include <cstring>  // strcmp()
 #include <fstream>
+#include <sstream>
 #include <iostream>
 
 #include "token.hxx"
@@ -32,14 +37,73 @@ const char* keywords[] =
 };
 
 const char* punctuation[] = {
-  ";", ",", ":", "::", "{", "}", /*"(", ")",*/ "=", "|"};
+  ";", ",", ":", "::", "{", "}", "[", "]", /*"(", ")",*/ "=", "|"};
+
+// Lex the file the specified number of times and print the throughput in
+// the '<benchmark> <value> <unit>' form.
+//
+static int
+bench (const char* file, unsigned long n)
+{
+  ifstream ifs;
+  ifs.exceptions (ifstream::failbit | ifstream::badbit);
+  ifs.open (file);
+
+  ostringstream os;
+  os << ifs.rdbuf ();
+  string data (os.str ());
+
+  typedef chrono::steady_clock clock_type;
+
+  size_t tokens (0);
+  clock_type::time_point s (clock_type::now ());
+
+  for (unsigned long i (0); i != n; ++i)
+  {
+    istringstream is (data);
+    lexer l (is, file, cerr);
+
+    for (token t (l.next ()); t.type () != token::t_eos; t = l.next ())
+      ++tokens;
+
+    assert (l.valid ());
+  }
+
+  clock_type::time_point e (clock_type::now ());
+
+  double ns (static_cast<double> (
+               chrono::duration_cast<chrono::nanoseconds> (e - s).count ()));
+  double bytes (static_cast<double> (data.size ()) * n);
+
+  cout << "lex-tokens " << tokens / n << " tokens" << endl
+       << "lex-throughput " << (ns != 0 ? bytes * 1000 / ns : 0) << " MB/s"
+       << endl;
+
+  return 0;
+}
 
 int
 main (int argc, char* argv[])
 {
+  // lexer.test --bench <iterations> file.cli
+  //
+  if (argc == 4 && strcmp (argv[1], "--bench") == 0)
+  {
+    char* e (0);
+    unsigned long n (strtoul (argv[2], &e, 10));
+
+    if (n == 0 || *e != '\0' || argv[2][0] == '-')
+    {
+      cerr << "error: invalid iteration count '" << argv[2] << "'" << endl;
+      return 1;
+    }
+
+    return bench (argv[3], n);
+  }
+
   if (argc != 2)
   {
-    cerr << "usage: " << argv[0] << " file.cli" << endl;
+    cerr << "usage: " << argv[0] << " [--bench <iterations>] file.cli" << endl;
     return 1;
   }
 
@@ -47,7 +111,7 @@ main (int argc, char* argv[])
   ifs.exceptions (ifstream::failbit | ifstream::badbit);
   ifs.open (argv[1]);
 
-  lexer l (ifs, argv[1]);
+  lexer l (ifs, argv[1], cerr);
 
   while (true)
   {
@@ -278,7 +278,7 @@ generate_man (context& ctx)
         cl.traverse (*c);
       else
       {
-        cerr << "error: class '" << *i << "' not found" << endl;
+        ctx.diag << "error: class '" << *i << "' not found" << endl;
         throw generation_failed ();
       }
     }
@@ -3,6 +3,7 @@
 // license   : MIT; see accompanying LICENSE file
 
 #include <set>
+#include <vector>
 #include <sstream>
 
 #include "context.hxx"
@@ -67,7 +68,7 @@ namespace
         }
       }
 
-      o.context ().set ("name", find_name (name, set_));
+      o.cxx_name (find_name (name, set_));
     }
 
   private:
@@ -85,11 +86,7 @@ namespace
     traverse (type& o)
     {
       if (gen_specifier && o.type ().name () != "bool")
-      {
-        semantics::context& oc (o.context ());
-        string const& base (oc.get<string> ("name"));
-        oc.set ("specifier", find_name (base + "_specified", set_));
-      }
+        o.cxx_specifier (find_name (o.cxx_name () + "_specified", set_));
     }
 
   private:
@@ -106,15 +103,17 @@ namespace
     virtual void
     traverse (type& o)
     {
-      semantics::context& oc (o.context ());
-      string const& base (oc.get<string> ("name"));
-      oc.set ("member", find_name (base + "_", set_));
+      string const& base (o.cxx_name ());
+      o.cxx_member (find_name (base + "_", set_));
 
-      if (gen_specifier && o.type ().name () != "bool")
+      if (lazy (o))
       {
-        string const& base (oc.get<string> ("specifier"));
-        oc.set ("specifier-member", find_name (base + "_", set_));
+        o.cxx_default (find_name (base + "_default_", set_));
+        o.cxx_materialized_member (find_name (base + "_materialized_", set_));
       }
+
+      if (gen_specifier && o.type ().name () != "bool")
+        o.cxx_specifier_member (find_name (o.cxx_specifier () + "_", set_));
     }
 
   private:
@@ -128,10 +127,7 @@ namespace
     virtual void
     traverse (type& c)
     {
-      semantics::context& cc (c.context ());
-
-      cc.set ("member-name-set", name_set ());
-      name_set& member_set (cc.get<name_set> ("member-name-set"));
+      name_set& member_set (c.cxx_member_names ());
 
       member_set.insert (escape (c.name ()));
 
@@ -164,6 +160,48 @@ namespace
     }
   };
 
+  struct commands: traversal::commands, context
+  {
+    commands (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      // Command enumerators share the scope with the command group class
+      // name and its member functions.
+      //
+      name_set set;
+      set.insert (escape (c.name ()));
+      set.insert ("value");
+      set.insert ("find");
+      set.insert ("name");
+      set.insert ("dispatch");
+      set.insert ("print_usage");
+
+      semantics::commands::strings& es (c.cxx_enumerators ());
+
+      for (semantics::commands::command_list::const_iterator i (
+             c.list ().begin ()); i != c.list ().end (); ++i)
+      {
+        string const& n (i->names.front ());
+        string name;
+
+        // Get rid of leading special characters, as for options.
+        //
+        for (size_t j (0); j < n.size (); ++j)
+        {
+          if (isalpha (n[j]) || n[j] == '_')
+          {
+            name.assign (n.c_str (), j, n.size () - j);
+            break;
+          }
+        }
+
+        es.push_back (find_name (name, set));
+      }
+    }
+  };
+
   void
   process_names_ (context_base& c)
   {
@@ -173,14 +211,17 @@ namespace
     traversal::names unit_names;
     traversal::namespace_ ns;
     class_ cl (ctx);
+    commands cmds (ctx);
 
     unit >> unit_names >> ns;
     unit_names >> cl;
+    unit_names >> cmds;
 
     traversal::names ns_names;
 
     ns >> ns_names >> ns;
     ns_names >> cl;
+    ns_names >> cmds;
 
     unit.dispatch (ctx.unit);
   }
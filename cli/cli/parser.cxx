@@ -15,9 +15,13 @@
 #  endif
 #endif
 
+#include <map>
+#include <set>
 #include <fstream>
 #include <sstream>
-#include <utility>  // move()
+#include <vector>
+#include <utility>  // move(), pair
+#include <cassert>
 #include <iostream>
 
 #include "token.hxx"
@@ -63,7 +67,7 @@ const char* keywords[] =
 };
 
 const char* punctuation[] = {
-  ";", ",", ":", "::", "{", "}", /*"(", ")",*/ "=", "|"};
+  ";", ",", ":", "::", "{", "}", "[", "]", /*"(", ")",*/ "=", "|"};
 
 // Output the token type and value in a format suitable for diagnostics.
 //
@@ -202,7 +206,7 @@ parse (std::istream& is, path const& p)
 
   root_ = cur_ = unit.get ();
 
-  lexer l (is, p.string ());
+  lexer l (is, p.string (), diag_);
   lexer_ = &l;
 
   doc_count_ = 0;
@@ -218,6 +222,142 @@ parse (std::istream& is, path const& p)
   return parse_result {move (unit), move (dependencies_)};
 }
 
+parser::paths parser::
+parse_dependencies (std::istream& is, path const& p)
+{
+  {
+    path ap (p);
+    ap.complete ();
+    ap.normalize ();
+    include_map_[move (ap)] = nullptr;
+
+    dependencies_.push_back (path (p).normalize ());
+  }
+
+  lexer l (is, p.string (), diag_);
+  lexer_ = &l;
+
+  path_ = &p;
+  valid_ = true;
+
+  scan_unit ();
+
+  if (!valid_ || !l.valid ())
+    throw invalid_input ();
+
+  return move (dependencies_);
+}
+
+void parser::
+scan_unit ()
+{
+  for (token t (lexer_->next ());
+       t.type () != token::t_eos;
+       t = lexer_->next ())
+  {
+    token::keyword_type k (t.keyword ());
+
+    if (k != token::k_include && k != token::k_source)
+      continue;
+
+    t = lexer_->next ();
+    token::token_type tt (t.type ());
+
+    // C++ includes are not dependencies.
+    //
+    if (tt == token::t_cxx_path_lit && k == token::k_include)
+      continue;
+
+    if (tt != token::t_cli_path_lit)
+    {
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected " << (k == token::k_source ? "cli " : "")
+            << "path literal instead of " << t << endl;
+      valid_ = false;
+      continue;
+    }
+
+    string const& l (t.literal ());
+
+    path f;
+    try
+    {
+      f = path (string (l, 1, l.size () - 2));
+    }
+    catch (const invalid_path& e)
+    {
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "'" << e.path () << "' is not a valid filesystem path" << endl;
+      valid_ = false;
+      continue;
+    }
+
+    // Resolve the path the same way as include_cli() and source_decl().
+    //
+    path p;
+
+    if (l[0] == '"')
+    {
+      p = path_->directory () / f;
+      p.normalize ();
+    }
+    else
+    {
+      p = find_include (f);
+
+      if (p.empty ())
+      {
+        diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": "
+              << "error: file '" << f << "' not found in any of the "
+              << "include search directories (-I)" << endl;
+        valid_ = false;
+        continue;
+      }
+    }
+
+    // Each file is only scanned once since including or sourcing it again
+    // cannot add any new dependencies.
+    //
+    path ap (p);
+    ap.complete ();
+    ap.normalize ();
+
+    if (!include_map_.emplace (move (ap), nullptr).second)
+      continue;
+
+    dependencies_.push_back (p);
+
+    auto_restore<path const> new_path (path_, &p);
+
+    ifstream ifs (p.string ().c_str ());
+    if (ifs.is_open ())
+    {
+      ifs.exceptions (ifstream::failbit | ifstream::badbit);
+
+      try
+      {
+        lexer l (ifs, p.string (), diag_);
+        auto_restore<lexer> new_lexer (lexer_, &l);
+
+        scan_unit ();
+
+        if (!l.valid ())
+          valid_ = false;
+      }
+      catch (std::ios_base::failure const&)
+      {
+        diag_ << p << ": error: read failure" << endl;
+        valid_ = false;
+      }
+    }
+    else
+    {
+      diag_ << p << ": error: unable to open in read mode" << endl;
+      valid_ = false;
+    }
+  }
+}
+
 void parser::
 def_unit ()
 {
@@ -275,9 +415,9 @@ def_unit ()
         continue;
       }
 
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected namespace, class, or documentation instead of "
-           << t << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected namespace, class, or documentation instead of "
+            << t << endl;
       throw error ();
     }
     catch (error const&)
@@ -295,8 +435,8 @@ source_decl ()
 
   if (t.type () != token::t_cli_path_lit)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected cli path literal instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected cli path literal instead of " << t << endl;
     throw error ();
   }
 
@@ -310,8 +450,8 @@ source_decl ()
   }
   catch (const invalid_path& e)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "'" << e.path () << "' is not a valid filesystem path" << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "'" << e.path () << "' is not a valid filesystem path" << endl;
     valid_ = false;
   }
 
@@ -331,29 +471,21 @@ source_decl ()
     //
     else
     {
-      for (paths::const_iterator i (include_paths_.begin ());
-           i != include_paths_.end (); ++i)
-      {
-        p = *i / f;
-        p.normalize ();
-
-        if (file_exists (p))
-          break;
-
-        p.clear ();
-      }
+      p = find_include (f);
 
       if (p.empty ())
       {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": "
-             << "error: file '" << f << "' not found in any of the "
-             << "include search directories (-I)" << endl;
+        diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": "
+              << "error: file '" << f << "' not found in any of the "
+              << "include search directories (-I)" << endl;
         valid_ = false;
       }
     }
 
     if (valid_)
     {
+      sourcing_.insert (cur_);
+
       if (collect_dependencies_)
       {
         path ap (p);
@@ -373,7 +505,7 @@ source_decl ()
 
         try
         {
-          lexer l (ifs, p.string ());
+          lexer l (ifs, p.string (), diag_);
           auto_restore<lexer> new_lexer (lexer_, &l);
 
           def_unit ();
@@ -383,13 +515,13 @@ source_decl ()
         }
         catch (std::ios_base::failure const&)
         {
-          cerr << p << ": error: read failure" << endl;
+          diag_ << p << ": error: read failure" << endl;
           valid_ = false;
         }
       }
       else
       {
-        cerr << p << ": error: unable to open in read mode" << endl;
+        diag_ << p << ": error: unable to open in read mode" << endl;
         valid_ = false;
       }
     }
@@ -399,8 +531,8 @@ source_decl ()
 
   if (t.punctuation () != token::p_semi)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected ';' instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected ';' instead of " << t << endl;
     throw error ();
   }
 }
@@ -413,8 +545,8 @@ include_decl ()
 
   if (tt != token::t_cxx_path_lit && tt != token::t_cli_path_lit)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected path literal instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected path literal instead of " << t << endl;
     throw error ();
   }
 
@@ -428,8 +560,8 @@ include_decl ()
   }
   catch (const invalid_path& e)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "'" << e.path () << "' is not a valid filesystem path" << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "'" << e.path () << "' is not a valid filesystem path" << endl;
     valid_ = false;
   }
 
@@ -442,103 +574,121 @@ include_decl ()
       root_->new_edge<cxx_includes> (*cur_, n, ik, f);
     }
     else
-    {
-      path p;
-      // If this is a quote include, then include relative to the current
-      // file.
-      //
-      if (ik == includes::quote)
-      {
-        p = path_->directory () / f;
-        p.normalize ();
-      }
-      // Otherwise search the include directories (-I).
-      //
-      else
-      {
-        for (paths::const_iterator i (include_paths_.begin ());
-             i != include_paths_.end (); ++i)
-        {
-          p = *i / f;
-          p.normalize ();
+      include_cli (ik, f, t.line (), t.column ());
+  }
 
-          if (file_exists (p))
-            break;
+  t = lexer_->next ();
 
-          p.clear ();
-        }
+  if (t.punctuation () != token::p_semi)
+  {
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected ';' instead of " << t << endl;
+    throw error ();
+  }
+}
 
-        if (p.empty ())
-        {
-          cerr << *path_ << ':' << t.line () << ':' << t.column () << ": "
-               << "error: file '" << f << "' not found in any of the "
-               << "include search directories (-I)" << endl;
-          valid_ = false;
-        }
-      }
+void parser::
+include_cli (includes::kind_type ik, path const& f, size_t line, size_t col)
+{
+  path p;
 
-      if (valid_)
-      {
-        // Detect and ignore multiple inclusions.
-        //
-        path ap (p);
-        ap.complete ();
-        ap.normalize ();
+  // If this is a quote include, then include relative to the current
+  // file.
+  //
+  if (ik == includes::quote)
+  {
+    p = path_->directory () / f;
+    p.normalize ();
+  }
+  // Otherwise search the include directories (-I).
+  //
+  else
+  {
+    p = find_include (f);
 
-        include_map::iterator it (include_map_.find (ap));
-        if (it == include_map_.end () || it->second == nullptr)
-        {
-          if (collect_dependencies_ && it == include_map_.end ())
-            dependencies_.push_back (p);
+    if (p.empty ())
+    {
+      diag_ << *path_ << ':' << line << ':' << col << ": "
+            << "error: file '" << f << "' not found in any of the "
+            << "include search directories (-I)" << endl;
+      valid_ = false;
+      return;
+    }
+  }
 
-          cli_unit& n (root_->new_node<cli_unit> (p, 1, 1));
-          root_->new_edge<cli_includes> (*cur_, n, ik, f);
-          include_map_[move (ap)] = &n;
+  // Detect and ignore multiple inclusions.
+  //
+  path ap (p);
+  ap.complete ();
+  ap.normalize ();
 
-          auto_restore<cli_unit> new_cur (cur_, &n);
-          auto_restore<path const> new_path (path_, &p);
+  include_map::iterator it (include_map_.find (ap));
+  if (it != include_map_.end () && it->second != nullptr)
+  {
+    root_->new_edge<cli_includes> (*cur_, *it->second, ik, f);
+    return;
+  }
 
-          ifstream ifs (p.string ().c_str ());
-          if (ifs.is_open ())
-          {
-            ifs.exceptions (ifstream::failbit | ifstream::badbit);
+  if (collect_dependencies_ && it == include_map_.end ())
+    dependencies_.push_back (p);
 
-            try
-            {
-              lexer l (ifs, p.string ());
-              auto_restore<lexer> new_lexer (lexer_, &l);
+  cli_unit& n (root_->new_node<cli_unit> (p, 1, 1));
+  root_->new_edge<cli_includes> (*cur_, n, ik, f);
+  include_map_[ap] = &n;
 
-              def_unit ();
+  auto_restore<cli_unit> new_cur (cur_, &n);
+  auto_restore<path const> new_path (path_, &p);
 
-              if (!l.valid ())
-                valid_ = false;
-            }
-            catch (std::ios_base::failure const&)
-            {
-              cerr << p << ": error: read failure" << endl;
-              valid_ = false;
-            }
-          }
-          else
-          {
-            cerr << p << ": error: unable to open in read mode" << endl;
-            valid_ = false;
-          }
-        }
-        else
-          root_->new_edge<cli_includes> (*cur_, *it->second, ik, f);
-      }
+  if (cache_ != 0 && restore_unit (n, ap))
+    return;
+
+  ifstream ifs (p.string ().c_str ());
+  if (ifs.is_open ())
+  {
+    ifs.exceptions (ifstream::failbit | ifstream::badbit);
+
+    try
+    {
+      lexer l (ifs, p.string (), diag_);
+      auto_restore<lexer> new_lexer (lexer_, &l);
+
+      def_unit ();
+
+      if (!l.valid ())
+        valid_ = false;
+    }
+    catch (std::ios_base::failure const&)
+    {
+      diag_ << p << ": error: read failure" << endl;
+      valid_ = false;
     }
   }
+  else
+  {
+    diag_ << p << ": error: unable to open in read mode" << endl;
+    valid_ = false;
+  }
 
-  t = lexer_->next ();
+  // Note that if the unit is invalid, then we may not have all its nodes.
+  //
+  if (cache_ != 0 && valid_)
+    save_unit (n, ap);
+}
 
-  if (t.punctuation () != token::p_semi)
+path parser::
+find_include (path const& f)
+{
+  for (paths::const_iterator i (include_paths_.begin ());
+       i != include_paths_.end (); ++i)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected ';' instead of " << t << endl;
-    throw error ();
+    path p (*i / f);
+    p.normalize ();
+
+    if (file_exists (p))
+      return p;
   }
+
+  return path ();
 }
 
 bool parser::
@@ -564,6 +714,19 @@ decl (token& t)
         break;
       }
 
+      break;
+    }
+  case token::t_identifier:
+    {
+      // Note that commands is not a keyword so that it can still be used
+      // as an option name.
+      //
+      if (t.identifier () == "commands")
+      {
+        commands_def ();
+        return true;
+      }
+
       break;
     }
   case token::t_punctuation:
@@ -690,8 +853,9 @@ scope_doc (token& t)
     {
       if (t.type () != token::t_string_lit)
       {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-             << "expected documentation string instead of " << t << endl;
+        diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+              << ": error: "
+              << "expected documentation string instead of " << t << endl;
         throw error ();
       }
 
@@ -707,8 +871,8 @@ scope_doc (token& t)
 
     if (t.punctuation () != token::p_rcbrace)
     {
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected '}' instead of " << t << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected '}' instead of " << t << endl;
       throw error ();
     }
   }
@@ -721,8 +885,8 @@ namespace_def ()
 
   if (t.type () != token::t_identifier)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected identifier instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected identifier instead of " << t << endl;
     throw error ();
   }
 
@@ -740,8 +904,8 @@ namespace_def ()
 
   if (t.punctuation () != token::p_lcbrace)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected '{' instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected '{' instead of " << t << endl;
     throw error ();
   }
 
@@ -754,9 +918,9 @@ namespace_def ()
 
   if (t.punctuation () != token::p_rcbrace)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected namespace, class, documentation, or '}' instead of "
-         << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected namespace, class, documentation, or '}' instead of "
+          << t << endl;
     throw error ();
   }
 }
@@ -768,8 +932,8 @@ class_def ()
 
   if (t.type () != token::t_identifier)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected identifier instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected identifier instead of " << t << endl;
     throw error ();
   }
 
@@ -794,8 +958,9 @@ class_def ()
       string name;
       if (!qualified_name (t, name))
       {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-             << "expected qualified name instead of " << t << endl;
+        diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+              << ": error: "
+              << "expected qualified name instead of " << t << endl;
         throw error ();
       }
 
@@ -813,8 +978,8 @@ class_def ()
         root_->new_edge<inherits> (*n, *b);
       else
       {
-        cerr << *path_ << ':' << line << ':' << col << ": error: "
-             << "unable to resolve base class '" << name << "'" << endl;
+        diag_ << *path_ << ':' << line << ':' << col << ": error: "
+              << "unable to resolve base class '" << name << "'" << endl;
         valid_ = false;
       }
 
@@ -831,8 +996,8 @@ class_def ()
 
     if (t.type () != token::t_int_lit || t.literal () != "0")
     {
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected '0' instead of " << t << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected '0' instead of " << t << endl;
       throw error ();
     }
 
@@ -844,8 +1009,8 @@ class_def ()
 
   if (t.punctuation () != token::p_lcbrace)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected '{' instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected '{' instead of " << t << endl;
     throw error ();
   }
 
@@ -880,8 +1045,8 @@ class_def ()
 
   if (t.punctuation () != token::p_rcbrace)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected option, documentation, or '}' instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected option, documentation, or '}' instead of " << t << endl;
     throw error ();
   }
 
@@ -889,8 +1054,169 @@ class_def ()
 
   if (t.punctuation () != token::p_semi)
   {
-    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-         << "expected ';' instead of " << t << endl;
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected ';' instead of " << t << endl;
+    throw error ();
+  }
+}
+
+void parser::
+commands_def ()
+{
+  token t (lexer_->next ());
+
+  if (t.type () != token::t_identifier)
+  {
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected identifier instead of " << t << endl;
+    throw error ();
+  }
+
+  commands* n (0);
+  if (valid_)
+  {
+    n = &root_->new_node<commands> (*path_, t.line (), t.column ());
+    root_->new_edge<names> (*scope_, *n, t.identifier ());
+  }
+
+  t = lexer_->next ();
+
+  if (t.punctuation () != token::p_lcbrace)
+  {
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected '{' instead of " << t << endl;
+    throw error ();
+  }
+
+  // command-def-seq
+  //
+  std::set<string> all; // All the command names seen so far.
+
+  for (t = lexer_->next (); t.punctuation () != token::p_rcbrace;)
+  {
+    size_t line (t.line ()), col (t.column ());
+
+    string name;
+    if (!qualified_name (t, name))
+    {
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected command options class or '}' instead of " << t
+            << endl;
+      throw error ();
+    }
+
+    commands::command c;
+    c.options = 0;
+
+    // Resolve the options class the same way as base classes.
+    //
+    string ns;
+
+    if (name[0] == ':')
+      name = string (name, 2, string::npos);
+    else
+      ns = scope_->fq_name ();
+
+    if (class_* o = cur_->lookup<class_> (ns, name))
+    {
+      if (o->abstract ())
+      {
+        diag_ << *path_ << ':' << line << ':' << col << ": error: "
+              << "command options class '" << name << "' is abstract" << endl;
+        valid_ = false;
+      }
+      else
+        c.options = o;
+    }
+    else
+    {
+      diag_ << *path_ << ':' << line << ':' << col << ": error: "
+            << "unable to resolve command options class '" << name << "'"
+            << endl;
+      valid_ = false;
+    }
+
+    // command-name-seq
+    //
+    for (;;)
+    {
+      string cn;
+
+      switch (t.type ())
+      {
+      case token::t_identifier:
+        {
+          cn = t.identifier ();
+          break;
+        }
+      case token::t_string_lit:
+        {
+          // Get rid of '"'. Since command names are hashed at compile
+          // time, we don't support escape sequences in them.
+          //
+          string const& l (t.literal ());
+
+          if (l.find ('\\') != string::npos || l.size () == 2)
+          {
+            diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+                  << ": error: invalid command name " << l << endl;
+            valid_ = false;
+          }
+
+          cn.assign (l, 1, l.size () - 2);
+          break;
+        }
+      default:
+        {
+          diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+                << ": error: command name expected instead of " << t << endl;
+          throw error ();
+        }
+      }
+
+      if (!all.insert (cn).second)
+      {
+        diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+              << ": error: "
+              << "duplicate command name '" << cn << "'" << endl;
+        valid_ = false;
+      }
+
+      c.names.push_back (cn);
+      t = lexer_->next ();
+
+      if (t.punctuation () == token::p_or)
+        t = lexer_->next ();
+      else
+        break;
+    }
+
+    if (t.punctuation () != token::p_semi)
+    {
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected ';' instead of " << t << endl;
+      throw error ();
+    }
+
+    if (valid_)
+      n->list ().push_back (c);
+
+    t = lexer_->next ();
+  }
+
+  if (valid_ && n->list ().empty ())
+  {
+    diag_ << *path_ << ':' << n->line () << ':' << n->column () << ": error: "
+          << "command group '" << n->name () << "' is empty" << endl;
+    valid_ = false;
+  }
+
+  t = lexer_->next ();
+
+  if (t.punctuation () != token::p_semi)
+  {
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected ';' instead of " << t << endl;
     throw error ();
   }
 }
@@ -966,8 +1292,9 @@ option_def (token& t)
       }
     default:
       {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-             << "option name expected instead of " << t << endl;
+        diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+              << ": error: "
+              << "option name expected instead of " << t << endl;
         throw error ();
       }
     }
@@ -983,6 +1310,11 @@ option_def (token& t)
   if (valid_)
     root_->new_edge<names> (*scope_, *o, nl);
 
+  // option-attributes
+  //
+  if (t.punctuation () == token::p_lsbrace)
+    option_attributes (t, o, type_name);
+
   // initializer
   //
   std::string ev;
@@ -1049,8 +1381,8 @@ option_def (token& t)
         }
       default:
         {
-          cerr << *path_ << ':' << t.line () << ':' << t.column ()
-               << ": error: expected intializer instead of " << t << endl;
+          diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+                << ": error: expected intializer instead of " << t << endl;
           throw error ();
         }
       }
@@ -1084,8 +1416,9 @@ option_def (token& t)
     {
       if (t.type () != token::t_string_lit)
       {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-             << "expected documentation string instead of " << t << endl;
+        diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+              << ": error: "
+              << "expected documentation string instead of " << t << endl;
         throw error ();
       }
 
@@ -1101,8 +1434,8 @@ option_def (token& t)
 
     if (t.punctuation () != token::p_rcbrace)
     {
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected '}' instead of " << t << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected '}' instead of " << t << endl;
       throw error ();
     }
 
@@ -1117,15 +1450,173 @@ option_def (token& t)
   {
     if (t.punctuation () != token::p_semi)
     {
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected ';' instead of " << t << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected ';' instead of " << t << endl;
       throw error ();
     }
 
     t = lexer_->next ();
   }
 
-  return true;
+  return true;
+}
+
+// Return true if the type is one of the containers that can be used with
+// the separator attribute (see parse_list() in the generated runtime).
+// Since we don't resolve C++ names, the type has to be spelled as the
+// container template-id, unqualified or qualified with std:: (or, for
+// flat_set, with the runtime namespace which can be changed with
+// --cli-namespace). In particular, a typedef name of a container is not
+// recognized.
+//
+static bool
+container_type (string const& n)
+{
+  string::size_type p (n.find ('<'));
+
+  if (p == string::npos)
+    return false;
+
+  string t (n, 0, p);
+
+  // Strip trailing whitespaces and split off the namespace qualification.
+  //
+  t.erase (t.find_last_not_of (' ') + 1);
+
+  string ns;
+  string::size_type q (t.rfind (':'));
+  if (q != string::npos)
+  {
+    ns.assign (t, 0, q - 1);
+    t.erase (0, q + 1);
+
+    if (ns.compare (0, 2, "::") == 0)
+      ns.erase (0, 2);
+  }
+
+  if (t == "flat_set")
+    return true;
+
+  return (ns.empty () || ns == "std") &&
+    (t == "vector" ||
+     t == "set" ||
+     t == "map" ||
+     t == "multimap" ||
+     t == "unordered_set" ||
+     t == "unordered_map");
+}
+
+void parser::
+option_attributes (token& t, option* o, string const& type_name)
+{
+  // attribute-seq
+  //
+  for (t = lexer_->next ();; t = lexer_->next ())
+  {
+    if (t.type () != token::t_identifier)
+    {
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected attribute name instead of " << t << endl;
+      throw error ();
+    }
+
+    string n (t.identifier ());
+    size_t l (t.line ()), c (t.column ());
+
+    string v;
+    t = lexer_->next ();
+
+    if (t.punctuation () == token::p_eq)
+    {
+      t = lexer_->next ();
+
+      switch (t.type ())
+      {
+      case token::t_string_lit:
+      case token::t_char_lit:
+      case token::t_bool_lit:
+      case token::t_int_lit:
+      case token::t_float_lit:
+        {
+          v = t.literal ();
+          break;
+        }
+      default:
+        {
+          diag_ << *path_ << ':' << t.line () << ':' << t.column ()
+                << ": error: expected attribute value instead of " << t
+                << endl;
+          throw error ();
+        }
+      }
+
+      t = lexer_->next ();
+    }
+
+    if (n == "separator")
+    {
+      // The separator is used as a character literal in the generated
+      // code. It only makes sense for the container options whose values
+      // are parsed element by element.
+      //
+      if (v.empty () || v[0] != '\'')
+      {
+        diag_ << *path_ << ':' << l << ':' << c << ": error: "
+              << "separator attribute requires a character literal value"
+              << endl;
+        throw error ();
+      }
+
+      if (!container_type (type_name))
+      {
+        diag_ << *path_ << ':' << l << ':' << c << ": error: "
+              << "separator attribute is only valid for container options"
+              << endl;
+        diag_ << *path_ << ':' << l << ':' << c << ": info: "
+              << "option type must be spelled as std::vector, std::set, "
+              << "std::map, std::multimap, std::unordered_set, "
+              << "std::unordered_map, or cli::flat_set (typedef names are "
+              << "not resolved)" << endl;
+        throw error ();
+      }
+    }
+    else if (n == "transient")
+    {
+      // Transient options are excluded from comparison and hashing.
+      //
+      if (!v.empty ())
+      {
+        diag_ << *path_ << ':' << l << ':' << c << ": error: "
+              << "transient attribute does not take a value" << endl;
+        throw error ();
+      }
+    }
+    else
+    {
+      diag_ << *path_ << ':' << l << ':' << c << ": error: "
+            << "unknown option attribute '" << n << "'" << endl;
+      throw error ();
+    }
+
+    if (valid_ && !o->attributes ().insert (make_pair (n, v)).second)
+    {
+      diag_ << *path_ << ':' << l << ':' << c << ": error: "
+            << "duplicate option attribute '" << n << "'" << endl;
+      throw error ();
+    }
+
+    if (t.punctuation () != token::p_comma)
+      break;
+  }
+
+  if (t.punctuation () != token::p_rsbrace)
+  {
+    diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+          << "expected ']' instead of " << t << endl;
+    throw error ();
+  }
+
+  t = lexer_->next ();
 }
 
 string parser::
@@ -1232,8 +1723,8 @@ doc_string (const char* l, size_t n)
 
     if (pre)
     {
-      cerr << *path_ << ": error: missing pre-formatted fragment end marker "
-           << "in documentation string '" << t1 << "'" << endl;
+      diag_ << *path_ << ": error: missing pre-formatted fragment end marker "
+            << "in documentation string '" << t1 << "'" << endl;
       throw error ();
     }
   }
@@ -1271,9 +1762,9 @@ doc_string (const char* l, size_t n)
         {
           if (k != 0 && t3[k - 1] != '\n') // Outer.
           {
-            cerr << *path_ << ": error: missing empty line before pre-"
-                 << "formatted fragment start marker in documentation "
-                 << "string '" << t1 << "'" << endl;
+            diag_ << *path_ << ": error: missing empty line before pre-"
+                  << "formatted fragment start marker in documentation "
+                  << "string '" << t1 << "'" << endl;
             throw error ();
           }
 
@@ -1286,9 +1777,9 @@ doc_string (const char* l, size_t n)
 
           if (i + 2 < n && (t2[i + 1] != '\n' || t2[i + 2] != '\n')) // Outer.
           {
-            cerr << *path_ << ": error: missing empty line after pre-"
-                 << "formatted fragment end marker in documentation "
-                 << "string '" << t1 << "'" << endl;
+            diag_ << *path_ << ": error: missing empty line after pre-"
+                  << "formatted fragment end marker in documentation "
+                  << "string '" << t1 << "'" << endl;
             throw error ();
           }
         }
@@ -1338,8 +1829,8 @@ qualified_name (token& t, string& r)
   {
     if (t.type () != token::t_identifier)
     {
-      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-           << "expected identifier after '::'" << endl;
+      diag_ << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+            << "expected identifier after '::'" << endl;
       throw error ();
     }
 
@@ -1743,3 +2234,592 @@ fundamental_type (token& t, string& r)
 
   return true;
 }
+
+//
+// Parsed unit cache.
+//
+
+// Kinds of the named nodes in the cache entry.
+//
+enum cached_node
+{
+  cached_namespace,
+  cached_class,
+  cached_commands,
+  cached_option,
+  cached_doc
+};
+
+// Collect classes in the declaration order.
+//
+static void
+collect_classes (scope& s, vector<class_*>& r)
+{
+  for (scope::names_iterator i (s.names_begin ()); i != s.names_end (); ++i)
+  {
+    nameable& n (i->named ());
+
+    if (class_* c = dynamic_cast<class_*> (&n))
+      r.push_back (c);
+    else if (namespace_* ns = dynamic_cast<namespace_*> (&n))
+      collect_classes (*ns, r);
+  }
+}
+
+// Base and command options classes are referred to in the cache entry by
+// the unit index in the include closure (with the cached unit first) and
+// the class index in that unit.
+//
+struct parser::unit_refs
+{
+  vector<cli_unit*> units;
+  vector<vector<class_*> > classes;
+  map<class_*, pair<size_t, size_t> > index;
+
+  void
+  write (unit_cache::writer& w, class_& c)
+  {
+    map<class_*, pair<size_t, size_t> >::const_iterator i (index.find (&c));
+    assert (i != index.end ());
+
+    w.write (i->second.first);
+    w.write (i->second.second);
+  }
+
+  class_&
+  read (unit_cache::reader& r)
+  {
+    size_t u (r.read_size ()), c (r.read_size ());
+
+    // The classes of the cached unit itself are added as they are restored.
+    //
+    vector<class_*>& cs (classes[u]);
+    if (u != 0 && cs.empty ())
+      collect_classes (*units[u], cs);
+
+    assert (c < cs.size ());
+    return *cs[c];
+  }
+
+  static void
+  skip (unit_cache::reader& r)
+  {
+    r.read_size ();
+    r.read_size ();
+  }
+};
+
+bool parser::
+restore_unit (cli_unit& u, path const& ap)
+{
+  string data;
+  if (!cache_->load (ap, data))
+    return false;
+
+  unit_cache::reader r (data);
+
+  // Make sure this unit and all the units it includes, transitively, are
+  // unchanged, that their bracket includes still resolve to the same files,
+  // and that the entry is not malformed. Only then can we start adding
+  // nodes to the graph.
+  //
+  vector<string> files;
+  try
+  {
+    for (size_t n (r.read_size ()); n != 0; --n)
+    {
+      string f (r.read_string ());
+
+      if (cache_->content (path (f)) != r.read_string ())
+        return false;
+
+      for (size_t m (r.read_size ()); m != 0; --m)
+      {
+        path p (find_include (path (r.read_string ())));
+
+        if (p.empty ())
+          return false;
+
+        p.complete ();
+        p.normalize ();
+
+        if (p.string () != r.read_string ())
+          return false;
+      }
+
+      files.push_back (f);
+    }
+
+    // Since we cannot take back the nodes that have been added to the
+    // graph, decode the rest of the entry without changing anything first.
+    //
+    unit_cache::reader t (r);
+    restore_graph (t, 0, files);
+  }
+  catch (unit_cache::reader::malformed const&)
+  {
+    return false; // Treat as a cache miss.
+  }
+
+  restore_graph (r, &u, files);
+  return true;
+}
+
+void parser::
+restore_graph (unit_cache::reader& r,
+               cli_unit* u,
+               vector<string> const& files)
+{
+  // Replay the includes. Since a cached unit does not source any files,
+  // they all precede the declarations.
+  //
+  for (size_t n (r.read_size ()); n != 0; --n)
+  {
+    // If an included unit turned out to be invalid, then the whole parse
+    // fails and there is no use restoring the rest.
+    //
+    if (u != 0 && !valid_)
+      return;
+
+    bool cxx (r.read_size () != 0);
+    includes::kind_type k (static_cast<includes::kind_type> (r.read_size ()));
+    path f (r.read_string ());
+
+    size_t l (0), c (0);
+    if (cxx)
+    {
+      l = r.read_size ();
+      c = r.read_size ();
+    }
+
+    if (u == 0)
+      continue;
+
+    if (cxx)
+    {
+      cxx_unit& n (root_->new_node<cxx_unit> (*path_, l, c));
+      root_->new_edge<cxx_includes> (*cur_, n, k, f);
+    }
+    else
+      include_cli (k, f, 0, 0); // Resolution has been verified above.
+  }
+
+  if (u == 0)
+  {
+    restore_scope (r, 0, 0);
+    return;
+  }
+
+  if (!valid_)
+    return;
+
+  unit_refs rs;
+  rs.units.push_back (u);
+
+  for (size_t i (1); i < files.size (); ++i)
+  {
+    include_map::const_iterator j (include_map_.find (path (files[i])));
+    assert (j != include_map_.end () && j->second != nullptr);
+    rs.units.push_back (j->second);
+  }
+
+  rs.classes.resize (rs.units.size ());
+
+  restore_scope (r, u, &rs);
+}
+
+void parser::
+restore_scope (unit_cache::reader& r, scope* s, unit_refs* rs)
+{
+  for (size_t n (r.read_size ()); n != 0; --n)
+  {
+    size_t k (r.read_size ()), l (r.read_size ()), c (r.read_size ());
+
+    switch (k)
+    {
+    case cached_namespace:
+      {
+        string nn (r.read_string ());
+
+        namespace_* x (0);
+        if (s != 0)
+        {
+          x = &root_->new_node<namespace_> (*path_, l, c);
+          root_->new_edge<names> (*s, *x, nn);
+        }
+
+        restore_scope (r, x, rs);
+        break;
+      }
+    case cached_class:
+      {
+        string cn (r.read_string ());
+
+        class_* x (0);
+        if (s != 0)
+        {
+          x = &root_->new_node<class_> (*path_, l, c);
+          root_->new_edge<names> (*s, *x, cn);
+          rs->classes[0].push_back (x);
+        }
+
+        bool a (r.read_size () != 0);
+        if (x != 0)
+          x->abstract (a);
+
+        for (size_t m (r.read_size ()); m != 0; --m)
+        {
+          if (x != 0)
+            root_->new_edge<inherits> (*x, rs->read (r));
+          else
+            unit_refs::skip (r);
+        }
+
+        restore_scope (r, x, rs);
+        break;
+      }
+    case cached_commands:
+      {
+        string cn (r.read_string ());
+
+        commands* x (0);
+        if (s != 0)
+        {
+          x = &root_->new_node<commands> (*path_, l, c);
+          root_->new_edge<names> (*s, *x, cn);
+        }
+
+        for (size_t m (r.read_size ()); m != 0; --m)
+        {
+          commands::command cmd;
+
+          if (x != 0)
+            cmd.options = &rs->read (r);
+          else
+            unit_refs::skip (r);
+
+          for (size_t i (r.read_size ()); i != 0; --i)
+            cmd.names.push_back (r.read_string ());
+
+          if (x != 0)
+            x->list ().push_back (cmd);
+        }
+        break;
+      }
+    case cached_option:
+      {
+        names::name_list nl;
+        for (size_t m (r.read_size ()); m != 0; --m)
+          nl.push_back (r.read_string ());
+
+        string tn (r.read_string ());
+
+        option::attribute_map as;
+        for (size_t m (r.read_size ()); m != 0; --m)
+        {
+          string an (r.read_string ());
+          as[an] = r.read_string ();
+        }
+
+        bool init (r.read_size () != 0);
+        expression::expression_type et (expression::string_lit);
+        string ev;
+        size_t el (0), ec (0);
+
+        if (init)
+        {
+          et = static_cast<expression::expression_type> (r.read_size ());
+          ev = r.read_string ();
+          el = r.read_size ();
+          ec = r.read_size ();
+        }
+
+        doc_strings dl;
+        for (size_t m (r.read_size ()); m != 0; --m)
+          dl.push_back (r.read_string ());
+
+        if (s == 0)
+          break;
+
+        option& x (root_->new_node<option> (*path_, l, c));
+        type& t (root_->new_type (*path_, l, c, tn));
+        root_->new_edge<belongs> (x, t);
+        root_->new_edge<names> (*s, x, nl);
+
+        x.attributes () = as;
+
+        if (init)
+        {
+          expression& e (
+            root_->new_node<expression> (*path_, el, ec, et, ev));
+          root_->new_edge<initialized> (x, e);
+        }
+
+        x.doc () = dl;
+        break;
+      }
+    case cached_doc:
+      {
+        bool numbered (r.read_size () != 0);
+
+        string dn;
+        if (!numbered)
+          dn = r.read_string ();
+
+        doc_strings dl;
+        for (size_t m (r.read_size ()); m != 0; --m)
+          dl.push_back (r.read_string ());
+
+        if (s == 0)
+          break;
+
+        // Numbered names are assigned anew (see scope_doc()).
+        //
+        if (numbered)
+        {
+          ostringstream os;
+          os << "doc: " << doc_count_++;
+          dn = os.str ();
+        }
+
+        doc& x (root_->new_node<doc> (*path_, l, c));
+        root_->new_edge<names> (*s, x, dn);
+        static_cast<doc_strings&> (x) = dl;
+        break;
+      }
+    default:
+      throw unit_cache::reader::malformed ();
+    }
+  }
+}
+
+void parser::
+save_unit (cli_unit& u, path const& ap)
+{
+  unit_refs rs;
+
+  // Collect the include closure and number the classes.
+  //
+  {
+    set<cli_unit*> seen;
+    seen.insert (&u);
+    rs.units.push_back (&u);
+
+    for (size_t i (0); i != rs.units.size (); ++i)
+    {
+      cli_unit& cu (*rs.units[i]);
+
+      if (sourcing_.find (&cu) != sourcing_.end ())
+        return;
+
+      for (cli_unit::includes_iterator j (cu.includes_begin ());
+           j != cu.includes_end (); ++j)
+      {
+        if (cli_includes* ci = dynamic_cast<cli_includes*> (&*j))
+        {
+          if (seen.insert (&ci->includee ()).second)
+            rs.units.push_back (&ci->includee ());
+        }
+      }
+
+      rs.classes.push_back (vector<class_*> ());
+      vector<class_*>& cs (rs.classes.back ());
+      collect_classes (cu, cs);
+
+      for (size_t k (0); k != cs.size (); ++k)
+        rs.index[cs[k]] = make_pair (i, k);
+    }
+  }
+
+  unit_cache::writer w;
+
+  w.write (rs.units.size ());
+  for (size_t i (0); i != rs.units.size (); ++i)
+  {
+    cli_unit& cu (*rs.units[i]);
+
+    path f (cu.file ());
+    f.complete ();
+    f.normalize ();
+
+    string h (cache_->content (f));
+    if (h.empty ())
+      return;
+
+    w.write (f.string ());
+    w.write (h);
+
+    vector<cli_includes*> bs;
+    for (cli_unit::includes_iterator j (cu.includes_begin ());
+         j != cu.includes_end (); ++j)
+    {
+      if (cli_includes* ci = dynamic_cast<cli_includes*> (&*j))
+      {
+        if (ci->kind () == includes::bracket)
+          bs.push_back (ci);
+      }
+    }
+
+    w.write (bs.size ());
+    for (size_t j (0); j != bs.size (); ++j)
+    {
+      path p (bs[j]->includee ().file ());
+      p.complete ();
+      p.normalize ();
+
+      w.write (bs[j]->file ().string ());
+      w.write (p.string ());
+    }
+  }
+
+  {
+    size_t n (0);
+    for (cli_unit::includes_iterator i (u.includes_begin ());
+         i != u.includes_end (); ++i)
+      ++n;
+
+    w.write (n);
+  }
+
+  for (cli_unit::includes_iterator i (u.includes_begin ());
+       i != u.includes_end (); ++i)
+  {
+    cxx_includes* ci (dynamic_cast<cxx_includes*> (&*i));
+
+    w.write (ci != 0 ? 1 : 0);
+    w.write (i->kind ());
+    w.write (i->file ().string ());
+
+    if (ci != 0)
+    {
+      w.write (ci->includee ().line ());
+      w.write (ci->includee ().column ());
+    }
+  }
+
+  save_scope (w, u, rs);
+
+  cache_->save (ap, w.data);
+}
+
+void parser::
+save_scope (unit_cache::writer& w, scope& s, unit_refs& rs)
+{
+  {
+    size_t n (0);
+    for (scope::names_iterator i (s.names_begin ()); i != s.names_end (); ++i)
+      ++n;
+
+    w.write (n);
+  }
+
+  for (scope::names_iterator i (s.names_begin ()); i != s.names_end (); ++i)
+  {
+    names& e (*i);
+    nameable& n (e.named ());
+
+    if (namespace_* x = dynamic_cast<namespace_*> (&n))
+    {
+      w.write (cached_namespace);
+      w.write (x->line ());
+      w.write (x->column ());
+      w.write (e.name ());
+
+      save_scope (w, *x, rs);
+    }
+    else if (class_* x = dynamic_cast<class_*> (&n))
+    {
+      w.write (cached_class);
+      w.write (x->line ());
+      w.write (x->column ());
+      w.write (e.name ());
+      w.write (x->abstract () ? 1 : 0);
+
+      size_t m (0);
+      for (class_::inherits_iterator j (x->inherits_begin ());
+           j != x->inherits_end (); ++j)
+        ++m;
+
+      w.write (m);
+      for (class_::inherits_iterator j (x->inherits_begin ());
+           j != x->inherits_end (); ++j)
+        rs.write (w, j->base ());
+
+      save_scope (w, *x, rs);
+    }
+    else if (commands* x = dynamic_cast<commands*> (&n))
+    {
+      w.write (cached_commands);
+      w.write (x->line ());
+      w.write (x->column ());
+      w.write (e.name ());
+
+      commands::command_list const& cl (x->list ());
+
+      w.write (cl.size ());
+      for (commands::command_list::const_iterator j (cl.begin ());
+           j != cl.end (); ++j)
+      {
+        rs.write (w, *j->options);
+
+        w.write (j->names.size ());
+        for (size_t k (0); k != j->names.size (); ++k)
+          w.write (j->names[k]);
+      }
+    }
+    else if (option* x = dynamic_cast<option*> (&n))
+    {
+      w.write (cached_option);
+      w.write (x->line ());
+      w.write (x->column ());
+
+      w.write (static_cast<size_t> (e.name_end () - e.name_begin ()));
+      for (names::name_iterator j (e.name_begin ()); j != e.name_end (); ++j)
+        w.write (*j);
+
+      w.write (x->type ().name ());
+
+      option::attribute_map const& am (x->attributes ());
+
+      w.write (am.size ());
+      for (option::attribute_map::const_iterator j (am.begin ());
+           j != am.end (); ++j)
+      {
+        w.write (j->first);
+        w.write (j->second);
+      }
+
+      w.write (x->initialized_p () ? 1 : 0);
+      if (x->initialized_p ())
+      {
+        expression& ie (x->initializer ());
+
+        w.write (ie.type ());
+        w.write (ie.value ());
+        w.write (ie.line ());
+        w.write (ie.column ());
+      }
+
+      w.write (x->doc ().size ());
+      for (size_t j (0); j != x->doc ().size (); ++j)
+        w.write (x->doc ()[j]);
+    }
+    else if (doc* x = dynamic_cast<doc*> (&n))
+    {
+      w.write (cached_doc);
+      w.write (x->line ());
+      w.write (x->column ());
+
+      string const& dn (e.name ());
+      bool numbered (dn.compare (0, 5, "doc: ") == 0);
+
+      w.write (numbered ? 1 : 0);
+      if (!numbered)
+        w.write (dn);
+
+      w.write (x->size ());
+      for (size_t j (0); j != x->size (); ++j)
+        w.write ((*x)[j]);
+    }
+  }
+}
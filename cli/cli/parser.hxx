@@ -6,14 +6,19 @@
 #define CLI_PARSER_HXX
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <memory>  // unique_ptr
 #include <cstddef> // size_t
 #include <istream>
+#include <ostream>
 
 #include "semantics/elements.hxx"
 #include "semantics/unit.hxx"
+#include "semantics/option.hxx"
+
+#include "unit-cache.hxx"
 
 class token;
 class lexer;
@@ -23,9 +28,18 @@ class parser
 public:
   typedef std::vector<semantics::path> paths;
 
-  parser (paths const& include_paths, bool collect_dependencies)
+  // Diagnostics is written to the diag stream. If the cache is not NULL,
+  // then included units are loaded from and saved to it (see
+  // unit-cache.hxx).
+  //
+  parser (paths const& include_paths,
+          bool collect_dependencies,
+          std::ostream& diag,
+          unit_cache* cache = 0)
       : include_paths_ (include_paths),
-        collect_dependencies_ (collect_dependencies) {}
+        collect_dependencies_ (collect_dependencies),
+        diag_ (diag),
+        cache_ (cache) {}
 
   struct invalid_input {};
 
@@ -42,6 +56,15 @@ public:
   parse_result
   parse (std::istream& is, semantics::path const& path);
 
+  // Only determine the dependencies, as returned by parse(), without
+  // building the semantic graph. Only the include and source declarations
+  // are recognized with the rest of the input only being lexed. As a
+  // result, the only errors diagnosed are lexical and those in these
+  // declarations, including unresolved or unreadable files.
+  //
+  paths
+  parse_dependencies (std::istream& is, semantics::path const& path);
+
 private:
   struct error {};
 
@@ -54,6 +77,23 @@ private:
   void
   include_decl ();
 
+  void
+  include_cli (semantics::includes::kind_type,
+               semantics::path const& file,
+               std::size_t line,
+               std::size_t column);
+
+  // Scan the current file for include and source declarations (see
+  // parse_dependencies()).
+  //
+  void
+  scan_unit ();
+
+  // Search the include directories (-I) returning empty path if not found.
+  //
+  semantics::path
+  find_include (semantics::path const& file);
+
   bool
   decl (token&);
 
@@ -66,9 +106,15 @@ private:
   void
   class_def ();
 
+  void
+  commands_def ();
+
   bool
   option_def (token&);
 
+  void
+  option_attributes (token&, semantics::option*, std::string const& type);
+
   std::string
   doc_string (const char*, std::size_t);
 
@@ -82,9 +128,36 @@ private:
   void
   recover (token& t);
 
+  // Parsed unit cache.
+  //
+private:
+  struct unit_refs;
+
+  bool
+  restore_unit (semantics::cli_unit&, semantics::path const& abs);
+
+  // Restore the includes and declarations of the cached unit. If the unit
+  // is NULL, then only decode them throwing unit_cache::reader::malformed
+  // if the entry is malformed.
+  //
+  void
+  restore_graph (unit_cache::reader&,
+                 semantics::cli_unit*,
+                 std::vector<std::string> const& files);
+
+  void
+  restore_scope (unit_cache::reader&, semantics::scope*, unit_refs*);
+
+  void
+  save_unit (semantics::cli_unit&, semantics::path const& abs);
+
+  void
+  save_scope (unit_cache::writer&, semantics::scope&, unit_refs&);
+
 private:
   paths const include_paths_;
   bool collect_dependencies_;
+  std::ostream& diag_;
 
   bool valid_;
   semantics::path const* path_;
@@ -103,6 +176,13 @@ private:
   include_map include_map_;
 
   paths dependencies_;
+
+  unit_cache* cache_;
+
+  // Units that source other files. Such units and units that include them
+  // are not cached.
+  //
+  std::set<semantics::cli_unit*> sourcing_;
 };
 
 #endif // CLI_PARSER_HXX
@@ -18,6 +18,9 @@
 #include <utility>
 #include <ostream>
 #include <sstream>
+#include <limits>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 
@@ -626,52 +629,263 @@ namespace cli
     }
   };
 
-  template <typename K, typename V, typename C>
-  struct parser<std::map<K, V, C> >
+  template <typename X>
+  struct value_parser
   {
     static void
-    parse (std::map<K, V, C>& m, bool& xs, scanner& s)
+    parse (X& x, const char* o,
+           const char* b, const char* e,
+           std::size_t pos)
     {
-      const char* o (s.next ());
+      std::string v;
+      if (*e != '\0')
+      {
+        v.assign (b, e);
+        b = v.c_str ();
+      }
 
-      if (s.more ())
+      int ac (2);
+      char* av[] =
       {
-        std::size_t pos (s.position ());
-        std::string ov (s.next ());
-        std::string::size_type p = ov.find ('=');
+        const_cast<char*> (o),
+        const_cast<char*> (b)
+      };
 
-        K k = K ();
-        V v = V ();
-        std::string kstr (ov, 0, p);
-        std::string vstr (ov, (p != std::string::npos ? p + 1 : ov.size ()));
+      argv_scanner s (0, ac, av, false, pos);
+      bool dummy;
+      parser<X>::parse (x, dummy, s);
+    }
+  };
 
-        int ac (2);
-        char* av[] =
-        {
-          const_cast<char*> (o),
-          0
-        };
+  template <>
+  struct value_parser<std::string>
+  {
+    static void
+    parse (std::string& x, const char*,
+           const char* b, const char* e,
+           std::size_t)
+    {
+      x.assign (b, e);
+    }
+  };
+
+  class value_slice
+  {
+    public:
+    value_slice (const char* b, const char* e)
+    : p_ (b)
+    {
+      if (*e != '\0')
+      {
+        std::size_t n (e - b);
 
-        bool dummy;
-        if (!kstr.empty ())
+        if (n < sizeof (b_))
         {
-          av[1] = const_cast<char*> (kstr.c_str ());
-          argv_scanner s (0, ac, av, false, pos);
-          parser<K>::parse (k, dummy, s);
+          std::memcpy (b_, b, n);
+          b_[n] = '\0';
+          p_ = b_;
         }
-
-        if (!vstr.empty ())
+        else
         {
-          av[1] = const_cast<char*> (vstr.c_str ());
-          argv_scanner s (0, ac, av, false, pos);
-          parser<V>::parse (v, dummy, s);
+          s_.assign (b, e);
+          p_ = s_.c_str ();
         }
-
-        m[k] = v;
       }
-      else
-        throw missing_value (o);
+    }
+
+    const char*
+    c_str () const 
+    {
+      return p_;
+    }
+
+    private:
+    value_slice (const value_slice&);
+    value_slice& operator= (const value_slice&);
+
+    private:
+    const char* p_;
+    char b_[64];
+    std::string s_;
+  };
+
+  template <typename X, typename T, T (*f) (const char*, char**, int)>
+  struct value_parser_signed
+  {
+    static void
+    parse (X& x, const char* o,
+           const char* b, const char* e,
+           std::size_t)
+    {
+      value_slice v (b, e);
+      const char* p (v.c_str ());
+      char* pe;
+
+      errno = 0;
+      T r (f (p, &pe, 10));
+
+      if (pe == p || *pe != '\0' || errno == ERANGE ||
+          r < std::numeric_limits<X>::min () ||
+          r > std::numeric_limits<X>::max ())
+        throw invalid_value (o, std::string (b, e));
+
+      x = static_cast<X> (r);
+    }
+  };
+
+  template <typename X, typename T, T (*f) (const char*, char**, int)>
+  struct value_parser_unsigned
+  {
+    static void
+    parse (X& x, const char* o,
+           const char* b, const char* e,
+           std::size_t)
+    {
+      value_slice v (b, e);
+      const char* p (v.c_str ());
+      char* pe;
+
+      errno = 0;
+      T r (f (p, &pe, 10));
+
+      // If the whole value is consumed, then '-' can only be its sign.
+      //
+      if (pe == p || *pe != '\0' || errno == ERANGE ||
+          (std::strchr (p, '-') != 0 ? 0 - r : r) >
+          std::numeric_limits<X>::max ())
+        throw invalid_value (o, std::string (b, e));
+
+      x = static_cast<X> (r);
+    }
+  };
+
+  template <typename X>
+  struct value_parser_float
+  {
+    static void
+    parse (X& x, const char* o,
+           const char* b, const char* e,
+           std::size_t)
+    {
+      value_slice v (b, e);
+      const char* p (v.c_str ());
+      char* pe;
+
+      // Unlike istream, strtod() also accepts hexadecimal values as
+      // well as infinity and NaN.
+      //
+      double r (std::strtod (p, &pe));
+
+      if (pe == p || *pe != '\0' || std::strpbrk (p, "xXnN") != 0 ||
+          r < -std::numeric_limits<X>::max () ||
+          r > std::numeric_limits<X>::max ())
+        throw invalid_value (o, std::string (b, e));
+
+      x = static_cast<X> (r);
+    }
+  };
+
+  template <>
+  struct value_parser<short>:
+  value_parser_signed<short, long, &std::strtol> 
+  {
+  };
 
+  template <>
+  struct value_parser<int>:
+  value_parser_signed<int, long, &std::strtol> 
+  {
+  };
+
+  template <>
+  struct value_parser<long>:
+  value_parser_signed<long, long, &std::strtol> 
+  {
+  };
+
+  template <>
+  struct value_parser<unsigned short>:
+  value_parser_unsigned<unsigned short, unsigned long, &std::strtoul> 
+  {
+  };
+
+  template <>
+  struct value_parser<unsigned int>:
+  value_parser_unsigned<unsigned int, unsigned long, &std::strtoul> 
+  {
+  };
+
+  template <>
+  struct value_parser<unsigned long>:
+  value_parser_unsigned<unsigned long, unsigned long, &std::strtoul> 
+  {
+  };
+
+  template <>
+  struct value_parser<float>: value_parser_float<float> 
+  {
+  };
+
+  template <>
+  struct value_parser<double>: value_parser_float<double> 
+  {
+  };
+
+  template <typename K, typename V>
+  void
+  parse_entry (K& k, V& v, const char* o,
+               const char* b, const char* e,
+               std::size_t pos)
+  {
+    const char* vb (
+      static_cast<const char*> (std::memchr (b, '=', e - b)));
+    const char* ke (vb != 0 ? vb : e);
+
+    if (ke != b)
+      value_parser<K>::parse (k, o, b, ke, pos);
+
+    if (vb != 0 && ++vb != e)
+      value_parser<V>::parse (v, o, vb, e, pos);
+  }
+
+  template <typename K, typename V>
+  void
+  parse_entry (K& k, V& v, scanner& s)
+  {
+    const char* o (s.next ());
+
+    if (!s.more ())
+      throw missing_value (o);
+
+    std::size_t pos (s.position ());
+    const char* b (s.next ());
+    parse_entry (k, v, o, b, b + std::strlen (b), pos);
+  }
+
+  template <typename K, typename V, typename C>
+  struct parser<std::map<K, V, C> >
+  {
+    static void
+    parse (std::map<K, V, C>& m, bool& xs, scanner& s)
+    {
+      K k = K ();
+      V v = V ();
+      parse_entry (k, v, s);
+      m[k] = v;
+      xs = true;
+    }
+  };
+
+  template <typename K, typename V, typename C>
+  struct parser<std::multimap<K, V, C> >
+  {
+    static void
+    parse (std::multimap<K, V, C>& m, bool& xs, scanner& s)
+    {
+      K k = K ();
+      V v = V ();
+      parse_entry (k, v, s);
+      m.insert (typename std::multimap<K, V, C>::value_type (k, v));
       xs = true;
     }
   };
@@ -712,6 +926,12 @@ options ()
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -720,9 +940,17 @@ options ()
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -737,7 +965,9 @@ options ()
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -746,6 +976,8 @@ options ()
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -837,6 +1069,7 @@ options ()
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -861,6 +1094,12 @@ options (int& argc,
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -869,9 +1108,17 @@ options (int& argc,
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -886,7 +1133,9 @@ options (int& argc,
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -895,6 +1144,8 @@ options (int& argc,
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -986,6 +1237,7 @@ options (int& argc,
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -1013,6 +1265,12 @@ options (int start,
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -1021,9 +1279,17 @@ options (int start,
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -1038,7 +1304,9 @@ options (int start,
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -1047,6 +1315,8 @@ options (int start,
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -1138,6 +1408,7 @@ options (int start,
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -1165,6 +1436,12 @@ options (int& argc,
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -1173,9 +1450,17 @@ options (int& argc,
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -1190,7 +1475,9 @@ options (int& argc,
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -1199,6 +1486,8 @@ options (int& argc,
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -1290,6 +1579,7 @@ options (int& argc,
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -1319,6 +1609,12 @@ options (int start,
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -1327,9 +1623,17 @@ options (int start,
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -1344,7 +1648,9 @@ options (int start,
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -1353,6 +1659,8 @@ options (int start,
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -1444,6 +1752,7 @@ options (int start,
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -1469,6 +1778,12 @@ options (::cli::scanner& s,
   version_ (),
   include_path_ (),
   include_path_specified_ (false),
+  parse_cache_ (),
+  parse_cache_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  server_ (),
+  server_specified_ (false),
   output_dir_ (),
   output_dir_specified_ (false),
   std_ (cxx_version::cxx98),
@@ -1477,9 +1792,17 @@ options (::cli::scanner& s,
   generate_specifier_ (),
   generate_parse_ (),
   generate_merge_ (),
+  lazy_defaults_ (),
   generate_description_ (),
+  generate_dynamic_options_ (),
+  generate_snapshot_ (),
+  generate_hash_ (),
+  generate_argv_ (),
+  generate_instrumentation_ (),
   generate_file_scanner_ (),
+  generate_file_prefetch_ (),
   generate_vector_scanner_ (),
+  generate_string_scanner_ (),
   generate_group_scanner_ (),
   suppress_inline_ (),
   suppress_cli_ (),
@@ -1494,7 +1817,9 @@ options (::cli::scanner& s,
   generate_html_ (),
   generate_txt_ (),
   generate_dep_ (),
+  generate_dep_only_ (),
   stdout__ (),
+  write_if_changed_ (),
   suppress_undocumented_ (),
   suppress_usage_ (),
   long_usage_ (),
@@ -1503,6 +1828,8 @@ options (::cli::scanner& s,
   page_usage_specified_ (false),
   option_length_ (0),
   option_length_specified_ (false),
+  option_profile_ (),
+  option_profile_specified_ (false),
   ascii_tree_ (),
   ansi_color_ (),
   exclude_base_ (),
@@ -1594,6 +1921,7 @@ options (::cli::scanner& s,
   keep_separator_ (),
   no_combined_flags_ (),
   no_combined_values_ (),
+  allow_abbreviations_ (),
   include_with_brackets_ (),
   include_prefix_ (),
   include_prefix_specified_ (false),
@@ -1622,6 +1950,18 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
   os << "--include-path|-I <dir>      Search <dir> for bracket-included (<>) options" << ::std::endl
      << "                             files." << ::std::endl;
 
+  os << "--parse-cache <dir>          Cache the parsed representation of included" << ::std::endl
+     << "                             options files in <dir> and reuse it in subsequent" << ::std::endl
+     << "                             invocations instead of parsing these files again." << ::std::endl;
+
+  os << "--jobs|-j <num>              Compile up to <num> input files in parallel when" << ::std::endl
+     << "                             several input files are specified." << ::std::endl;
+
+  os << "--server <socket>            Run as a compiler server that accepts connections" << ::std::endl
+     << "                             on the UNIX domain socket <socket> or, if <socket>" << ::std::endl
+     << "                             is -, reads requests from stdin and writes" << ::std::endl
+     << "                             responses to stdout." << ::std::endl;
+
   os << "--output-dir|-o <dir>        Write the generated files to <dir> instead of the" << ::std::endl
      << "                             current directory." << ::std::endl;
 
@@ -1639,13 +1979,42 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
 
   os << "--generate-merge             Generate merge() functions." << ::std::endl;
 
+  os << "--lazy-defaults              Do not initialize members of options that have" << ::std::endl
+     << "                             non-fundamental types (for example, std::string or" << ::std::endl
+     << "                             containers) and default values in the options" << ::std::endl
+     << "                             class constructor." << ::std::endl;
+
   os << "--generate-description       Generate the option description list that can be" << ::std::endl
      << "                             examined at runtime." << ::std::endl;
 
+  os << "--generate-dynamic-options   Generate the cli::dynamic_options and" << ::std::endl
+     << "                             cli::dynamic_values classes that allow registering" << ::std::endl
+     << "                             options at runtime, for example, by plugins, and" << ::std::endl
+     << "                             parsing them into a compact value store." << ::std::endl;
+
+  os << "--generate-snapshot          Generate save() and load() functions that save the" << ::std::endl
+     << "                             options class instance, including the specifiers," << ::std::endl
+     << "                             into a compact binary snapshot and restore it from" << ::std::endl
+     << "                             such a snapshot." << ::std::endl;
+
+  os << "--generate-hash              Generate the equality and inequality operators as" << ::std::endl
+     << "                             well as the hash() function for options classes." << ::std::endl;
+
+  os << "--generate-argv              Generate the to_argv() and to_options_file()" << ::std::endl
+     << "                             functions for options classes." << ::std::endl;
+
+  os << "--generate-instrumentation   Generate the parse instrumentation hooks." << ::std::endl;
+
   os << "--generate-file-scanner      Generate the argv_file_scanner implementation." << ::std::endl;
 
+  os << "--generate-file-prefetch     Generate the argv_file_scanner support for reading" << ::std::endl
+     << "                             options files concurrently, ahead of the arguments" << ::std::endl
+     << "                             being scanned." << ::std::endl;
+
   os << "--generate-vector-scanner    Generate the vector_scanner implementation." << ::std::endl;
 
+  os << "--generate-string-scanner    Generate the string_scanner implementation." << ::std::endl;
+
   os << "--generate-group-scanner     Generate the group_scanner implementation." << ::std::endl;
 
   os << "--suppress-inline            Generate all functions non-inline." << ::std::endl;
@@ -1675,8 +2044,15 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
 
   os << "--generate-dep               Generate make dependency information." << ::std::endl;
 
+  os << "--generate-dep-only          Only generate the make dependency information (see" << ::std::endl
+     << "                             --generate-dep) without generating any other" << ::std::endl
+     << "                             files, similar to the C/C++ compiler -M option." << ::std::endl;
+
   os << "--stdout                     Write output to STDOUT instead of a file." << ::std::endl;
 
+  os << "--write-if-changed           Only write the generated files, including the" << ::std::endl
+     << "                             dependency file, if their contents have changed." << ::std::endl;
+
   os << "--suppress-undocumented      Suppress the generation of documentation entries" << ::std::endl
      << "                             for undocumented options." << ::std::endl;
 
@@ -1695,6 +2071,10 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
   os << "--option-length <len>        Indent option descriptions <len> characters when" << ::std::endl
      << "                             printing usage." << ::std::endl;
 
+  os << "--option-profile <file>      Optimize the option dispatch in the generated" << ::std::endl
+     << "                             parsing code based on the option frequency profile" << ::std::endl
+     << "                             in <file>." << ::std::endl;
+
   os << "--ascii-tree                 Convert UTF-8 tree(1) output to ASCII." << ::std::endl;
 
   os << "--ansi-color                 Use ANSI color escape sequences when printing" << ::std::endl
@@ -1848,6 +2228,10 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
      << "                             value into a single argument with the assignment" << ::std::endl
      << "                             sign (the option=value form)." << ::std::endl;
 
+  os << "--allow-abbreviations        Allow specifying an option using a unique prefix" << ::std::endl
+     << "                             of its name, for example, --verb instead of" << ::std::endl
+     << "                             --verbose." << ::std::endl;
+
   os << "--include-with-brackets      Use angle brackets (<>) instead of quotes (\"\") in" << ::std::endl
      << "                             the generated #include directives." << ::std::endl;
 
@@ -1891,6 +2275,18 @@ struct _cli_options_map_init
     _cli_options_map_["-I"] =
     &::cli::thunk< options, std::vector<std::string>, &options::include_path_,
       &options::include_path_specified_ >;
+    _cli_options_map_["--parse-cache"] =
+    &::cli::thunk< options, std::string, &options::parse_cache_,
+      &options::parse_cache_specified_ >;
+    _cli_options_map_["--jobs"] =
+    &::cli::thunk< options, std::size_t, &options::jobs_,
+      &options::jobs_specified_ >;
+    _cli_options_map_["-j"] =
+    &::cli::thunk< options, std::size_t, &options::jobs_,
+      &options::jobs_specified_ >;
+    _cli_options_map_["--server"] =
+    &::cli::thunk< options, std::string, &options::server_,
+      &options::server_specified_ >;
     _cli_options_map_["--output-dir"] =
     &::cli::thunk< options, std::string, &options::output_dir_,
       &options::output_dir_specified_ >;
@@ -1908,12 +2304,28 @@ struct _cli_options_map_init
     &::cli::thunk< options, &options::generate_parse_ >;
     _cli_options_map_["--generate-merge"] =
     &::cli::thunk< options, &options::generate_merge_ >;
+    _cli_options_map_["--lazy-defaults"] =
+    &::cli::thunk< options, &options::lazy_defaults_ >;
     _cli_options_map_["--generate-description"] =
     &::cli::thunk< options, &options::generate_description_ >;
+    _cli_options_map_["--generate-dynamic-options"] =
+    &::cli::thunk< options, &options::generate_dynamic_options_ >;
+    _cli_options_map_["--generate-snapshot"] =
+    &::cli::thunk< options, &options::generate_snapshot_ >;
+    _cli_options_map_["--generate-hash"] =
+    &::cli::thunk< options, &options::generate_hash_ >;
+    _cli_options_map_["--generate-argv"] =
+    &::cli::thunk< options, &options::generate_argv_ >;
+    _cli_options_map_["--generate-instrumentation"] =
+    &::cli::thunk< options, &options::generate_instrumentation_ >;
     _cli_options_map_["--generate-file-scanner"] =
     &::cli::thunk< options, &options::generate_file_scanner_ >;
+    _cli_options_map_["--generate-file-prefetch"] =
+    &::cli::thunk< options, &options::generate_file_prefetch_ >;
     _cli_options_map_["--generate-vector-scanner"] =
     &::cli::thunk< options, &options::generate_vector_scanner_ >;
+    _cli_options_map_["--generate-string-scanner"] =
+    &::cli::thunk< options, &options::generate_string_scanner_ >;
     _cli_options_map_["--generate-group-scanner"] =
     &::cli::thunk< options, &options::generate_group_scanner_ >;
     _cli_options_map_["--suppress-inline"] =
@@ -1939,8 +2351,12 @@ struct _cli_options_map_init
     &::cli::thunk< options, &options::generate_txt_ >;
     _cli_options_map_["--generate-dep"] =
     &::cli::thunk< options, &options::generate_dep_ >;
+    _cli_options_map_["--generate-dep-only"] =
+    &::cli::thunk< options, &options::generate_dep_only_ >;
     _cli_options_map_["--stdout"] =
     &::cli::thunk< options, &options::stdout__ >;
+    _cli_options_map_["--write-if-changed"] =
+    &::cli::thunk< options, &options::write_if_changed_ >;
     _cli_options_map_["--suppress-undocumented"] =
     &::cli::thunk< options, &options::suppress_undocumented_ >;
     _cli_options_map_["--suppress-usage"] =
@@ -1955,6 +2371,9 @@ struct _cli_options_map_init
     _cli_options_map_["--option-length"] =
     &::cli::thunk< options, std::size_t, &options::option_length_,
       &options::option_length_specified_ >;
+    _cli_options_map_["--option-profile"] =
+    &::cli::thunk< options, std::string, &options::option_profile_,
+      &options::option_profile_specified_ >;
     _cli_options_map_["--ascii-tree"] =
     &::cli::thunk< options, &options::ascii_tree_ >;
     _cli_options_map_["--ansi-color"] =
@@ -2099,6 +2518,8 @@ struct _cli_options_map_init
     &::cli::thunk< options, &options::no_combined_flags_ >;
     _cli_options_map_["--no-combined-values"] =
     &::cli::thunk< options, &options::no_combined_values_ >;
+    _cli_options_map_["--allow-abbreviations"] =
+    &::cli::thunk< options, &options::allow_abbreviations_ >;
     _cli_options_map_["--include-with-brackets"] =
     &::cli::thunk< options, &options::include_with_brackets_ >;
     _cli_options_map_["--include-prefix"] =
@@ -523,6 +523,51 @@ class options
   void
   include_path_specified (bool);
 
+  const std::string&
+  parse_cache () const;
+
+  std::string&
+  parse_cache ();
+
+  void
+  parse_cache (const std::string&);
+
+  bool
+  parse_cache_specified () const;
+
+  void
+  parse_cache_specified (bool);
+
+  const std::size_t&
+  jobs () const;
+
+  std::size_t&
+  jobs ();
+
+  void
+  jobs (const std::size_t&);
+
+  bool
+  jobs_specified () const;
+
+  void
+  jobs_specified (bool);
+
+  const std::string&
+  server () const;
+
+  std::string&
+  server ();
+
+  void
+  server (const std::string&);
+
+  bool
+  server_specified () const;
+
+  void
+  server_specified (bool);
+
   const std::string&
   output_dir () const;
 
@@ -589,6 +634,15 @@ class options
   void
   generate_merge (const bool&);
 
+  const bool&
+  lazy_defaults () const;
+
+  bool&
+  lazy_defaults ();
+
+  void
+  lazy_defaults (const bool&);
+
   const bool&
   generate_description () const;
 
@@ -598,6 +652,51 @@ class options
   void
   generate_description (const bool&);
 
+  const bool&
+  generate_dynamic_options () const;
+
+  bool&
+  generate_dynamic_options ();
+
+  void
+  generate_dynamic_options (const bool&);
+
+  const bool&
+  generate_snapshot () const;
+
+  bool&
+  generate_snapshot ();
+
+  void
+  generate_snapshot (const bool&);
+
+  const bool&
+  generate_hash () const;
+
+  bool&
+  generate_hash ();
+
+  void
+  generate_hash (const bool&);
+
+  const bool&
+  generate_argv () const;
+
+  bool&
+  generate_argv ();
+
+  void
+  generate_argv (const bool&);
+
+  const bool&
+  generate_instrumentation () const;
+
+  bool&
+  generate_instrumentation ();
+
+  void
+  generate_instrumentation (const bool&);
+
   const bool&
   generate_file_scanner () const;
 
@@ -607,6 +706,15 @@ class options
   void
   generate_file_scanner (const bool&);
 
+  const bool&
+  generate_file_prefetch () const;
+
+  bool&
+  generate_file_prefetch ();
+
+  void
+  generate_file_prefetch (const bool&);
+
   const bool&
   generate_vector_scanner () const;
 
@@ -616,6 +724,15 @@ class options
   void
   generate_vector_scanner (const bool&);
 
+  const bool&
+  generate_string_scanner () const;
+
+  bool&
+  generate_string_scanner ();
+
+  void
+  generate_string_scanner (const bool&);
+
   const bool&
   generate_group_scanner () const;
 
@@ -733,6 +850,15 @@ class options
   void
   generate_dep (const bool&);
 
+  const bool&
+  generate_dep_only () const;
+
+  bool&
+  generate_dep_only ();
+
+  void
+  generate_dep_only (const bool&);
+
   const bool&
   stdout_ () const;
 
@@ -742,6 +868,15 @@ class options
   void
   stdout_ (const bool&);
 
+  const bool&
+  write_if_changed () const;
+
+  bool&
+  write_if_changed ();
+
+  void
+  write_if_changed (const bool&);
+
   const bool&
   suppress_undocumented () const;
 
@@ -808,6 +943,21 @@ class options
   void
   option_length_specified (bool);
 
+  const std::string&
+  option_profile () const;
+
+  std::string&
+  option_profile ();
+
+  void
+  option_profile (const std::string&);
+
+  bool
+  option_profile_specified () const;
+
+  void
+  option_profile_specified (bool);
+
   const bool&
   ascii_tree () const;
 
@@ -1504,6 +1654,15 @@ class options
   void
   no_combined_values (const bool&);
 
+  const bool&
+  allow_abbreviations () const;
+
+  bool&
+  allow_abbreviations ();
+
+  void
+  allow_abbreviations (const bool&);
+
   const bool&
   include_with_brackets () const;
 
@@ -1598,6 +1757,12 @@ class options
   bool version_;
   std::vector<std::string> include_path_;
   bool include_path_specified_;
+  std::string parse_cache_;
+  bool parse_cache_specified_;
+  std::size_t jobs_;
+  bool jobs_specified_;
+  std::string server_;
+  bool server_specified_;
   std::string output_dir_;
   bool output_dir_specified_;
   cxx_version std_;
@@ -1606,9 +1771,17 @@ class options
   bool generate_specifier_;
   bool generate_parse_;
   bool generate_merge_;
+  bool lazy_defaults_;
   bool generate_description_;
+  bool generate_dynamic_options_;
+  bool generate_snapshot_;
+  bool generate_hash_;
+  bool generate_argv_;
+  bool generate_instrumentation_;
   bool generate_file_scanner_;
+  bool generate_file_prefetch_;
   bool generate_vector_scanner_;
+  bool generate_string_scanner_;
   bool generate_group_scanner_;
   bool suppress_inline_;
   bool suppress_cli_;
@@ -1623,7 +1796,9 @@ class options
   bool generate_html_;
   bool generate_txt_;
   bool generate_dep_;
+  bool generate_dep_only_;
   bool stdout__;
+  bool write_if_changed_;
   bool suppress_undocumented_;
   bool suppress_usage_;
   bool long_usage_;
@@ -1632,6 +1807,8 @@ class options
   bool page_usage_specified_;
   std::size_t option_length_;
   bool option_length_specified_;
+  std::string option_profile_;
+  bool option_profile_specified_;
   bool ascii_tree_;
   bool ansi_color_;
   bool exclude_base_;
@@ -1723,6 +1900,7 @@ class options
   bool keep_separator_;
   bool no_combined_flags_;
   bool no_combined_values_;
+  bool allow_abbreviations_;
   bool include_with_brackets_;
   std::string include_prefix_;
   bool include_prefix_specified_;
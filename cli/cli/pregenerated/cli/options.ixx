@@ -372,6 +372,96 @@ include_path_specified (bool x)
   this->include_path_specified_ = x;
 }
 
+inline const std::string& options::
+parse_cache () const
+{
+  return this->parse_cache_;
+}
+
+inline std::string& options::
+parse_cache ()
+{
+  return this->parse_cache_;
+}
+
+inline void options::
+parse_cache (const std::string& x)
+{
+  this->parse_cache_ = x;
+}
+
+inline bool options::
+parse_cache_specified () const
+{
+  return this->parse_cache_specified_;
+}
+
+inline void options::
+parse_cache_specified (bool x)
+{
+  this->parse_cache_specified_ = x;
+}
+
+inline const std::size_t& options::
+jobs () const
+{
+  return this->jobs_;
+}
+
+inline std::size_t& options::
+jobs ()
+{
+  return this->jobs_;
+}
+
+inline void options::
+jobs (const std::size_t& x)
+{
+  this->jobs_ = x;
+}
+
+inline bool options::
+jobs_specified () const
+{
+  return this->jobs_specified_;
+}
+
+inline void options::
+jobs_specified (bool x)
+{
+  this->jobs_specified_ = x;
+}
+
+inline const std::string& options::
+server () const
+{
+  return this->server_;
+}
+
+inline std::string& options::
+server ()
+{
+  return this->server_;
+}
+
+inline void options::
+server (const std::string& x)
+{
+  this->server_ = x;
+}
+
+inline bool options::
+server_specified () const
+{
+  return this->server_specified_;
+}
+
+inline void options::
+server_specified (bool x)
+{
+  this->server_specified_ = x;
+}
+
 inline const std::string& options::
 output_dir () const
 {
@@ -504,6 +594,24 @@ generate_merge (const bool& x)
   this->generate_merge_ = x;
 }
 
+inline const bool& options::
+lazy_defaults () const
+{
+  return this->lazy_defaults_;
+}
+
+inline bool& options::
+lazy_defaults ()
+{
+  return this->lazy_defaults_;
+}
+
+inline void options::
+lazy_defaults (const bool& x)
+{
+  this->lazy_defaults_ = x;
+}
+
 inline const bool& options::
 generate_description () const
 {
@@ -522,6 +630,96 @@ generate_description (const bool& x)
   this->generate_description_ = x;
 }
 
+inline const bool& options::
+generate_dynamic_options () const
+{
+  return this->generate_dynamic_options_;
+}
+
+inline bool& options::
+generate_dynamic_options ()
+{
+  return this->generate_dynamic_options_;
+}
+
+inline void options::
+generate_dynamic_options (const bool& x)
+{
+  this->generate_dynamic_options_ = x;
+}
+
+inline const bool& options::
+generate_snapshot () const
+{
+  return this->generate_snapshot_;
+}
+
+inline bool& options::
+generate_snapshot ()
+{
+  return this->generate_snapshot_;
+}
+
+inline void options::
+generate_snapshot (const bool& x)
+{
+  this->generate_snapshot_ = x;
+}
+
+inline const bool& options::
+generate_hash () const
+{
+  return this->generate_hash_;
+}
+
+inline bool& options::
+generate_hash ()
+{
+  return this->generate_hash_;
+}
+
+inline void options::
+generate_hash (const bool& x)
+{
+  this->generate_hash_ = x;
+}
+
+inline const bool& options::
+generate_argv () const
+{
+  return this->generate_argv_;
+}
+
+inline bool& options::
+generate_argv ()
+{
+  return this->generate_argv_;
+}
+
+inline void options::
+generate_argv (const bool& x)
+{
+  this->generate_argv_ = x;
+}
+
+inline const bool& options::
+generate_instrumentation () const
+{
+  return this->generate_instrumentation_;
+}
+
+inline bool& options::
+generate_instrumentation ()
+{
+  return this->generate_instrumentation_;
+}
+
+inline void options::
+generate_instrumentation (const bool& x)
+{
+  this->generate_instrumentation_ = x;
+}
+
 inline const bool& options::
 generate_file_scanner () const
 {
@@ -540,6 +738,24 @@ generate_file_scanner (const bool& x)
   this->generate_file_scanner_ = x;
 }
 
+inline const bool& options::
+generate_file_prefetch () const
+{
+  return this->generate_file_prefetch_;
+}
+
+inline bool& options::
+generate_file_prefetch ()
+{
+  return this->generate_file_prefetch_;
+}
+
+inline void options::
+generate_file_prefetch (const bool& x)
+{
+  this->generate_file_prefetch_ = x;
+}
+
 inline const bool& options::
 generate_vector_scanner () const
 {
@@ -558,6 +774,24 @@ generate_vector_scanner (const bool& x)
   this->generate_vector_scanner_ = x;
 }
 
+inline const bool& options::
+generate_string_scanner () const
+{
+  return this->generate_string_scanner_;
+}
+
+inline bool& options::
+generate_string_scanner ()
+{
+  return this->generate_string_scanner_;
+}
+
+inline void options::
+generate_string_scanner (const bool& x)
+{
+  this->generate_string_scanner_ = x;
+}
+
 inline const bool& options::
 generate_group_scanner () const
 {
@@ -792,6 +1026,24 @@ generate_dep (const bool& x)
   this->generate_dep_ = x;
 }
 
+inline const bool& options::
+generate_dep_only () const
+{
+  return this->generate_dep_only_;
+}
+
+inline bool& options::
+generate_dep_only ()
+{
+  return this->generate_dep_only_;
+}
+
+inline void options::
+generate_dep_only (const bool& x)
+{
+  this->generate_dep_only_ = x;
+}
+
 inline const bool& options::
 stdout_ () const
 {
@@ -810,6 +1062,24 @@ stdout_ (const bool& x)
   this->stdout__ = x;
 }
 
+inline const bool& options::
+write_if_changed () const
+{
+  return this->write_if_changed_;
+}
+
+inline bool& options::
+write_if_changed ()
+{
+  return this->write_if_changed_;
+}
+
+inline void options::
+write_if_changed (const bool& x)
+{
+  this->write_if_changed_ = x;
+}
+
 inline const bool& options::
 suppress_undocumented () const
 {
@@ -942,6 +1212,36 @@ option_length_specified (bool x)
   this->option_length_specified_ = x;
 }
 
+inline const std::string& options::
+option_profile () const
+{
+  return this->option_profile_;
+}
+
+inline std::string& options::
+option_profile ()
+{
+  return this->option_profile_;
+}
+
+inline void options::
+option_profile (const std::string& x)
+{
+  this->option_profile_ = x;
+}
+
+inline bool options::
+option_profile_specified () const
+{
+  return this->option_profile_specified_;
+}
+
+inline void options::
+option_profile_specified (bool x)
+{
+  this->option_profile_specified_ = x;
+}
+
 inline const bool& options::
 ascii_tree () const
 {
@@ -2334,6 +2634,24 @@ no_combined_values (const bool& x)
   this->no_combined_values_ = x;
 }
 
+inline const bool& options::
+allow_abbreviations () const
+{
+  return this->allow_abbreviations_;
+}
+
+inline bool& options::
+allow_abbreviations ()
+{
+  return this->allow_abbreviations_;
+}
+
+inline void options::
+allow_abbreviations (const bool& x)
+{
+  this->allow_abbreviations_ = x;
+}
+
 inline const bool& options::
 include_with_brackets () const
 {
@@ -2,26 +2,213 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#include <cctype> // toupper
+
 #include "runtime-header.hxx"
 
 using namespace std;
 
+// Sorted unique vector. Unlike std::set, the elements are stored
+// contiguously and a range of them is inserted with a single sort and
+// merge pass rather than with a tree insertion per element.
+//
+// Since this class template can be needed by several options files of
+// which only the one that includes no others contains the rest of the
+// runtime (see generate_runtime_header()), it is generated into each of
+// them that use it, guarded with a macro.
+//
+static void
+generate_flat_set (context& ctx)
+{
+  ostream& os (ctx.os);
+
+  // Derive the guard from the runtime namespace in case several runtimes
+  // end up in the same translation unit.
+  //
+  string g;
+  for (size_t i (ctx.cli.compare (0, 2, "::") == 0 ? 2 : 0);
+       i != ctx.cli.size ();
+       ++i)
+  {
+    char c (ctx.cli[i]);
+    g += c == ':' ? '_' : static_cast<char> (toupper (c));
+  }
+
+  g += "_FLAT_SET";
+
+  os << "#ifndef " << g << endl
+     << "#define " << g << endl
+     << endl;
+
+  ctx.ns_open (ctx.cli);
+
+  os << "template <typename X, typename C = std::less<X> >" << endl
+     << "class flat_set"
+     << "{"
+     << "public:" << endl
+     << "typedef X key_type;"
+     << "typedef X value_type;"
+     << "typedef C key_compare;"
+     << "typedef C value_compare;"
+     << "typedef typename std::vector<X>::size_type size_type;"
+     << "typedef typename std::vector<X>::const_iterator const_iterator;"
+     << "typedef const_iterator iterator;"
+     << endl
+     << "flat_set ()"
+     << "{"
+     << "}"
+     << "explicit" << endl
+     << "flat_set (const C& c): c_ (c)"
+     << "{"
+     << "}"
+     << "const_iterator" << endl
+     << "begin () const"
+     << "{"
+     << "return v_.begin ();"
+     << "}"
+     << "const_iterator" << endl
+     << "end () const"
+     << "{"
+     << "return v_.end ();"
+     << "}"
+     << "bool" << endl
+     << "empty () const"
+     << "{"
+     << "return v_.empty ();"
+     << "}"
+     << "size_type" << endl
+     << "size () const"
+     << "{"
+     << "return v_.size ();"
+     << "}"
+     << "const_iterator" << endl
+     << "lower_bound (const X& x) const"
+     << "{"
+     << "return std::lower_bound (v_.begin (), v_.end (), x, c_);"
+     << "}"
+     << "const_iterator" << endl
+     << "find (const X& x) const"
+     << "{"
+     << "const_iterator i (lower_bound (x));"
+     << "return i != v_.end () && !c_ (x, *i) ? i : v_.end ();"
+     << "}"
+     << "size_type" << endl
+     << "count (const X& x) const"
+     << "{"
+     << "return find (x) != v_.end () ? 1 : 0;"
+     << "}"
+     << "void" << endl
+     << "insert (const X& x)"
+     << "{"
+     << "typename std::vector<X>::iterator i (" << endl
+     << "std::lower_bound (v_.begin (), v_.end (), x, c_));"
+     << endl
+     << "if (i == v_.end () || c_ (x, *i))" << endl
+     << "v_.insert (i, x);"
+     << "}"
+     << "// Append the range, then sort it and merge it into the existing" << endl
+     << "// elements in a single pass." << endl
+     << "//" << endl
+     << "template <typename I>" << endl
+     << "void" << endl
+     << "insert (I b, I e)"
+     << "{"
+     << "size_type n (v_.size ());"
+     << "v_.insert (v_.end (), b, e);"
+     << endl
+     << "typename std::vector<X>::iterator vb (v_.begin ()), ve (v_.end ());"
+     << "typename std::vector<X>::iterator m (vb + n);"
+     << endl
+     << "std::stable_sort (m, ve, c_);"
+     << "std::inplace_merge (vb, m, ve, c_);"
+     << endl
+     << "// Both sort and merge are stable so the first of the equivalent" << endl
+     << "// elements is kept, the same as std::set::insert()." << endl
+     << "//" << endl
+     << "if (vb == ve)" << endl
+     << "return;"
+     << endl
+     << "typename std::vector<X>::iterator i (vb);"
+     << "for (typename std::vector<X>::iterator j (vb + 1); j != ve; ++j)" << endl
+     << "if (c_ (*i, *j) && ++i != j)" << endl
+     << "*i = *j;"
+     << endl
+     << "v_.erase (i + 1, ve);"
+     << "}"
+     << "void" << endl
+     << "reserve (size_type n)"
+     << "{"
+     << "v_.reserve (n);"
+     << "}"
+     << "void" << endl
+     << "clear ()"
+     << "{"
+     << "v_.clear ();"
+     << "}"
+     << "private:" << endl
+     << "std::vector<X> v_;"
+     << "C c_;"
+     << "};";
+
+  ctx.ns_close (ctx.cli);
+
+  os << "#endif // " << g << endl
+     << endl;
+}
+
 void
-generate_runtime_header (context& ctx)
+generate_runtime_header (context& ctx, bool complete)
 {
   ostream& os (ctx.os);
 
+  bool fset (has_option_type (ctx.unit, "flat_set"));
+
+  // If this options file includes another, then the runtime is generated
+  // there and we only need the templates for the types that we use.
+  //
+  if (!complete)
+  {
+    if (fset)
+    {
+      os << "#include <vector>" << endl
+         << "#include <algorithm>" << endl
+         << "#include <functional>" << endl
+         << endl;
+
+      generate_flat_set (ctx);
+    }
+
+    return;
+  }
+
   if (ctx.options.generate_file_scanner ())
     os << "#include <list>" << endl
        << "#include <deque>" << endl;
 
-  if (ctx.options.generate_description ())
+  if (ctx.options.generate_description ()     ||
+      ctx.options.generate_instrumentation () ||
+      ctx.options.generate_file_prefetch ())
     os << "#include <map>" << endl;
 
+  if (ctx.options.generate_file_prefetch ())
+    os << "#include <mutex>" << endl
+       << "#include <thread>" << endl
+       << "#include <condition_variable>" << endl;
+
   if (ctx.options.generate_description ()  ||
-      ctx.options.generate_vector_scanner ())
+      ctx.options.generate_vector_scanner () ||
+      ctx.options.generate_string_scanner () ||
+      ctx.options.generate_file_prefetch ()  ||
+      ctx.options.allow_abbreviations ()     ||
+      ctx.options.generate_snapshot ()       ||
+      ctx.options.generate_dynamic_options () ||
+      fset)
     os << "#include <vector>" << endl;
 
+  if (fset)
+    os << "#include <algorithm>" << endl
+       << "#include <functional>" << endl;
+
   os << "#include <iosfwd>" << endl
      << "#include <string>" << endl
      << "#include <cstddef>" << endl
@@ -229,7 +416,11 @@ generate_runtime_header (context& ctx)
        << "private:" << endl
        << "std::string file_;"
        << "};";
+  }
 
+  if (ctx.options.generate_file_scanner () ||
+      ctx.options.generate_string_scanner ())
+  {
     os << "class " << exp << "unmatched_quote: public exception"
        << "{"
        << "public:" << endl
@@ -252,6 +443,68 @@ generate_runtime_header (context& ctx)
        << "};";
   }
 
+  if (ctx.options.allow_abbreviations ())
+  {
+    os << "class " << exp << "ambiguous_option: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~ambiguous_option () throw ();"
+       << endl
+       << "ambiguous_option (const std::string& option," << endl
+       <<                   "const std::vector<std::string>& candidates);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "const std::vector<std::string>&" << endl
+       << "candidates () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "std::vector<std::string> candidates_;"
+       << "};";
+  }
+
+  if (ctx.options.generate_dynamic_options ())
+    os << "class " << exp << "duplicate_option: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~duplicate_option () throw ();"
+       << endl
+       << "duplicate_option (const std::string& option);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "};";
+
+  if (ctx.options.generate_snapshot ())
+    os << "class " << exp << "invalid_snapshot: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << "};";
+
   if (ctx.options.generate_group_scanner ())
   {
     os << "class " << exp << "unexpected_group: public exception"
@@ -428,6 +681,65 @@ generate_runtime_header (context& ctx)
        << "};";
   }
 
+  // string_scanner
+  //
+  if (ctx.options.generate_string_scanner ())
+  {
+    os << "// Scan the arguments in a command line string. Arguments are" << endl
+       << "// separated with whitespaces and are handled the same as the" << endl
+       << "// options file lines: the option is split from its value in the" << endl
+       << "// combined form (--name=value) and the value wrapped in single or" << endl
+       << "// double quotes is unquoted. Unlike in the options files, an" << endl
+       << "// unquoted value ends at the first whitespace and a quoted value" << endl
+       << "// at the closing quote followed by a whitespace, for example," << endl
+       << "// --name 'John Doe'. The string is tokenized lazily and in place" << endl
+       << "// with the returned arguments pointing into it." << endl
+       << "//" << endl
+       << "class " << exp << "string_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "// Tokenize the passed NUL-terminated string in place. The string" << endl
+       << "// is modified and should remain valid while the arguments are in" << endl
+       << "// use." << endl
+       << "//" << endl
+       << "string_scanner (char* s, std::size_t start_position = 0);"
+       << endl
+       << "// Tokenize a copy of the passed string made once on construction." << endl
+       << "//" << endl
+       << "string_scanner (const std::string& s, std::size_t start_position = 0);"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "virtual std::size_t" << endl
+       << "position ();"
+       << endl
+       << "private:" << endl
+       << "string_scanner (const string_scanner&);"
+       << "string_scanner& operator= (const string_scanner&);"
+       << endl
+       << "void" << endl
+       << "scan ();"
+       << endl
+       << "private:" << endl
+       << "std::size_t start_position_;"
+       << "std::size_t i_;"
+       << "std::vector<char> copy_;"
+       << "char* p_;   // Next character to scan." << endl
+       << "char* a_;   // Scanned argument or NULL." << endl
+       << "char* v_;   // Pending value of the combined option or NULL." << endl
+       << "};";
+  }
+
   // argv_file_scanner
   //
   if (ctx.options.generate_file_scanner ())
@@ -496,8 +808,21 @@ generate_runtime_header (context& ctx)
        << endl
        << "virtual std::size_t" << endl
        << "position ();"
-       << endl
-       << "// Return the file path if the peeked at argument came from a file and" << endl
+       << endl;
+
+    if (ctx.options.generate_file_prefetch ())
+      os << "~argv_file_scanner ();"
+         << endl
+         << "// Set the number of threads used to read options files ahead of" << endl
+         << "// the arguments being scanned (4 by default). Zero disables the" << endl
+         << "// prefetching and files are read as they are reached. Should be" << endl
+         << "// called before the first argument is examined." << endl
+         << "//" << endl
+         << "void" << endl
+         << "prefetch_threads (std::size_t);"
+         << endl;
+
+    os << "// Return the file path if the peeked at argument came from a file and" << endl
        << "// the empty string otherwise. The reference is guaranteed to be valid" << endl
        << "// till the end of the scanner lifetime." << endl
        << "//" << endl
@@ -516,8 +841,50 @@ generate_runtime_header (context& ctx)
        << endl
        << "void" << endl
        << "load (const std::string& file);"
-       << endl
-       << "typedef argv_scanner base;"
+       << endl;
+
+    if (ctx.options.generate_file_prefetch ())
+      os << "struct fetch_info"
+         << "{"
+         << "fetch_info (): started (false), done (false), ok (false) {}"
+         << endl
+         << "bool started;"
+         << "bool done;"
+         << "bool ok;"
+         << "std::string data;"
+         << "};"
+         << "// Read the file contents, returning false on failure. If the" << endl
+         << "// file is being prefetched, wait for it to be read." << endl
+         << "//" << endl
+         << "bool" << endl
+         << "fetch (const std::string& file, std::string& data);"
+         << endl
+         << "static bool" << endl
+         << "read (const std::string& file, std::string& data);"
+         << endl
+         << "// Collect the files referenced with the file options (that are" << endl
+         << "// not located with search_func) in the file contents." << endl
+         << "//" << endl
+         << "void" << endl
+         << "scan (const std::string& file," << endl
+         << "const std::string& data," << endl
+         << "std::vector<std::string>& refs) const;"
+         << endl
+         << "// The following functions should be called with mutex_ locked." << endl
+         << "//" << endl
+         << "fetch_info&" << endl
+         << "request (const std::string& file);"
+         << endl
+         << "void" << endl
+         << "prefetch (std::unique_lock<std::mutex>&," << endl
+         << "const std::string& file," << endl
+         << "fetch_info&);"
+         << endl
+         << "void" << endl
+         << "work ();"
+         << endl;
+
+    os << "typedef argv_scanner base;"
        << endl
        << "const std::string option_;"
        << "option_info option_info_;"
@@ -542,6 +909,18 @@ generate_runtime_header (context& ctx)
       os << endl
          << "bool skip_;";
 
+    if (ctx.options.generate_file_prefetch ())
+      os << endl
+         << "std::size_t prefetch_threads_;"
+         << "bool prefetched_; // Arguments scanned for files to prefetch." << endl
+         << "bool stop_;"
+         << "std::map<std::string, fetch_info> fetched_;"
+         << "std::deque<std::string> queue_;"
+         << "std::vector<std::thread> threads_;"
+         << "std::mutex mutex_;"
+         << "std::condition_variable work_cond_;"
+         << "std::condition_variable done_cond_;";
+
     os << endl
        << "static int zero_argc_;"
        << "static std::string empty_string_;"
@@ -681,6 +1060,383 @@ generate_runtime_header (context& ctx)
        << "};";
   }
 
+  // Dynamic options.
+  //
+  if (ctx.options.generate_dynamic_options ())
+  {
+    os << "// Value kinds of dynamic options." << endl
+       << "//" << endl
+       << "struct dynamic_kind"
+       << "{"
+       << "enum value"
+       << "{"
+       << "flag,    // bool"                     << endl
+       << "string,  // std::string"              << endl
+       << "integer, // dynamic_values::integer_type" << endl
+       << "real,    // double"                   << endl
+       << "strings  // std::vector<std::string>" << endl
+       << "};"
+       << "};";
+
+    os << "// Options registered at runtime, for example, by plugins. The" << endl
+       << "// option names are looked up with an open-addressing hash index." << endl
+       << "//" << endl
+       << "class " << exp << "dynamic_options"
+       << "{"
+       << "public:" << endl
+       << "typedef dynamic_kind::value kind_type;"
+       << endl
+       << "dynamic_options ();"
+       << endl
+       << "// Register the option and return its index. The default value, if" << endl
+       << "// any, is parsed as if it was specified on the command line (see" << endl
+       << "// dynamic_values). Throw duplicate_option if any of the option's" << endl
+       << "// names is already registered or reserved." << endl
+       << "//" << endl
+       << "std::size_t" << endl
+       << "add (const option&, kind_type);"
+       << endl
+       << "// Reserve the names of the options class (as returned by its" << endl
+       << "// description() function) so that they cannot be registered." << endl
+       << "//" << endl
+       << "void" << endl
+       << "reserve (const options&);"
+       << endl
+       << "std::size_t" << endl
+       << "size () const;"
+       << endl
+       << "const option&" << endl
+       << "operator[] (std::size_t) const;"
+       << endl
+       << "kind_type" << endl
+       << "kind (std::size_t) const;"
+       << endl
+       << "// Return the option index or size() if there is no such option." << endl
+       << "//" << endl
+       << "std::size_t" << endl
+       << "find (const char* name) const;"
+       << endl
+       << "private:" << endl
+       << "struct name_entry;"
+       << endl
+       << "const name_entry*" << endl
+       << "entry (const char* name) const;"
+       << endl
+       << "void" << endl
+       << "insert (const std::string& name, std::size_t option);"
+       << endl
+       << "private:" << endl
+       << "std::vector<option> options_;"
+       << "std::vector<kind_type> kinds_;"
+       << endl
+       << "// Option names (including aliases) with the index of the option" << endl
+       << "// or size_t(-1) for reserved names. The index table size is a" << endl
+       << "// power of two with each entry being the name index plus one or" << endl
+       << "// zero for an empty entry." << endl
+       << "//" << endl
+       << "struct name_entry"
+       << "{"
+       << "std::string name;"
+       << "std::size_t option;"
+       << "};"
+       << "std::vector<name_entry> names_;"
+       << "std::vector<std::size_t> index_;"
+       << "};";
+
+    os << "// Values of the dynamic options. Options registered after this" << endl
+       << "// object has been created are ignored by it (and are therefore" << endl
+       << "// treated as unknown when parsing)." << endl
+       << "//" << endl
+       << "class " << exp << "dynamic_values"
+       << "{"
+       << "public:" << endl
+       << "typedef " << (ctx.options.std () >= cxx_version::cxx11
+                         ? "long long"
+                         : "long") << " integer_type;"
+       << endl
+       << "// Initialize the values with the option defaults. Throw" << endl
+       << "// invalid_value if a default value is invalid." << endl
+       << "//" << endl
+       << "explicit" << endl
+       << "dynamic_values (const dynamic_options&);"
+       << endl
+       << "const dynamic_options&" << endl
+       << "options () const;"
+       << endl
+       << "// Value accessors. The option index must be valid and the" << endl
+       << "// accessor must match the option's value kind." << endl
+       << "//" << endl
+       << "bool" << endl
+       << "specified (std::size_t) const;"
+       << endl
+       << "bool" << endl
+       << "flag (std::size_t) const;"
+       << endl
+       << "const std::string&" << endl
+       << "string (std::size_t) const;"
+       << endl
+       << "integer_type" << endl
+       << "integer (std::size_t) const;"
+       << endl
+       << "double" << endl
+       << "real (std::size_t) const;"
+       << endl
+       << "const std::vector<std::string>&" << endl
+       << "strings (std::size_t) const;"
+       << endl
+       << "// Parse the dynamic options until the first argument that is not" << endl
+       << "// one. Return true if anything has been parsed. To parse them" << endl
+       << "// together with an options class, pass this object to its parsing" << endl
+       << "// constructor or parse() function." << endl
+       << "//" << endl
+       << "bool" << endl
+       << "parse (scanner&);"
+       << endl
+       << "// Implementation details." << endl
+       << "//" << endl
+       << "bool" << endl
+       << "_parse (const char*, scanner&);"
+       << endl
+       << "private:" << endl
+       << "void" << endl
+       << "parse (std::size_t, scanner&);"
+       << endl
+       << "private:" << endl
+       << "// Type-tagged value. The string and strings kinds store the index" << endl
+       << "// of the value in the strings_ and lists_ containers, respectively." << endl
+       << "//" << endl
+       << "struct value"
+       << "{"
+       << "unsigned char kind;"
+       << "bool specified;"
+       << "union"
+       << "{"
+       << "bool flag;"
+       << "integer_type integer;"
+       << "double real;"
+       << "std::size_t index;"
+       << "};"
+       << "};"
+       << "const dynamic_options& options_;"
+       << "std::vector<value> values_;"
+       << "std::vector<std::string> strings_;"
+       << "std::vector<std::vector<std::string> > lists_;"
+       << "};";
+  }
+
+  // Option abbreviations.
+  //
+  if (ctx.options.allow_abbreviations ())
+  {
+    os << "// Return the option name that the argument is a unique prefix of or" << endl
+       << "// the argument itself if there is no such name. The names array is" << endl
+       << "// sorted and the options array contains the index of the option" << endl
+       << "// that each name belongs to. Throw ambiguous_option if the argument" << endl
+       << "// is a prefix of several options' names." << endl
+       << "//" << endl
+       << exp << "const char*" << endl
+       << "find_abbreviation (const char* argument," << endl
+       << "const char* const* names," << endl
+       << "const std::size_t* options," << endl
+       << "std::size_t size);"
+       << endl;
+  }
+
+  // Parse instrumentation.
+  //
+  if (ctx.options.generate_instrumentation ())
+  {
+    string const& os_type (ctx.options.ostream_type ());
+
+    os << "// Parse observer. The generated parsing code only notifies the" << endl
+       << "// current observer if it was compiled with CLI_INSTRUMENT defined." << endl
+       << "//" << endl
+       << "class " << exp << "parse_observer"
+       << "{"
+       << "public:" << endl
+       << "typedef " << (ctx.options.std () >= cxx_version::cxx11
+                         ? "unsigned long long"
+                         : "unsigned long") << " tick_type;"
+       << endl
+       << "virtual" << endl
+       << "~parse_observer ();"
+       << endl
+       << "// Called after the option at the specified position and its value," << endl
+       << "// if any, have been parsed. The option name is as specified (that" << endl
+       << "// is, it can be an alias). The scanner is one of \"argv\", \"file\"" << endl
+       << "// (argument came from an options file), \"vector\", \"string\"," << endl
+       << "// \"group\", or \"other\". The ticks include the option lookup and" << endl
+       << "// value parsing." << endl
+       << "//" << endl
+       << "virtual void" << endl
+       << "parsed (const char* option," << endl
+       << "std::size_t position," << endl
+       << "const char* scanner," << endl
+       << "tick_type ticks) = 0;"
+       << endl
+       << "// The current observer or NULL if there is none. Note that it is" << endl
+       << "// shared by all the threads." << endl
+       << "//" << endl
+       << "static parse_observer* current;"
+       << endl
+       << "// Return the current time in ticks (nanoseconds if compiled as" << endl
+       << "// C++11 or later and std::clock() ticks otherwise)." << endl
+       << "//" << endl
+       << "static tick_type" << endl
+       << "ticks ();"
+       << endl
+       << "// Return the kind of the scanner for the peeked at argument." << endl
+       << "//" << endl
+       << "static const char*" << endl
+       << "kind (scanner&);"
+       << "};";
+
+    os << "// Parse observer that aggregates the option counts and ticks per" << endl
+       << "// option name and per scanner kind." << endl
+       << "//" << endl
+       << "class " << exp << "parse_statistics: public parse_observer"
+       << "{"
+       << "public:" << endl
+       << "struct entry"
+       << "{"
+       << "std::size_t count;"
+       << "tick_type ticks;"
+       << "};"
+       << "typedef std::map<std::string, entry> entries;"
+       << endl
+       << "const entries&" << endl
+       << "options () const;"
+       << endl
+       << "const entries&" << endl
+       << "scanners () const;"
+       << endl
+       << "// Print the statistics one entry per line in the" << endl
+       << "// '{option|scanner} <name> <count> <ticks>' form." << endl
+       << "//" << endl
+       << "void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual void" << endl
+       << "parsed (const char*, std::size_t, const char*, tick_type);"
+       << endl
+       << "private:" << endl
+       << "entries options_;"
+       << "entries scanners_;"
+       << "};";
+  }
+
+  // Argument sinks.
+  //
+  if (ctx.options.generate_argv ())
+  {
+    os << "// Receive the options (and their values) of an options class" << endl
+       << "// instance in the canonical form. The scratch string can be used" << endl
+       << "// to format values without reallocating it on every call." << endl
+       << "//" << endl
+       << "class " << exp << "argument_sink"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~argument_sink ();"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name) = 0;"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name, const std::string& value) = 0;"
+       << endl
+       << "std::string&" << endl
+       << "scratch ();"
+       << endl
+       << "private:" << endl
+       << "std::string scratch_;"
+       << "};";
+
+    os << "// Command line arguments in a single allocation that contains both" << endl
+       << "// the NULL-terminated argv array and the argument strings. The" << endl
+       << "// buffer is filled in two passes: the first only calculates the" << endl
+       << "// number of arguments and their total size while the second" << endl
+       << "// writes them into the allocated memory." << endl
+       << "//" << endl
+       << "class " << exp << "argv_buffer: public argument_sink"
+       << "{"
+       << "public:" << endl
+       << "argv_buffer ();"
+       << endl
+       << "~argv_buffer ();"
+       << endl
+       << "int" << endl
+       << "argc () const;"
+       << endl
+       << "char**" << endl
+       << "argv () const;"
+       << endl
+       << "// Implementation details." << endl
+       << "//" << endl
+       << "public:" << endl
+       << "void" << endl
+       << "start (const char* program);"
+       << endl
+       << "void" << endl
+       << "allocate ();"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name);"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name, const std::string& value);"
+       << endl
+       << "private:" << endl
+       << "argv_buffer (const argv_buffer&);"
+       << "argv_buffer& operator= (const argv_buffer&);"
+       << endl
+       << "void" << endl
+       << "add (const char*, std::size_t, const char* = 0, std::size_t = 0);"
+       << endl
+       << "private:" << endl
+       << "const char* program_;"
+       << "char** args_;"
+       << "std::size_t argc_;"
+       << "std::size_t size_;"
+       << "char* p_;"
+       << "bool write_;"
+       << "};";
+
+    os << "// Options file content appended to the string, one option per" << endl
+       << "// line. Filled in two passes similar to argv_buffer." << endl
+       << "//" << endl
+       << "class " << exp << "options_file_buffer: public argument_sink"
+       << "{"
+       << "public:" << endl
+       << "options_file_buffer (std::string&);"
+       << endl
+       << "void" << endl
+       << "allocate ();"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name);"
+       << endl
+       << "virtual void" << endl
+       << "option (const char* name, const std::string& value);"
+       << endl
+       << "private:" << endl
+       << "void" << endl
+       << "add (const char*, std::size_t, bool quote);"
+       << endl
+       << "private:" << endl
+       << "std::string& s_;"
+       << "std::size_t size_;"
+       << "bool write_;"
+       << "};";
+
+    os << "// Serializer class template. Provide a forward declaration to" << endl
+       << "// allow custom specializations." << endl
+       << "//" << endl
+       << "template <typename X>" << endl
+       << "struct serializer;"
+       << endl;
+  }
+
   // Parser class template. Provide a forward declaration to allow
   // custom specializations.
   //
@@ -688,5 +1444,26 @@ generate_runtime_header (context& ctx)
      << "struct parser;"
      << endl;
 
+  // Hasher class template. Provide a forward declaration to allow custom
+  // specializations.
+  //
+  if (ctx.options.generate_hash ())
+    os << "template <typename X>" << endl
+       << "struct hasher;"
+       << endl;
+
+  // Snapshot class template. Provide a forward declaration to allow custom
+  // specializations.
+  //
+  if (ctx.options.generate_snapshot ())
+    os << "typedef std::vector<char> snapshot_buffer;"
+       << endl
+       << "template <typename X>" << endl
+       << "struct snapshot;"
+       << endl;
+
   ctx.ns_close (ctx.cli);
+
+  if (fset)
+    generate_flat_set (ctx);
 }
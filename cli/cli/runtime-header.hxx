@@ -7,7 +7,11 @@
 
 #include "context.hxx"
 
+// If complete is false, then only generate the templates for the types
+// used by this options file (the rest of the runtime is generated for the
+// included options file).
+//
 void
-generate_runtime_header (context&);
+generate_runtime_header (context&, bool complete);
 
 #endif // CLI_RUNTIME_HEADER_HXX
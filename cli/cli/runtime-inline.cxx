@@ -156,7 +156,11 @@ generate_runtime_inline (context& ctx)
        << "{"
        << "return file_;"
        << "}";
+  }
 
+  if (ctx.options.generate_file_scanner () ||
+      ctx.options.generate_string_scanner ())
+  {
     // unmatched_option
     //
     os << "// unmatched_quote" << endl
@@ -175,6 +179,53 @@ generate_runtime_inline (context& ctx)
        << "}";
   }
 
+  if (ctx.options.allow_abbreviations ())
+  {
+    // ambiguous_option
+    //
+    os << "// ambiguous_option" << endl
+       << "//" << endl
+
+       << inl << "ambiguous_option::" << endl
+       << "ambiguous_option (const std::string& option," << endl
+       <<                   "const std::vector<std::string>& candidates)" << endl
+       << ": option_ (option), candidates_ (candidates)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& ambiguous_option::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}"
+
+       << inl << "const std::vector<std::string>& ambiguous_option::" << endl
+       << "candidates () const"
+       << "{"
+       << "return candidates_;"
+       << "}";
+  }
+
+  if (ctx.options.generate_dynamic_options ())
+  {
+    // duplicate_option
+    //
+    os << "// duplicate_option" << endl
+       << "//" << endl
+
+       << inl << "duplicate_option::" << endl
+       << "duplicate_option (const std::string& option)" << endl
+       << ": option_ (option)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& duplicate_option::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}";
+  }
+
   if (ctx.options.generate_group_scanner ())
   {
     // unexpected_group
@@ -293,11 +344,38 @@ generate_runtime_inline (context& ctx)
        << "}";
   }
 
+  // string_scanner
+  //
+  if (ctx.options.generate_string_scanner ())
+  {
+    os << "// string_scanner" << endl
+       << "//" << endl;
+
+    os << inl << "string_scanner::" << endl
+       << "string_scanner (char* s, std::size_t sp)" << endl
+       << ": start_position_ (sp), i_ (0), p_ (s), a_ (0), v_ (0)"
+       << "{"
+       << "}";
+
+    os << inl << "string_scanner::" << endl
+       << "string_scanner (const std::string& s, std::size_t sp)" << endl
+       << ": start_position_ (sp)," << endl
+       << "  i_ (0)," << endl
+       << "  copy_ (s.begin (), s.end ())," << endl
+       << "  a_ (0)," << endl
+       << "  v_ (0)"
+       << "{"
+       << "copy_.push_back ('\\0');"
+       << "p_ = &copy_[0];"
+       << "}";
+  }
+
   // argv_file_scanner
   //
   if (ctx.options.generate_file_scanner ())
   {
     bool sep (!ctx.opt_sep.empty ());
+    bool pf (ctx.options.generate_file_prefetch ());
 
     os << "// argv_file_scanner" << endl
        << "//" << endl;
@@ -316,6 +394,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "option_info_.option = option_.c_str ();"
        << "option_info_.search_func = 0;"
@@ -336,6 +419,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "option_info_.option = option_.c_str ();"
        << "option_info_.search_func = 0;"
@@ -353,6 +441,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "option_info_.option = option_.c_str ();"
        << "option_info_.search_func = 0;"
@@ -374,6 +467,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "}";
 
@@ -392,6 +490,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "}";
 
@@ -407,9 +510,21 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (pf)
+      os << "," << endl
+         << "  prefetch_threads_ (4)," << endl
+         << "  prefetched_ (false)," << endl
+         << "  stop_ (false)";
     os << "{"
        << "load (file);"
        << "}";
+
+    if (pf)
+      os << inl << "void argv_file_scanner::" << endl
+         << "prefetch_threads (std::size_t n)"
+         << "{"
+         << "prefetch_threads_ = n;"
+         << "}";
   }
 
   // group_scanner
@@ -473,6 +588,76 @@ generate_runtime_inline (context& ctx)
        << "}";
   }
 
+  // parse_statistics
+  //
+  if (ctx.options.generate_instrumentation ())
+  {
+    os << "// parse_statistics" << endl
+       << "//" << endl
+
+       << inl << "const parse_statistics::entries& parse_statistics::" << endl
+       << "options () const"
+       << "{"
+       << "return options_;"
+       << "}"
+
+       << inl << "const parse_statistics::entries& parse_statistics::" << endl
+       << "scanners () const"
+       << "{"
+       << "return scanners_;"
+       << "}";
+  }
+
+  // argument_sink, argv_buffer
+  //
+  if (ctx.options.generate_argv ())
+  {
+    os << "// argument_sink" << endl
+       << "//" << endl
+
+       << inl << "std::string& argument_sink::" << endl
+       << "scratch ()"
+       << "{"
+       << "return scratch_;"
+       << "}";
+
+    os << "// argv_buffer" << endl
+       << "//" << endl
+
+       << inl << "argv_buffer::" << endl
+       << "argv_buffer ()" << endl
+       << ": program_ (\"\"), args_ (0), argc_ (0), size_ (0), p_ (0), write_ (false)"
+       << "{"
+       << "}"
+
+       << inl << "argv_buffer::" << endl
+       << "~argv_buffer ()"
+       << "{"
+       << "delete[] args_;"
+       << "}"
+
+       << inl << "int argv_buffer::" << endl
+       << "argc () const"
+       << "{"
+       << "return static_cast<int> (argc_);"
+       << "}"
+
+       << inl << "char** argv_buffer::" << endl
+       << "argv () const"
+       << "{"
+       << "return args_;"
+       << "}";
+
+    os << "// options_file_buffer" << endl
+       << "//" << endl
+
+       << inl << "options_file_buffer::" << endl
+       << "options_file_buffer (std::string& s)" << endl
+       << ": s_ (s), size_ (0), write_ (false)"
+       << "{"
+       << "}";
+  }
+
   // Option description.
   //
   if (ctx.options.generate_description ())
@@ -527,5 +712,74 @@ generate_runtime_inline (context& ctx)
        << "}";
   }
 
+  // Dynamic options.
+  //
+  if (ctx.options.generate_dynamic_options ())
+  {
+    // dynamic_options
+    //
+    os << inl << "std::size_t dynamic_options::" << endl
+       << "size () const"
+       << "{"
+       << "return options_.size ();"
+       << "}";
+
+    os << inl << "const option& dynamic_options::" << endl
+       << "operator[] (std::size_t i) const"
+       << "{"
+       << "return options_[i];"
+       << "}";
+
+    os << inl << "dynamic_options::kind_type dynamic_options::" << endl
+       << "kind (std::size_t i) const"
+       << "{"
+       << "return kinds_[i];"
+       << "}";
+
+    // dynamic_values
+    //
+    os << inl << "const dynamic_options& dynamic_values::" << endl
+       << "options () const"
+       << "{"
+       << "return options_;"
+       << "}";
+
+    os << inl << "bool dynamic_values::" << endl
+       << "specified (std::size_t i) const"
+       << "{"
+       << "return values_[i].specified;"
+       << "}";
+
+    os << inl << "bool dynamic_values::" << endl
+       << "flag (std::size_t i) const"
+       << "{"
+       << "return values_[i].flag;"
+       << "}";
+
+    os << inl << "const std::string& dynamic_values::" << endl
+       << "string (std::size_t i) const"
+       << "{"
+       << "return strings_[values_[i].index];"
+       << "}";
+
+    os << inl << "dynamic_values::integer_type dynamic_values::" << endl
+       << "integer (std::size_t i) const"
+       << "{"
+       << "return values_[i].integer;"
+       << "}";
+
+    os << inl << "double dynamic_values::" << endl
+       << "real (std::size_t i) const"
+       << "{"
+       << "return values_[i].real;"
+       << "}";
+
+    os << inl << "const std::vector<std::string>& dynamic_values::" << endl
+       << "strings (std::size_t i) const"
+       << "{"
+       << "return lists_[values_[i].index];"
+       << "}";
+  }
+
   ctx.ns_close (ctx.cli);
 }
@@ -18,11 +18,40 @@ generate_runtime_source (context& ctx, bool complete)
      << "#include <utility>" << endl // pair
      << "#include <ostream>" << endl
      << "#include <sstream>" << endl
+     << "#include <limits>" << endl
+     << "#include <cerrno>" << endl
+     << "#include <cstdlib>" << endl // strtol(), strtod()
      << "#include <cstring>" << endl;
 
+  // Only include the hash-based containers if they are used by options.
+  //
+  bool uset (has_option_type (ctx.unit, "unordered_set"));
+  bool umap (has_option_type (ctx.unit, "unordered_map"));
+  bool fset (has_option_type (ctx.unit, "flat_set"));
+
+  if (uset)
+    os << "#include <unordered_set>" << endl;
+
+  if (umap)
+    os << "#include <unordered_map>" << endl;
+
   if (complete && ctx.options.generate_file_scanner ())
     os << "#include <fstream>" << endl;
 
+  if (complete && ctx.options.generate_file_prefetch ())
+    os << "#include <iterator>" << endl; // istreambuf_iterator
+
+  if (ctx.options.generate_argv ())
+    os << "#include <cstdio>" << endl; // sprintf()
+
+  if (complete && ctx.options.generate_instrumentation ())
+  {
+    if (ctx.options.std () >= cxx_version::cxx11)
+      os << "#include <chrono>" << endl;
+    else
+      os << "#include <ctime>" << endl;
+  }
+
   os << endl;
 
   ctx.ns_open (ctx.cli);
@@ -159,7 +188,11 @@ generate_runtime_source (context& ctx, bool complete)
          << "{"
          << "return \"unable to open file or read failure\";"
          << "}";
+    }
 
+    if (ctx.options.generate_file_scanner () ||
+        ctx.options.generate_string_scanner ())
+    {
       // unmatched_argument
       //
       os << "// unmatched_quote" << endl
@@ -183,6 +216,77 @@ generate_runtime_source (context& ctx, bool complete)
          << "}";
     }
 
+    if (ctx.options.allow_abbreviations ())
+    {
+      // ambiguous_option
+      //
+      os << "// ambiguous_option" << endl
+         << "//" << endl
+         << "ambiguous_option::" << endl
+         << "~ambiguous_option () throw ()"
+         << "{"
+         << "}"
+
+         << "void ambiguous_option::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"ambiguous option '\" << option ().c_str () << \"'\";"
+         << endl
+         << "for (std::size_t i (0); i != candidates_.size (); ++i)" << endl
+         << "os << (i == 0 ? \"; could be '\" : \", '\") << " <<
+        "candidates_[i].c_str () << \"'\";"
+         << "}"
+
+         << "const char* ambiguous_option::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"ambiguous option\";"
+         << "}";
+    }
+
+    if (ctx.options.generate_dynamic_options ())
+    {
+      // duplicate_option
+      //
+      os << "// duplicate_option" << endl
+         << "//" << endl
+         << "duplicate_option::" << endl
+         << "~duplicate_option () throw ()"
+         << "{"
+         << "}"
+
+         << "void duplicate_option::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"option '\" << option ().c_str () << \"' is already defined\";"
+         << "}"
+
+         << "const char* duplicate_option::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"duplicate option\";"
+         << "}";
+    }
+
+    if (ctx.options.generate_snapshot ())
+    {
+      // invalid_snapshot
+      //
+      os << "// invalid_snapshot" << endl
+         << "//" << endl
+         << "void invalid_snapshot::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << what ();"
+         << "}"
+
+         << "const char* invalid_snapshot::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"invalid options snapshot\";"
+         << "}";
+    }
+
     if (ctx.options.generate_group_scanner ())
     {
       // unexpected_group
@@ -372,6 +476,145 @@ generate_runtime_source (context& ctx, bool complete)
          << "}";
     }
 
+    // string_scanner
+    //
+    if (ctx.options.generate_string_scanner ())
+    {
+      const string& pfx (ctx.opt_prefix);
+      size_t pfx_n (pfx.size ());
+      bool comb_values (pfx_n != 0 && !ctx.options.no_combined_values ());
+
+      os << "// string_scanner" << endl
+         << "//" << endl
+
+         << "void string_scanner::" << endl
+         << "scan ()"
+         << "{"
+         << "char* p (p_);"
+         << endl
+         << "while (*p == ' ' || *p == '\\t' || *p == '\\r' || *p == '\\n')" << endl
+         << "++p;"
+         << endl
+         << "if (*p == '\\0')"
+         << "{"
+         << "p_ = p;"
+         << "return;"
+         << "}"
+         << "a_ = p;"
+         << "char* v (p);" // Value to unquote.
+         << endl;
+
+      // Split the option from its value in the combined form (--foo=bar),
+      // as for the options file lines.
+      //
+      if (comb_values)
+        os << "if (std::strncmp (p, \"" << pfx << "\", " << pfx_n <<
+          ") == 0)"
+           << "{"
+           << "for (char* e (p); *e != '\\0' && *e != ' ' && *e != '\\t' &&" << endl
+           << "*e != '\\r' && *e != '\\n'; ++e)"
+           << "{"
+           << "if (*e == '=')"
+           << "{"
+           << "*e = '\\0';"
+           << "v = v_ = e + 1;"
+           << "break;"
+           << "}"
+           << "}"
+           << "}";
+
+      os << "// As in the options files, if the value is wrapped in quotes," << endl
+         << "// then remove them. Additionally, the quoted value extends to" << endl
+         << "// the closing quote that is followed by a whitespace or the end" << endl
+         << "// of the string so that it can contain whitespaces. Quotes in" << endl
+         << "// other positions are part of the value." << endl
+         << "//" << endl
+         << "char* e (v);"
+         << "char q (*v);"
+         << endl
+         << "if (q == '\"' || q == '\\'')"
+         << "{"
+         << "for (++e; *e != '\\0'; ++e)"
+         << "{"
+         << "if (*e == q && (e[1] == '\\0' || e[1] == ' ' || e[1] == '\\t' ||" << endl
+         << "e[1] == '\\r' || e[1] == '\\n'))" << endl
+         << "break;"
+         << "}"
+         << "if (*e == '\\0')" << endl
+         << "throw unmatched_quote (v);"
+         << endl
+         << "*e++ = '\\0';"
+         << endl
+         << "if (v == a_)" << endl
+         << "a_ = v + 1;"
+         << "else" << endl
+         << "v_ = v + 1;"
+         << "}"
+         << "else"
+         << "{"
+         << "while (*e != '\\0' && *e != ' ' && *e != '\\t' && *e != '\\r' &&" << endl
+         << "*e != '\\n')" << endl
+         << "++e;"
+         << endl
+         << "if (e != v && (e[-1] == '\"' || e[-1] == '\\''))" << endl
+         << "throw unmatched_quote (std::string (v, e));"
+         << "}"
+         << "if (*e != '\\0')" << endl
+         << "*e++ = '\\0';"
+         << endl
+         << "p_ = e;"
+         << "}"
+
+         << "bool string_scanner::" << endl
+         << "more ()"
+         << "{"
+         << "if (a_ == 0)"
+         << "{"
+         << "if (v_ != 0)"
+         << "{"
+         << "a_ = v_;"
+         << "v_ = 0;"
+         << "}"
+         << "else" << endl
+         << "scan ();"
+         << "}"
+         << "return a_ != 0;"
+         << "}"
+
+         << "const char* string_scanner::" << endl
+         << "peek ()"
+         << "{"
+         << "if (!more ())" << endl
+         << "throw eos_reached ();"
+         << endl
+         << "return a_;"
+         << "}"
+
+         << "const char* string_scanner::" << endl
+         << "next ()"
+         << "{"
+         << "if (!more ())" << endl
+         << "throw eos_reached ();"
+         << endl
+         << "const char* r (a_);"
+         << "a_ = 0;"
+         << "++i_;"
+         << "return r;"
+         << "}"
+
+         << "void string_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "next ();"
+         << "}"
+
+         << "std::size_t string_scanner::" << endl
+         << "position ()"
+         << "{"
+         << "return start_position_ + i_;"
+         << "}";
+    }
+
     // argv_file_scanner
     //
     // Note that we continue incrementing start_position like argv_scanner.
@@ -379,6 +622,7 @@ generate_runtime_source (context& ctx, bool complete)
     if (ctx.options.generate_file_scanner ())
     {
       bool sep (!ctx.opt_sep.empty ());
+      bool pf (ctx.options.generate_file_prefetch ());
 
       const string& pfx (ctx.opt_prefix);
       size_t pfx_n (pfx.size ());
@@ -396,8 +640,59 @@ generate_runtime_source (context& ctx, bool complete)
          << "{"
          << "if (!args_.empty ())" << endl
          << "return true;"
-         << endl
-         << "while (base::more ())"
+         << endl;
+
+      // On the first call, start reading the files referenced from the
+      // command line in the background.
+      //
+      if (pf)
+      {
+        os << "if (!prefetched_)"
+           << "{"
+           << "prefetched_ = true;"
+           << endl
+           << "if (prefetch_threads_ != 0)"
+           << "{"
+           << "std::unique_lock<std::mutex> l (mutex_);"
+           << endl
+           << "for (int j (base::i_); j < argc_; ++j)"
+           << "{"
+           << "const char* a (argv_[j]);"
+           << "const option_info* oi;"
+           << "const char* ov (0);"
+           << endl;
+
+        if (sep)
+          os << "if (std::strcmp (a, \"" << ctx.opt_sep << "\") == 0)" << endl
+             << "break;"
+             << endl;
+
+        os << "if ((oi = find (a)) != 0)"
+           << "{"
+           << "if (j + 1 < argc_)" << endl
+           << "ov = argv_[++j];"
+           << "}";
+
+        if (comb_values)
+          os << "else if (std::strncmp (a, \"" << pfx << "\", " <<
+            pfx_n << ") == 0 &&" << endl
+             << "(ov = std::strchr (a, '=')) != 0)"
+             << "{"
+             << "std::string o (a, 0, ov - a);"
+             << "if ((oi = find (o.c_str ())) != 0)" << endl
+             << "++ov;"
+             << "else" << endl
+             << "ov = 0;"
+             << "}";
+
+        os << "if (ov != 0 && oi->search_func == 0)" << endl
+           << "request (ov);"
+           << "}"
+           << "}"
+           << "}";
+      }
+
+      os << "while (base::more ())"
          << "{"
          << "// See if the next argument is the file option." << endl
          << "//" << endl
@@ -549,13 +844,23 @@ generate_runtime_source (context& ctx, bool complete)
          << "load (const std::string& file)"
          << "{"
          << "using namespace std;"
-         << endl
-         << "ifstream is (file.c_str ());"
-         << endl
-         << "if (!is.is_open ())" << endl
-         << "throw file_io_failure (file);"
-         << endl
-         << "files_.push_back (file);"
+         << endl;
+
+      if (pf)
+        os << "string data;"
+           << "if (!fetch (file, data))" << endl
+           << "throw file_io_failure (file);"
+           << endl
+           << "istringstream is (data);"
+           << endl;
+      else
+        os << "ifstream is (file.c_str ());"
+           << endl
+           << "if (!is.is_open ())" << endl
+           << "throw file_io_failure (file);"
+           << endl;
+
+      os << "files_.push_back (file);"
          << endl
          << "arg a;"
          << "a.file = &*files_.rbegin ();"
@@ -712,6 +1017,246 @@ generate_runtime_source (context& ctx, bool complete)
          << "args_.push_back (a);"
          << "}" // while
          << "}";
+
+      // Options file prefetching.
+      //
+      // The files referenced from the files being read are discovered and
+      // read by the worker threads ahead of load() reaching them. Reading
+      // errors are recorded and only reported by load(), so that they are
+      // diagnosed in the same order and with the same exception as when
+      // reading the files sequentially.
+      //
+      if (pf)
+      {
+        os << "argv_file_scanner::" << endl
+           << "~argv_file_scanner ()"
+           << "{"
+           << "// Once stop_ is set no more threads are started (see" << endl
+           << "// request()) so we can join them without holding the lock." << endl
+           << "//" << endl
+           << "std::vector<std::thread> ts;"
+           << "{"
+           << "std::lock_guard<std::mutex> l (mutex_);"
+           << "stop_ = true;"
+           << "ts.swap (threads_);"
+           << "}"
+           << "work_cond_.notify_all ();"
+           << endl
+           << "for (std::size_t i (0); i != ts.size (); ++i)" << endl
+           << "ts[i].join ();"
+           << "}"
+
+           << "bool argv_file_scanner::" << endl
+           << "read (const std::string& file, std::string& data)"
+           << "{"
+           << "std::ifstream is (file.c_str ());"
+           << endl
+           << "if (!is.is_open ())" << endl
+           << "return false;"
+           << endl
+           << "data.assign (std::istreambuf_iterator<char> (is)," << endl
+           << "std::istreambuf_iterator<char> ());"
+           << "return !is.bad ();"
+           << "}"
+
+           << "bool argv_file_scanner::" << endl
+           << "fetch (const std::string& file, std::string& data)"
+           << "{"
+           << "if (prefetch_threads_ == 0)" << endl
+           << "return read (file, data);"
+           << endl
+           << "std::unique_lock<std::mutex> l (mutex_);"
+           << "fetch_info& f (request (file));"
+           << endl
+           << "// Rather than waiting for the workers to get to the file, read" << endl
+           << "// it ourselves." << endl
+           << "//" << endl
+           << "if (!f.started)" << endl
+           << "prefetch (l, file, f);"
+           << endl
+           << "while (!f.done)" << endl
+           << "done_cond_.wait (l);"
+           << endl
+           << "// The same file can be loaded several times so we drop the" << endl
+           << "// entry and it is read anew if requested again." << endl
+           << "//" << endl
+           << "bool r (f.ok);"
+           << "data.swap (f.data);"
+           << "fetched_.erase (file);"
+           << "return r;"
+           << "}"
+
+           << "argv_file_scanner::fetch_info& argv_file_scanner::" << endl
+           << "request (const std::string& file)"
+           << "{"
+           << "std::map<std::string, fetch_info>::iterator i (" << endl
+           << "fetched_.find (file));"
+           << endl
+           << "if (i == fetched_.end ())"
+           << "{"
+           << "i = fetched_.insert (std::make_pair (file, fetch_info ())).first;"
+           << endl
+           << "// The scanner is being destroyed (files referenced from the" << endl
+           << "// ones still being read by the workers end up here)." << endl
+           << "//" << endl
+           << "if (stop_)" << endl
+           << "return i->second;"
+           << endl
+           << "queue_.push_back (file);"
+           << endl
+           << "if (threads_.size () < prefetch_threads_)" << endl
+           << "threads_.push_back (" << endl
+           << "std::thread (&argv_file_scanner::work, this));"
+           << endl
+           << "work_cond_.notify_one ();"
+           << "}"
+           << "return i->second;"
+           << "}"
+
+           << "void argv_file_scanner::" << endl
+           << "prefetch (std::unique_lock<std::mutex>& l," << endl
+           << "const std::string& file," << endl
+           << "fetch_info& f)"
+           << "{"
+           << "f.started = true;"
+           << "l.unlock ();"
+           << endl
+           << "std::string data;"
+           << "std::vector<std::string> refs;"
+           << "bool ok;"
+           << endl
+           << "try"
+           << "{"
+           << "if ((ok = read (file, data)))" << endl
+           << "scan (file, data, refs);"
+           << "}"
+           << "catch (const std::exception&)"
+           << "{"
+           << "ok = false;"
+           << "}"
+           << "l.lock ();"
+           << endl
+           << "f.ok = ok;"
+           << "f.data.swap (data);"
+           << "f.done = true;"
+           << "done_cond_.notify_all ();"
+           << endl
+           << "for (std::size_t i (0); i != refs.size (); ++i)" << endl
+           << "request (refs[i]);"
+           << "}"
+
+           << "void argv_file_scanner::" << endl
+           << "work ()"
+           << "{"
+           << "std::unique_lock<std::mutex> l (mutex_);"
+           << endl
+           << "for (;;)"
+           << "{"
+           << "while (!stop_ && queue_.empty ())" << endl
+           << "work_cond_.wait (l);"
+           << endl
+           << "if (stop_)" << endl
+           << "break;"
+           << endl
+           << "std::string file;"
+           << "file.swap (queue_.front ());"
+           << "queue_.pop_front ();"
+           << endl
+           << "// Skip files that are already read or being read by load()." << endl
+           << "//" << endl
+           << "std::map<std::string, fetch_info>::iterator i (" << endl
+           << "fetched_.find (file));"
+           << endl
+           << "if (i != fetched_.end () && !i->second.started)" << endl
+           << "prefetch (l, i->first, i->second);"
+           << "}"
+           << "}";
+
+        // This is a lightweight version of the load() line parsing. Since
+        // it can run ahead of load(), the arguments separator is ignored and
+        // prefetching a file that is not loaded in the end is harmless.
+        //
+        os << "void argv_file_scanner::" << endl
+           << "scan (const std::string& file," << endl
+           << "const std::string& data," << endl
+           << "std::vector<std::string>& refs) const"
+           << "{"
+           << "using namespace std;"
+           << endl
+           << "for (string::size_type b (0), e; b < data.size (); b = e + 1)"
+           << "{"
+           << "if ((e = data.find ('\\n', b)) == string::npos)" << endl
+           << "e = data.size ();"
+           << endl
+           << "const char* f (data.c_str () + b);"
+           << "const char* l (data.c_str () + e);"
+           << endl
+           << "while (f < l && (*f == ' ' || *f == '\\t' || *f == '\\r'))" << endl
+           << "++f;"
+           << endl
+           << "while (l > f && (l[-1] == ' ' || l[-1] == '\\t' || l[-1] == '\\r'))" << endl
+           << "--l;"
+           << endl
+           << "if (f == l || *f == '#')" << endl
+           << "continue;"
+           << endl
+           << "string line (f, l - f);";
+
+        if (pfx_n != 0)
+          os << endl
+             << "if (line.compare (0, " << pfx_n << ", \"" << pfx << "\") != 0)" << endl
+             << "continue;"
+             << endl;
+
+        os << "string::size_type p (line.find (' '));";
+
+        if (comb_values)
+          os << endl
+             << "string::size_type q (line.find ('='));"
+             << "if (q != string::npos && q < p)" << endl
+             << "p = q;";
+
+        os << endl
+           << "if (p == string::npos)" << endl
+           << "continue;"
+           << endl
+           << "const option_info* oi (find (string (line, 0, p).c_str ()));"
+           << endl
+           << "if (oi == 0 || oi->search_func != 0)" << endl
+           << "continue;"
+           << endl
+           << "string::size_type n (line.size ());";
+
+        if (comb_values)
+          os << "if (line[p] == '=')" << endl
+             << "++p;"
+             << "else" << endl;
+
+        os << "for (++p; p < n && (line[p] == ' ' || line[p] == '\\t'); ++p) ;"
+           << endl
+           << "string s2 (line, p);"
+           << endl
+           << "n = s2.size ();"
+           << "if (n > 1 && (s2[0] == '\"' || s2[0] == '\\'') && s2[n - 1] == s2[0])" << endl
+           << "s2 = string (s2, 1, n - 2);"
+           << endl
+           << "if (s2.empty ())" << endl
+           << "continue;"
+           << endl
+           << "#ifndef _WIN32" << endl
+           << "p = file.find_last_of ('/');"
+           << "bool c (p != string::npos && s2[0] != '/');"
+           << "#else" << endl
+           << "p = file.find_last_of (\"/\\\\\");"
+           << "bool c (p != string::npos && s2[1] != ':');"
+           << "#endif" << endl
+           << "if (c)" << endl
+           << "s2.insert (0, file, 0, p + 1);"
+           << endl
+           << "refs.push_back (s2);"
+           << "}"
+           << "}";
+      }
     }
 
     // group_scanner
@@ -960,17 +1505,470 @@ generate_runtime_source (context& ctx, bool complete)
          << "map_[*i] = n;"
          << "}";
     }
-  }
-
-  // To reduce the number of standard headers we have to include in the
-  // generated header file, we always generate the following templates
-  // in the source file.
-  //
-  bool sp (ctx.gen_specifier);
-  bool gen_merge (ctx.gen_merge);
 
-  // parser class template & its specializations
-  //
+    // Dynamic options.
+    //
+    if (ctx.options.generate_dynamic_options ())
+    {
+      os << "// dynamic_options" << endl
+         << "//" << endl
+         << "static std::size_t" << endl
+         << "dynamic_hash (const char* s)"
+         << "{"
+         << "// FNV-1a." << endl
+         << "//" << endl
+         << "std::size_t h (2166136261UL);"
+         << "for (; *s != '\\0'; ++s)"
+         << "{"
+         << "h ^= static_cast<unsigned char> (*s);"
+         << "h *= 16777619UL;"
+         << "}"
+         << "return h;"
+         << "}"
+
+         << "dynamic_options::" << endl
+         << "dynamic_options ()"
+         << "{"
+         << "}"
+
+         << "const dynamic_options::name_entry* dynamic_options::" << endl
+         << "entry (const char* n) const"
+         << "{"
+         << "if (index_.empty ())" << endl
+         << "return 0;"
+         << endl
+         << "std::size_t m (index_.size () - 1);"
+         << "for (std::size_t h (dynamic_hash (n) & m);; h = (h + 1) & m)"
+         << "{"
+         << "std::size_t i (index_[h]);"
+         << endl
+         << "if (i == 0)" << endl
+         << "return 0;"
+         << endl
+         << "const name_entry& e (names_[i - 1]);"
+         << "if (std::strcmp (e.name.c_str (), n) == 0)" << endl
+         << "return &e;"
+         << "}"
+         << "}"
+
+         << "void dynamic_options::" << endl
+         << "insert (const std::string& n, std::size_t o)"
+         << "{"
+         << "name_entry e;"
+         << "e.name = n;"
+         << "e.option = o;"
+         << "names_.push_back (e);"
+         << endl
+         << "// Keep the index at most half full, rehashing all the names" << endl
+         << "// when it grows." << endl
+         << "//" << endl
+         << "std::size_t b (names_.size () - 1);"
+         << endl
+         << "if (names_.size () * 2 > index_.size ())"
+         << "{"
+         << "index_.assign (index_.empty () ? 16 : index_.size () * 2, 0);"
+         << "b = 0;"
+         << "}"
+         << "std::size_t m (index_.size () - 1);"
+         << "for (std::size_t i (b); i != names_.size (); ++i)"
+         << "{"
+         << "std::size_t h (dynamic_hash (names_[i].name.c_str ()) & m);"
+         << "for (; index_[h] != 0; h = (h + 1) & m) ;"
+         << "index_[h] = i + 1;"
+         << "}"
+         << "}"
+
+         << "std::size_t dynamic_options::" << endl
+         << "add (const option& o, kind_type k)"
+         << "{"
+         << "if (entry (o.name ().c_str ()) != 0)" << endl
+         << "throw duplicate_option (o.name ());"
+         << endl
+         << "for (option_names::const_iterator i (o.aliases ().begin ());" << endl
+         << "i != o.aliases ().end (); ++i)"
+         << "{"
+         << "if (entry (i->c_str ()) != 0)" << endl
+         << "throw duplicate_option (*i);"
+         << "}"
+         << "std::size_t r (options_.size ());"
+         << "options_.push_back (o);"
+         << "kinds_.push_back (k);"
+         << endl
+         << "insert (o.name (), r);"
+         << endl
+         << "for (option_names::const_iterator i (o.aliases ().begin ());" << endl
+         << "i != o.aliases ().end (); ++i)" << endl
+         << "insert (*i, r);"
+         << endl
+         << "return r;"
+         << "}"
+
+         << "void dynamic_options::" << endl
+         << "reserve (const options& d)"
+         << "{"
+         << "const std::size_t r (static_cast<std::size_t> (-1));"
+         << endl
+         << "for (options::const_iterator i (d.begin ()); i != d.end (); ++i)"
+         << "{"
+         << "option_names ns (i->aliases ());"
+         << "ns.push_back (i->name ());"
+         << endl
+         << "for (option_names::const_iterator j (ns.begin ());" << endl
+         << "j != ns.end (); ++j)"
+         << "{"
+         << "if (const name_entry* e = entry (j->c_str ()))"
+         << "{"
+         << "if (e->option != r)" << endl
+         << "throw duplicate_option (*j);"
+         << "}"
+         << "else" << endl
+         << "insert (*j, r);"
+         << "}"
+         << "}"
+         << "}"
+
+         << "std::size_t dynamic_options::" << endl
+         << "find (const char* n) const"
+         << "{"
+         << "const name_entry* e (entry (n));"
+         << "return e != 0 && e->option != static_cast<std::size_t> (-1)" << endl
+         << "? e->option" << endl
+         << ": options_.size ();"
+         << "}";
+    }
+
+    // Option abbreviations.
+    //
+    if (ctx.options.allow_abbreviations ())
+    {
+      os << "const char*" << endl
+         << "find_abbreviation (const char* a," << endl
+         << "const char* const* names," << endl
+         << "const std::size_t* options," << endl
+         << "std::size_t n)"
+         << "{"
+         << "// Narrow the [b, e) range down to the names that start with the" << endl
+         << "// first i characters of the argument. Since such names are sorted," << endl
+         << "// their i-th characters are sorted as well. Once a single name is" << endl
+         << "// left, the rest of the argument is compared directly." << endl
+         << "//" << endl
+         << "std::size_t b (0), e (n), i (0);"
+         << endl
+         << "for (; a[i] != '\\0' && e - b > 1; ++i)"
+         << "{"
+         << "unsigned char c (static_cast<unsigned char> (a[i]));"
+         << endl
+         << "for (std::size_t m (e - b); m != 0;)"
+         << "{"
+         << "std::size_t h (m / 2);"
+         << "if (static_cast<unsigned char> (names[b + h][i]) < c)"
+         << "{"
+         << "b += h + 1;"
+         << "m -= h + 1;"
+         << "}"
+         << "else" << endl
+         << "m = h;"
+         << "}"
+         << "std::size_t p (b);"
+         << "for (std::size_t m (e - b); m != 0;)"
+         << "{"
+         << "std::size_t h (m / 2);"
+         << "if (static_cast<unsigned char> (names[p + h][i]) <= c)"
+         << "{"
+         << "p += h + 1;"
+         << "m -= h + 1;"
+         << "}"
+         << "else" << endl
+         << "m = h;"
+         << "}"
+         << "e = p;"
+         << "}"
+         << "if (b == e)" << endl
+         << "return a;"
+         << endl
+         << "if (e - b == 1)" << endl
+         << "return std::strncmp (names[b] + i, a + i, std::strlen (a + i)) == 0" << endl
+         << "? names[b]" << endl
+         << ": a;"
+         << endl
+         << "// Unless this is an exact match (which sorts first), all the" << endl
+         << "// remaining names should belong to the same option." << endl
+         << "//" << endl
+         << "if (names[b][i] != '\\0')"
+         << "{"
+         << "for (std::size_t p (b + 1); p != e; ++p)"
+         << "{"
+         << "if (options[p] != options[b])"
+         << "{"
+         << "std::vector<std::string> c (names + b, names + e);"
+         << "throw ambiguous_option (a, c);"
+         << "}"
+         << "}"
+         << "}"
+         << "return names[b];"
+         << "}";
+    }
+
+    if (ctx.options.generate_instrumentation ())
+    {
+      // parse_observer
+      //
+      os << "// parse_observer" << endl
+         << "//" << endl
+         << "parse_observer* parse_observer::current = 0;"
+         << endl
+         << "parse_observer::" << endl
+         << "~parse_observer ()"
+         << "{"
+         << "}"
+
+         << "parse_observer::tick_type parse_observer::" << endl
+         << "ticks ()"
+         << "{";
+
+      if (ctx.options.std () >= cxx_version::cxx11)
+        os << "using namespace std::chrono;"
+           << "return static_cast<tick_type> (" << endl
+           << "duration_cast<nanoseconds> (" << endl
+           << "steady_clock::now ().time_since_epoch ()).count ());";
+      else
+        os << "return static_cast<tick_type> (std::clock ());";
+
+      os << "}"
+
+         << "const char* parse_observer::" << endl
+         << "kind (scanner& s)"
+         << "{";
+
+      if (ctx.options.generate_file_scanner ())
+        os << "if (argv_file_scanner* fs = dynamic_cast<argv_file_scanner*> (&s))" << endl
+           << "return fs->peek_file ().empty () ? \"argv\" : \"file\";"
+           << endl;
+
+      os << "if (dynamic_cast<argv_scanner*> (&s) != 0)" << endl
+         << "return \"argv\";"
+         << endl;
+
+      if (ctx.options.generate_vector_scanner ())
+        os << "if (dynamic_cast<vector_scanner*> (&s) != 0)" << endl
+           << "return \"vector\";"
+           << endl;
+
+      if (ctx.options.generate_string_scanner ())
+        os << "if (dynamic_cast<string_scanner*> (&s) != 0)" << endl
+           << "return \"string\";"
+           << endl;
+
+      if (ctx.options.generate_group_scanner ())
+        os << "if (dynamic_cast<group_scanner*> (&s) != 0)" << endl
+           << "return \"group\";"
+           << endl;
+
+      os << "return \"other\";"
+         << "}";
+
+      // parse_statistics
+      //
+      os << "// parse_statistics" << endl
+         << "//" << endl
+         << "void parse_statistics::" << endl
+         << "parsed (const char* o, std::size_t, const char* s, tick_type t)"
+         << "{"
+         << "entry z = {0, 0};"
+         << "entry& oe (options_.insert (entries::value_type (o, z)).first->second);"
+         << "oe.count++;"
+         << "oe.ticks += t;"
+         << endl
+         << "entry& se (scanners_.insert (entries::value_type (s, z)).first->second);"
+         << "se.count++;"
+         << "se.ticks += t;"
+         << "}"
+
+         << "void parse_statistics::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "for (entries::const_iterator i (options_.begin ());" << endl
+         << "i != options_.end (); ++i)" << endl
+         << "os << \"option \" << i->first.c_str () << ' ' << i->second.count <<" << endl
+         << "' ' << i->second.ticks << '\\n';"
+         << endl
+         << "for (entries::const_iterator i (scanners_.begin ());" << endl
+         << "i != scanners_.end (); ++i)" << endl
+         << "os << \"scanner \" << i->first.c_str () << ' ' << i->second.count <<" << endl
+         << "' ' << i->second.ticks << '\\n';"
+         << "}";
+    }
+
+    if (ctx.options.generate_argv ())
+    {
+      const string& pfx (ctx.opt_prefix);
+      size_t pfx_n (pfx.size ());
+      bool comb_values (pfx_n != 0 && !ctx.options.no_combined_values ());
+
+      // argument_sink
+      //
+      os << "// argument_sink" << endl
+         << "//" << endl
+         << "argument_sink::" << endl
+         << "~argument_sink ()"
+         << "{"
+         << "}";
+
+      // argv_buffer
+      //
+      os << "// argv_buffer" << endl
+         << "//" << endl
+         << "void argv_buffer::" << endl
+         << "start (const char* program)"
+         << "{"
+         << "delete[] args_;"
+         << "args_ = 0;"
+         << "argc_ = 0;"
+         << "size_ = 0;"
+         << "write_ = false;"
+         << "program_ = program;"
+         << "add (program, std::strlen (program));"
+         << "}"
+
+         << "void argv_buffer::" << endl
+         << "allocate ()"
+         << "{"
+         << "// The argv array (including the terminating NULL) is followed" << endl
+         << "// by the strings. The program name is not written by the" << endl
+         << "// second pass so we add it here." << endl
+         << "//" << endl
+         << "std::size_t n (argc_ + 1);"
+         << "args_ = new char*[n + (size_ + sizeof (char*) - 1) / sizeof (char*)];"
+         << "args_[argc_] = 0;"
+         << endl
+         << "argc_ = 0;"
+         << "p_ = reinterpret_cast<char*> (args_ + n);"
+         << "write_ = true;"
+         << endl
+         << "add (program_, std::strlen (program_));"
+         << "}"
+
+         << "void argv_buffer::" << endl
+         << "add (const char* a, std::size_t an, const char* b, std::size_t bn)"
+         << "{"
+         << "if (write_)"
+         << "{"
+         << "args_[argc_] = p_;"
+         << "std::memcpy (p_, a, an);"
+         << "p_ += an;"
+         << endl
+         << "if (b != 0)"
+         << "{"
+         << "*p_++ = '=';"
+         << "std::memcpy (p_, b, bn);"
+         << "p_ += bn;"
+         << "}"
+         << "*p_++ = '\\0';"
+         << "}"
+         << "else" << endl
+         << "size_ += an + (b != 0 ? bn + 1 : 0) + 1;"
+         << endl
+         << "argc_++;"
+         << "}"
+
+         << "void argv_buffer::" << endl
+         << "option (const char* n)"
+         << "{"
+         << "add (n, std::strlen (n));"
+         << "}"
+
+         << "void argv_buffer::" << endl
+         << "option (const char* n, const std::string& v)"
+         << "{";
+
+      // Use the combined option=value form if it is supported.
+      //
+      if (comb_values)
+        os << "if (std::strncmp (n, \"" << pfx << "\", " << pfx_n << ") == 0)"
+           << "{"
+           << "add (n, std::strlen (n), v.c_str (), v.size ());"
+           << "return;"
+           << "}";
+
+      os << "add (n, std::strlen (n));"
+         << "add (v.c_str (), v.size ());"
+         << "}";
+
+      // options_file_buffer
+      //
+      os << "// options_file_buffer" << endl
+         << "//" << endl
+         << "void options_file_buffer::" << endl
+         << "allocate ()"
+         << "{"
+         << "s_.reserve (s_.size () + size_);"
+         << "write_ = true;"
+         << "}"
+
+         << "void options_file_buffer::" << endl
+         << "add (const char* s, std::size_t n, bool q)"
+         << "{"
+         << "if (write_)"
+         << "{"
+         << "if (q)" << endl
+         << "s_ += '\"';"
+         << "s_.append (s, n);"
+         << "if (q)" << endl
+         << "s_ += '\"';"
+         << "}"
+         << "else" << endl
+         << "size_ += n + (q ? 2 : 0);"
+         << "}"
+
+         << "void options_file_buffer::" << endl
+         << "option (const char* n)"
+         << "{"
+         << "add (n, std::strlen (n), false);"
+         << "add (\"\\n\", 1, false);"
+         << "}"
+
+         << "void options_file_buffer::" << endl
+         << "option (const char* n, const std::string& v)"
+         << "{"
+         << "// Quote the value if it would otherwise be trimmed, ignored," << endl
+         << "// or unquoted by the options file scanner." << endl
+         << "//" << endl
+         << "std::size_t vn (v.size ());"
+         << "char f (vn != 0 ? v[0] : ' '), l (vn != 0 ? v[vn - 1] : ' ');"
+         << "bool q (f == ' ' || f == '\\t' || f == '\\r' || f == '\"' || f == '\\'' ||" << endl
+         << "l == ' ' || l == '\\t' || l == '\\r' || l == '\"' || l == '\\'');"
+         << endl
+         << "add (n, std::strlen (n), false);";
+
+      // Only lines that start with the option prefix are split into the
+      // option and value. Otherwise, the value goes on a separate line in
+      // which case we always quote it so that it is not interpreted as an
+      // option, comment, etc.
+      //
+      if (pfx_n != 0)
+        os << "if (std::strncmp (n, \"" << pfx << "\", " << pfx_n << ") != 0)"
+           << "{"
+           << "add (\"\\n\", 1, false);"
+           << "q = true;"
+           << "}"
+           << "else" << endl;
+
+      os << "add (\" \", 1, false);"
+         << "add (v.c_str (), vn, q);"
+         << "add (\"\\n\", 1, false);"
+         << "}";
+    }
+  }
+
+  // To reduce the number of standard headers we have to include in the
+  // generated header file, we always generate the following templates
+  // in the source file.
+  //
+  bool sp (ctx.gen_specifier);
+  bool gen_merge (ctx.gen_merge);
+
+  // parser class template & its specializations
+  //
   os << "template <typename X>" << endl
      << "struct parser"
      << "{";
@@ -1153,71 +2151,406 @@ generate_runtime_source (context& ctx, bool complete)
 
   os << "};";
 
-  // parser<std::map<K,V,C>>
+  // Value slice parser. Parses the [b, e) slice of an argument as a value
+  // of option o that was found at position pos. For strings and arithmetic
+  // types (see below) this avoids constructing temporary strings and
+  // scanners. Otherwise, the slice is passed to the general parser via the
+  // argv scanner, copying it only if it is not NUL-terminated.
   //
-  os << "template <typename K, typename V, typename C>" << endl
-     << "struct parser<std::map<K, V, C> >"
-     << "{";
+  os << "template <typename X>" << endl
+     << "struct value_parser"
+     << "{"
+     <<   "static void" << endl
+     <<   "parse (X& x, const char* o," << endl
+     <<          "const char* b, const char* e," << endl
+     <<          "std::size_t pos)"
+     <<   "{"
+     <<     "std::string v;"
+     <<     "if (*e != '\\0')"
+     <<     "{"
+     <<       "v.assign (b, e);"
+     <<       "b = v.c_str ();"
+     <<     "}"
+     <<     "int ac (2);"
+     <<     "char* av[] ="
+     <<     "{"
+     <<     "const_cast<char*> (o)," << endl
+     <<     "const_cast<char*> (b)"
+     <<     "};"
+     <<     "argv_scanner s (0, ac, av, false, pos);";
+  if (sp)
+    os <<   "bool dummy;";
+  os <<     "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);"
+     <<   "}"
+     << "};";
 
-  os <<   "static void" << endl
-     <<   "parse (std::map<K, V, C>& m, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+  os << "template <>" << endl
+     << "struct value_parser<std::string>"
+     << "{"
+     <<   "static void" << endl
+     <<   "parse (std::string& x, const char*," << endl
+     <<          "const char* b, const char* e," << endl
+     <<          "std::size_t)"
      <<   "{"
-     <<     "const char* o (s.next ());"
-     <<                                                                    endl
-     <<     "if (s.more ())"
+     <<     "x.assign (b, e);"
+     <<   "}"
+     << "};";
+
+  // Arithmetic value slice parsers. The values accepted and rejected are
+  // the same as with the istream-based general parser: leading whitespaces
+  // are skipped, the value must be decimal and consumed completely, and it
+  // must fit into the type. As with istream, a negative value for an
+  // unsigned type is accepted if its magnitude fits and is negated.
+  //
+  // The strto*() functions need a NUL-terminated string so we copy the
+  // slice if it is not, normally into a buffer on the stack.
+  //
+  os << "class value_slice"
+     << "{"
+     << "public:" << endl
+     <<   "value_slice (const char* b, const char* e)" << endl
+     <<       ": p_ (b)"
+     <<   "{"
+     <<     "if (*e != '\\0')"
      <<     "{"
-     <<       "std::size_t pos (s.position ());"
-     <<       "std::string ov (s.next ());"
-     <<       "std::string::size_type p = ov.find ('=');"
-     <<                                                                    endl
-     <<       "K k = K ();"
-     <<       "V v = V ();"
-     <<       "std::string kstr (ov, 0, p);"
-     <<       "std::string vstr (ov, (p != std::string::npos ? p + 1 : ov.size ()));"
+     <<       "std::size_t n (e - b);"
      <<                                                                    endl
-     <<       "int ac (2);"
-     <<       "char* av[] ="
+     <<       "if (n < sizeof (b_))"
      <<       "{"
-     <<       "const_cast<char*> (o)," << endl
-     <<       "0"
-     <<       "};";
-  if (sp)
-    os <<     "bool dummy;";
-  os <<       "if (!kstr.empty ())"
-     <<       "{"
-     <<         "av[1] = const_cast<char*> (kstr.c_str ());"
-     <<         "argv_scanner s (0, ac, av, false, pos);"
-     <<         "parser<K>::parse (k, " << (sp ? "dummy, " : "") << "s);"
+     <<         "std::memcpy (b_, b, n);"
+     <<         "b_[n] = '\\0';"
+     <<         "p_ = b_;"
      <<       "}"
-     <<       "if (!vstr.empty ())"
+     <<       "else"
      <<       "{"
-     <<         "av[1] = const_cast<char*> (vstr.c_str ());"
-     <<         "argv_scanner s (0, ac, av, false, pos);"
-     <<         "parser<V>::parse (v, " << (sp ? "dummy, " : "") << "s);"
+     <<         "s_.assign (b, e);"
+     <<         "p_ = s_.c_str ();"
      <<       "}"
-     <<       "m[k] = v;"
      <<     "}"
-     <<     "else" << endl
-     <<       "throw missing_value (o);";
-  if (sp)
-    os << endl
-       <<   "xs = true;";
-  os <<   "}";
-
-  if (gen_merge)
-    os << "static void" << endl
-       << "merge (std::map<K, V, C>& b, const std::map<K, V, C>& a)"
-       << "{"
-       <<   "for (typename std::map<K, V, C>::const_iterator i (a.begin ()); " << endl
-       <<         "i != a.end (); "                                            << endl
-       <<         "++i)"                                                       << endl
-       <<     "b[i->first] = i->second;"
-       << "}";
+     <<   "}"
+     <<                                                                    endl
+     <<   "const char*" << endl
+     <<   "c_str () const {return p_;}"
+     <<                                                                    endl
+     << "private:" << endl
+     <<   "value_slice (const value_slice&);"
+     <<   "value_slice& operator= (const value_slice&);"
+     <<                                                                    endl
+     << "private:" << endl
+     <<   "const char* p_;"
+     <<   "char b_[64];"
+     <<   "std::string s_;"
+     << "};";
 
-  os << "};";
+  bool ll (ctx.options.std () >= cxx_version::cxx11); // strtoll(), strtoull()
 
-  // Parser thunk.
-  //
+  os << "template <typename X, typename T, T (*f) (const char*, char**, int)>" << endl
+     << "struct value_parser_signed"
+     << "{"
+     <<   "static void" << endl
+     <<   "parse (X& x, const char* o," << endl
+     <<          "const char* b, const char* e," << endl
+     <<          "std::size_t)"
+     <<   "{"
+     <<     "value_slice v (b, e);"
+     <<     "const char* p (v.c_str ());"
+     <<     "char* pe;"
+     <<                                                                    endl
+     <<     "errno = 0;"
+     <<     "T r (f (p, &pe, 10));"
+     <<                                                                    endl
+     <<     "if (pe == p || *pe != '\\0' || errno == ERANGE ||" << endl
+     <<         "r < std::numeric_limits<X>::min () ||" << endl
+     <<         "r > std::numeric_limits<X>::max ())" << endl
+     <<       "throw invalid_value (o, std::string (b, e));"
+     <<                                                                    endl
+     <<     "x = static_cast<X> (r);"
+     <<   "}"
+     << "};";
+
+  os << "template <typename X, typename T, T (*f) (const char*, char**, int)>" << endl
+     << "struct value_parser_unsigned"
+     << "{"
+     <<   "static void" << endl
+     <<   "parse (X& x, const char* o," << endl
+     <<          "const char* b, const char* e," << endl
+     <<          "std::size_t)"
+     <<   "{"
+     <<     "value_slice v (b, e);"
+     <<     "const char* p (v.c_str ());"
+     <<     "char* pe;"
+     <<                                                                    endl
+     <<     "errno = 0;"
+     <<     "T r (f (p, &pe, 10));"
+     <<                                                                    endl
+     <<     "// If the whole value is consumed, then '-' can only be its sign." << endl
+     <<     "//" << endl
+     <<     "if (pe == p || *pe != '\\0' || errno == ERANGE ||" << endl
+     <<         "(std::strchr (p, '-') != 0 ? 0 - r : r) >" << endl
+     <<         "std::numeric_limits<X>::max ())" << endl
+     <<       "throw invalid_value (o, std::string (b, e));"
+     <<                                                                    endl
+     <<     "x = static_cast<X> (r);"
+     <<   "}"
+     << "};";
+
+  os << "template <typename X>" << endl
+     << "struct value_parser_float"
+     << "{"
+     <<   "static void" << endl
+     <<   "parse (X& x, const char* o," << endl
+     <<          "const char* b, const char* e," << endl
+     <<          "std::size_t)"
+     <<   "{"
+     <<     "value_slice v (b, e);"
+     <<     "const char* p (v.c_str ());"
+     <<     "char* pe;"
+     <<                                                                    endl
+     <<     "// Unlike istream, strtod() also accepts hexadecimal values as" << endl
+     <<     "// well as infinity and NaN." << endl
+     <<     "//" << endl
+     <<     "double r (std::strtod (p, &pe));"
+     <<                                                                    endl
+     <<     "if (pe == p || *pe != '\\0' || std::strpbrk (p, \"xXnN\") != 0 ||" << endl
+     <<         "r < -std::numeric_limits<X>::max () ||" << endl
+     <<         "r > std::numeric_limits<X>::max ())" << endl
+     <<       "throw invalid_value (o, std::string (b, e));"
+     <<                                                                    endl
+     <<     "x = static_cast<X> (r);"
+     <<   "}"
+     << "};";
+
+  os << "template <>" << endl
+     << "struct value_parser<short>:" << endl
+     << "value_parser_signed<short, long, &std::strtol> {};"
+     << endl
+     << "template <>" << endl
+     << "struct value_parser<int>:" << endl
+     << "value_parser_signed<int, long, &std::strtol> {};"
+     << endl
+     << "template <>" << endl
+     << "struct value_parser<long>:" << endl
+     << "value_parser_signed<long, long, &std::strtol> {};"
+     << endl;
+
+  if (ll)
+    os << "template <>" << endl
+       << "struct value_parser<long long>:" << endl
+       << "value_parser_signed<long long, long long, &std::strtoll> {};"
+       << endl;
+
+  os << "template <>" << endl
+     << "struct value_parser<unsigned short>:" << endl
+     << "value_parser_unsigned<unsigned short, unsigned long, &std::strtoul> {};"
+     << endl
+     << "template <>" << endl
+     << "struct value_parser<unsigned int>:" << endl
+     << "value_parser_unsigned<unsigned int, unsigned long, &std::strtoul> {};"
+     << endl
+     << "template <>" << endl
+     << "struct value_parser<unsigned long>:" << endl
+     << "value_parser_unsigned<unsigned long, unsigned long, &std::strtoul> {};"
+     << endl;
+
+  if (ll)
+    os << "template <>" << endl
+       << "struct value_parser<unsigned long long>:" << endl
+       << "value_parser_unsigned<unsigned long long," << endl
+       << "unsigned long long," << endl
+       << "&std::strtoull> {};"
+       << endl;
+
+  os << "template <>" << endl
+     << "struct value_parser<float>: value_parser_float<float> {};"
+     << endl
+     << "template <>" << endl
+     << "struct value_parser<double>: value_parser_float<double> {};"
+     << endl;
+
+  // Parse the [b, e) slice of an argument as the key=value map entry. If
+  // the key or value is empty, then the corresponding K() or V() is left
+  // in place.
+  //
+  os << "template <typename K, typename V>" << endl
+     << "void" << endl
+     << "parse_entry (K& k, V& v, const char* o," << endl
+     << "const char* b, const char* e," << endl
+     << "std::size_t pos)"
+     << "{"
+     <<   "const char* vb (" << endl
+     <<     "static_cast<const char*> (std::memchr (b, '=', e - b)));"
+     <<   "const char* ke (vb != 0 ? vb : e);"
+     <<                                                                    endl
+     <<   "if (ke != b)" << endl
+     <<     "value_parser<K>::parse (k, o, b, ke, pos);"
+     <<                                                                    endl
+     <<   "if (vb != 0 && ++vb != e)" << endl
+     <<     "value_parser<V>::parse (v, o, vb, e, pos);"
+     << "}";
+
+  os << "template <typename K, typename V>" << endl
+     << "void" << endl
+     << "parse_entry (K& k, V& v, scanner& s)"
+     << "{"
+     <<   "const char* o (s.next ());"
+     <<                                                                    endl
+     <<   "if (!s.more ())" << endl
+     <<     "throw missing_value (o);"
+     <<                                                                    endl
+     <<   "std::size_t pos (s.position ());"
+     <<   "const char* b (s.next ());"
+     <<   "parse_entry (k, v, o, b, b + std::strlen (b), pos);"
+     << "}";
+
+  // parser<std::map<K,V,C>>
+  //
+  os << "template <typename K, typename V, typename C>" << endl
+     << "struct parser<std::map<K, V, C> >"
+     << "{";
+
+  os <<   "static void" << endl
+     <<   "parse (std::map<K, V, C>& m, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+     <<   "{"
+     <<     "K k = K ();"
+     <<     "V v = V ();"
+     <<     "parse_entry (k, v, s);"
+     <<     "m[k] = v;";
+  if (sp)
+    os <<   "xs = true;";
+  os <<   "}";
+
+  if (gen_merge)
+    os << "static void" << endl
+       << "merge (std::map<K, V, C>& b, const std::map<K, V, C>& a)"
+       << "{"
+       <<   "for (typename std::map<K, V, C>::const_iterator i (a.begin ()); " << endl
+       <<         "i != a.end (); "                                            << endl
+       <<         "++i)"                                                       << endl
+       <<     "b[i->first] = i->second;"
+       << "}";
+
+  os << "};";
+
+  // parser<std::multimap<K,V,C>>
+  //
+  os << "template <typename K, typename V, typename C>" << endl
+     << "struct parser<std::multimap<K, V, C> >"
+     << "{";
+
+  os <<   "static void" << endl
+     <<   "parse (std::multimap<K, V, C>& m, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+     <<   "{"
+     <<     "K k = K ();"
+     <<     "V v = V ();"
+     <<     "parse_entry (k, v, s);"
+     <<     "m.insert (typename std::multimap<K, V, C>::value_type (k, v));";
+  if (sp)
+    os <<   "xs = true;";
+  os <<   "}";
+
+  if (gen_merge)
+    os << "static void" << endl
+       << "merge (std::multimap<K, V, C>& b, const std::multimap<K, V, C>& a)"
+       << "{"
+       <<   "b.insert (a.begin (), a.end ());"
+       << "}";
+
+  os << "};";
+
+  // parser<std::unordered_set<X,H,P>>
+  //
+  if (uset)
+  {
+    os << "template <typename X, typename H, typename P>" << endl
+       << "struct parser<std::unordered_set<X, H, P> >"
+       << "{";
+
+    os <<  "static void" << endl
+       <<  "parse (std::unordered_set<X, H, P>& c, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+       <<  "{"
+       <<    "X x;";
+    if (sp)
+      os <<  "bool dummy;";
+    os <<    "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);"
+       <<    "c.insert (x);";
+    if (sp)
+      os <<  "xs = true;";
+    os <<  "}";
+
+    if (gen_merge)
+      os << "static void" << endl
+         << "merge (std::unordered_set<X, H, P>& b, const std::unordered_set<X, H, P>& a)"
+         << "{"
+         <<   "b.insert (a.begin (), a.end ());"
+         << "}";
+
+    os << "};";
+  }
+
+  // parser<std::unordered_map<K,V,H,P>>
+  //
+  if (umap)
+  {
+    os << "template <typename K, typename V, typename H, typename P>" << endl
+       << "struct parser<std::unordered_map<K, V, H, P> >"
+       << "{";
+
+    os <<   "static void" << endl
+       <<   "parse (std::unordered_map<K, V, H, P>& m, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+       <<   "{"
+       <<     "K k = K ();"
+       <<     "V v = V ();"
+       <<     "parse_entry (k, v, s);"
+       <<     "m[k] = v;";
+    if (sp)
+      os <<   "xs = true;";
+    os <<   "}";
+
+    if (gen_merge)
+      os << "static void" << endl
+         << "merge (std::unordered_map<K, V, H, P>& b, const std::unordered_map<K, V, H, P>& a)"
+         << "{"
+         <<   "for (typename std::unordered_map<K, V, H, P>::const_iterator i (a.begin ()); " << endl
+         <<         "i != a.end (); "                                                        << endl
+         <<         "++i)"                                                                   << endl
+         <<     "b[i->first] = i->second;"
+         << "}";
+
+    os << "};";
+  }
+
+  // parser<flat_set<X,C>>
+  //
+  if (fset)
+  {
+    os << "template <typename X, typename C>" << endl
+       << "struct parser<flat_set<X, C> >"
+       << "{";
+
+    os <<  "static void" << endl
+       <<  "parse (flat_set<X, C>& c, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+       <<  "{"
+       <<    "X x;";
+    if (sp)
+      os <<  "bool dummy;";
+    os <<    "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);"
+       <<    "c.insert (x);";
+    if (sp)
+      os <<  "xs = true;";
+    os <<  "}";
+
+    if (gen_merge)
+      os << "static void" << endl
+         << "merge (flat_set<X, C>& b, const flat_set<X, C>& a)"
+         << "{"
+         <<   "b.insert (a.begin (), a.end ());"
+         << "}";
+
+    os << "};";
+  }
+
+  // Parser thunk.
+  //
   os << "template <typename X, typename T, T X::*M>" << endl
      << "void" << endl
      << "thunk (X& x, scanner& s)"
@@ -1241,5 +2574,944 @@ generate_runtime_source (context& ctx, bool complete)
        << "parser<T>::parse (x.*M, x.*S, s);"
        << "}";
 
+  // List options (those with the separator attribute).
+  //
+  if (has_option_attribute (ctx.unit, "separator"))
+  {
+    os << "template <typename C>" << endl
+       << "inline void" << endl
+       << "list_reserve (C&, std::size_t)"
+       << "{"
+       << "}";
+
+    os << "template <typename X, typename A>" << endl
+       << "inline void" << endl
+       << "list_reserve (std::vector<X, A>& c, std::size_t n)"
+       << "{"
+       <<   "c.reserve (c.size () + n);"
+       << "}";
+
+    os << "template <typename C, typename X>" << endl
+       << "inline void" << endl
+       << "list_insert (C& c, const X& x)"
+       << "{"
+       <<   "c.insert (c.end (), x);"
+       << "}";
+
+    // Parse the [b, e) element slice with the value slice parser as a
+    // value of the original option. For maps the element is the key=value
+    // entry.
+    //
+    os << "template <typename C>" << endl
+       << "inline void" << endl
+       << "list_element (C& c, const char* o," << endl
+       << "const char* b, const char* e," << endl
+       << "std::size_t pos)"
+       << "{"
+       <<   "typename C::value_type x;"
+       <<   "value_parser<typename C::value_type>::parse (x, o, b, e, pos);"
+       <<   "list_insert (c, x);"
+       << "}";
+
+    os << "template <typename K, typename V, typename C>" << endl
+       << "inline void" << endl
+       << "list_element (std::map<K, V, C>& m, const char* o," << endl
+       << "const char* b, const char* e," << endl
+       << "std::size_t pos)"
+       << "{"
+       <<   "K k = K ();"
+       <<   "V v = V ();"
+       <<   "parse_entry (k, v, o, b, e, pos);"
+       <<   "m[k] = v;"
+       << "}";
+
+    os << "template <typename K, typename V, typename C>" << endl
+       << "inline void" << endl
+       << "list_element (std::multimap<K, V, C>& m, const char* o," << endl
+       << "const char* b, const char* e," << endl
+       << "std::size_t pos)"
+       << "{"
+       <<   "K k = K ();"
+       <<   "V v = V ();"
+       <<   "parse_entry (k, v, o, b, e, pos);"
+       <<   "m.insert (typename std::multimap<K, V, C>::value_type (k, v));"
+       << "}";
+
+    if (umap)
+      os << "template <typename K, typename V, typename H, typename P>" << endl
+         << "inline void" << endl
+         << "list_element (std::unordered_map<K, V, H, P>& m, const char* o," << endl
+         << "const char* b, const char* e," << endl
+         << "std::size_t pos)"
+         << "{"
+         <<   "K k = K ();"
+         <<   "V v = V ();"
+         <<   "parse_entry (k, v, o, b, e, pos);"
+         <<   "m[k] = v;"
+         << "}";
+
+    // Split the value into elements with memchr() (which is normally
+    // vectorized) counting them first so that we can reserve the space
+    // up front.
+    //
+    os << "template <typename C>" << endl
+       << "void" << endl
+       << "parse_list (C& c, scanner& s, char d)"
+       << "{"
+       <<   "const char* o (s.next ());"
+       <<                                                                  endl
+       <<   "if (!s.more ())" << endl
+       <<     "throw missing_value (o);"
+       <<                                                                  endl
+       <<   "std::size_t pos (s.position ());"
+       <<   "const char* v (s.next ());"
+       <<   "const char* e (v + std::strlen (v));"
+       <<                                                                  endl
+       <<   "std::size_t n (1);"
+       <<   "for (const char* p (v);" << endl
+       <<        "(p = static_cast<const char*> (" << endl
+       <<           "std::memchr (p, d, e - p))) != 0;" << endl
+       <<        "++p)" << endl
+       <<     "++n;"
+       <<                                                                  endl
+       <<   "list_reserve (c, n);"
+       <<                                                                  endl
+       <<   "for (const char* b (v);;)"
+       <<   "{"
+       <<     "const char* p (" << endl
+       <<       "static_cast<const char*> (std::memchr (b, d, e - b)));"
+       <<                                                                  endl
+       <<     "list_element (c, o, b, p != 0 ? p : e, pos);"
+       <<                                                                  endl
+       <<     "if (p == 0)" << endl
+       <<       "break;"
+       <<                                                                  endl
+       <<     "b = p + 1;"
+       <<   "}"
+       << "}";
+
+    // Collect the flat_set elements first so that they are sorted and
+    // merged in a single pass.
+    //
+    if (fset)
+      os << "template <typename X, typename C>" << endl
+         << "void" << endl
+         << "parse_list (flat_set<X, C>& c, scanner& s, char d)"
+         << "{"
+         <<   "std::vector<X> v;"
+         <<   "parse_list (v, s, d);"
+         <<   "c.insert (v.begin (), v.end ());"
+         << "}";
+
+    os << "template <typename X, typename T, T X::*M, char D>" << endl
+       << "void" << endl
+       << "list_thunk (X& x, scanner& s)"
+       << "{"
+       << "parse_list (x.*M, s, D);"
+       << "}";
+
+    if (ctx.gen_specifier)
+      os << "template <typename X, typename T, T X::*M, bool X::*S, char D>" << endl
+         << "void" << endl
+         << "list_thunk (X& x, scanner& s)"
+         << "{"
+         << "parse_list (x.*M, s, D);"
+         << "x.*S = true;"
+         << "}";
+  }
+
+  // Hasher class template & its specializations.
+  //
+  if (ctx.options.generate_hash ())
+  {
+    os << "inline void" << endl
+       << "hash_combine (std::size_t& h, std::size_t v)"
+       << "{"
+       <<   "h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);"
+       << "}";
+
+    os << "inline std::size_t" << endl
+       << "hash_bytes (const void* d, std::size_t n)"
+       << "{"
+       <<   "const unsigned char* p (static_cast<const unsigned char*> (d));"
+       <<   "std::size_t h (2166136261UL);"
+       <<   "for (const unsigned char* e (p + n); p != e; ++p)" << endl
+       <<     "h = (h ^ *p) * 16777619UL;"
+       <<   "return h;"
+       << "}";
+
+    // Integral types are hashed by value bytes. Floating point types are
+    // normalized so that equal values (for example, 0.0 and -0.0) hash the
+    // same.
+    //
+    os << "template <typename X>" << endl
+       << "struct hasher_integral"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const X& x)"
+       <<   "{"
+       <<     "return hash_bytes (&x, sizeof (X));"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X>" << endl
+       << "struct hasher_floating"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const X& x)"
+       <<   "{"
+       <<     "double d (x != 0 ? static_cast<double> (x) : 0.0);"
+       <<     "return hash_bytes (&d, sizeof (d));"
+       <<   "}"
+       << "};";
+
+    const char* ints[] = {
+      "bool", "char", "signed char", "unsigned char", "wchar_t",
+      "short", "unsigned short", "int", "unsigned int",
+      "long", "unsigned long", "long long", "unsigned long long"};
+
+    for (size_t i (0); i != sizeof (ints) / sizeof (ints[0]); ++i)
+    {
+      string t (ints[i]);
+
+      if (t.find ("long long") != string::npos &&
+          ctx.options.std () < cxx_version::cxx11)
+        continue;
+
+      os << "template <>" << endl
+         << "struct hasher<" << t << ">: hasher_integral<" << t << "> {};"
+         << endl;
+    }
+
+    const char* floats[] = {"float", "double", "long double"};
+
+    for (size_t i (0); i != sizeof (floats) / sizeof (floats[0]); ++i)
+      os << "template <>" << endl
+         << "struct hasher<" << floats[i] << ">: hasher_floating<" <<
+        floats[i] << "> {};"
+         << endl;
+
+    os << "template <>" << endl
+       << "struct hasher<std::string>"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const std::string& x)"
+       <<   "{"
+       <<     "return hash_bytes (x.data (), x.size ());"
+       <<   "}"
+       << "};";
+
+    // By default, hash the value's string representation.
+    //
+    os << "template <typename X>" << endl
+       << "struct hasher"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const X& x)"
+       <<   "{"
+       <<     "std::ostringstream os;"
+       <<     "os << x;"
+       <<     "return hasher<std::string>::hash (os.str ());"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X, typename Y>" << endl
+       << "struct hasher<std::pair<X, Y> >"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const std::pair<X, Y>& x)"
+       <<   "{"
+       <<     "std::size_t h (hasher<X>::hash (x.first));"
+       <<     "hash_combine (h, hasher<Y>::hash (x.second));"
+       <<     "return h;"
+       <<   "}"
+       << "};";
+
+    // Ordered containers are hashed in the iteration order. For unordered
+    // containers the order of equal containers may differ so we combine
+    // the element hashes in an order-independent way.
+    //
+    os << "template <typename X>" << endl
+       << "inline std::size_t" << endl
+       << "hash_element (const X& x)"
+       << "{"
+       <<   "return hasher<X>::hash (x);"
+       << "}";
+
+    os << "template <typename K, typename V>" << endl
+       << "inline std::size_t" << endl
+       << "hash_element (const std::pair<const K, V>& x)"
+       << "{"
+       <<   "std::size_t h (hasher<K>::hash (x.first));"
+       <<   "hash_combine (h, hasher<V>::hash (x.second));"
+       <<   "return h;"
+       << "}";
+
+    os << "template <typename C>" << endl
+       << "struct hasher_seq"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const C& c)"
+       <<   "{"
+       <<     "std::size_t h (c.size ());"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)" << endl
+       <<       "hash_combine (h, hash_element (*i));"
+       <<     "return h;"
+       <<   "}"
+       << "};";
+
+    os << "template <typename C>" << endl
+       << "struct hasher_unordered"
+       << "{"
+       <<   "static std::size_t" << endl
+       <<   "hash (const C& c)"
+       <<   "{"
+       <<     "std::size_t h (0);"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)" << endl
+       <<       "h += hash_element (*i);"
+       <<     "hash_combine (h, c.size ());"
+       <<     "return h;"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X, typename A>" << endl
+       << "struct hasher<std::vector<X, A> >: " <<
+      "hasher_seq<std::vector<X, A> > {};"
+       << endl
+       << "template <typename X, typename C>" << endl
+       << "struct hasher<std::set<X, C> >: " <<
+      "hasher_seq<std::set<X, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct hasher<std::map<K, V, C> >: " <<
+      "hasher_seq<std::map<K, V, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct hasher<std::multimap<K, V, C> >: " <<
+      "hasher_seq<std::multimap<K, V, C> > {};"
+       << endl;
+
+    if (uset)
+      os << "template <typename X, typename H, typename P>" << endl
+         << "struct hasher<std::unordered_set<X, H, P> >: " <<
+        "hasher_unordered<std::unordered_set<X, H, P> > {};"
+         << endl;
+
+    if (umap)
+      os << "template <typename K, typename V, typename H, typename P>" << endl
+         << "struct hasher<std::unordered_map<K, V, H, P> >: " <<
+        "hasher_unordered<std::unordered_map<K, V, H, P> > {};"
+         << endl;
+
+    if (fset)
+      os << "template <typename X, typename C>" << endl
+         << "struct hasher<flat_set<X, C> >: " <<
+        "hasher_seq<flat_set<X, C> > {};"
+         << endl;
+  }
+
+  // Serializer class template & its specializations.
+  //
+  if (ctx.options.generate_argv ())
+  {
+    // Scalar values are formatted into the sink's scratch string and
+    // passed as a single option value.
+    //
+    os << "template <typename X>" << endl
+       << "struct serializer_scalar"
+       << "{"
+       <<   "static void" << endl
+       <<   "write (argument_sink& b, const char* o, const X& x)"
+       <<   "{"
+       <<     "std::string& s (b.scratch ());"
+       <<     "s.clear ();"
+       <<     "serializer<X>::value (s, x);"
+       <<     "b.option (o, s);"
+       <<   "}"
+       << "};";
+
+    // Integral types are formatted without going through a stream.
+    //
+    os << "template <typename X>" << endl
+       << "struct serializer_integral: serializer_scalar<X>"
+       << "{"
+       <<   "static void" << endl
+       <<   "value (std::string& s, X x)"
+       <<   "{"
+       <<     "char b[sizeof (X) * 3 + 2];"
+       <<     "char* e (b + sizeof (b));"
+       <<     "char* p (e);"
+       <<     "bool n (!(x > 0) && x != 0);"
+       <<                                                                  endl
+       <<     "do"
+       <<     "{"
+       <<       "X d (x % 10);"
+       <<       "*--p = static_cast<char> ('0' + (n ? -d : d));"
+       <<       "x /= 10;"
+       <<     "} while (x != 0);"
+       <<                                                                  endl
+       <<     "if (n)" << endl
+       <<       "*--p = '-';"
+       <<                                                                  endl
+       <<     "s.append (p, e - p);"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X>" << endl
+       << "struct serializer_floating: serializer_scalar<X>"
+       << "{"
+       <<   "static void" << endl
+       <<   "value (std::string& s, X x)"
+       <<   "{"
+       <<     "char b[64];"
+       <<     "int n (std::sprintf (b, \"%.*Lg\", " << endl
+       <<            "sizeof (X) == sizeof (float) ? 9 : " <<
+      "sizeof (X) == sizeof (double) ? 17 : 21," << endl
+       <<            "static_cast<long double> (x)));"
+       <<     "s.append (b, static_cast<std::size_t> (n));"
+       <<   "}"
+       << "};";
+
+    const char* ints[] = {
+      "short", "unsigned short", "int", "unsigned int",
+      "long", "unsigned long", "long long", "unsigned long long"};
+
+    for (size_t i (0); i != sizeof (ints) / sizeof (ints[0]); ++i)
+    {
+      string t (ints[i]);
+
+      if (t.find ("long long") != string::npos &&
+          ctx.options.std () < cxx_version::cxx11)
+        continue;
+
+      os << "template <>" << endl
+         << "struct serializer<" << t << ">: serializer_integral<" << t <<
+        "> {};"
+         << endl;
+    }
+
+    const char* floats[] = {"float", "double", "long double"};
+
+    for (size_t i (0); i != sizeof (floats) / sizeof (floats[0]); ++i)
+      os << "template <>" << endl
+         << "struct serializer<" << floats[i] << ">: serializer_floating<" <<
+        floats[i] << "> {};"
+         << endl;
+
+    os << "template <>" << endl
+       << "struct serializer<std::string>"
+       << "{"
+       <<   "static void" << endl
+       <<   "value (std::string& s, const std::string& x)"
+       <<   "{"
+       <<     "s += x;"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "write (argument_sink& b, const char* o, const std::string& x)"
+       <<   "{"
+       <<     "b.option (o, x);"
+       <<   "}"
+       << "};";
+
+    // By default, format the value with the stream insertion operator.
+    //
+    os << "template <typename X>" << endl
+       << "struct serializer: serializer_scalar<X>"
+       << "{"
+       <<   "static void" << endl
+       <<   "value (std::string& s, const X& x)"
+       <<   "{"
+       <<     "std::ostringstream os;"
+       <<     "os << x;"
+       <<     "s += os.str ();"
+       <<   "}"
+       << "};";
+
+    // Option value with its position (see parser<std::pair<X, std::size_t>>).
+    //
+    os << "template <typename X>" << endl
+       << "struct serializer<std::pair<X, std::size_t> >: " <<
+      "serializer_scalar<std::pair<X, std::size_t> >"
+       << "{"
+       <<   "static void" << endl
+       <<   "value (std::string& s, const std::pair<X, std::size_t>& x)"
+       <<   "{"
+       <<     "serializer<X>::value (s, x.first);"
+       <<   "}"
+       << "};";
+
+    // Containers are written as an option occurrence per element and map
+    // containers as an option occurrence per key=value entry.
+    //
+    os << "template <typename C>" << endl
+       << "struct serializer_seq"
+       << "{"
+       <<   "static void" << endl
+       <<   "write (argument_sink& b, const char* o, const C& c)"
+       <<   "{"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)" << endl
+       <<       "serializer<typename C::value_type>::write (b, o, *i);"
+       <<   "}"
+       << "};";
+
+    os << "template <typename C>" << endl
+       << "struct serializer_map"
+       << "{"
+       <<   "static void" << endl
+       <<   "write (argument_sink& b, const char* o, const C& c)"
+       <<   "{"
+       <<     "std::string& s (b.scratch ());"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)"
+       <<     "{"
+       <<       "s.clear ();"
+       <<       "serializer<typename C::key_type>::value (s, i->first);"
+       <<       "s += '=';"
+       <<       "serializer<typename C::mapped_type>::value (s, i->second);"
+       <<       "b.option (o, s);"
+       <<     "}"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X, typename A>" << endl
+       << "struct serializer<std::vector<X, A> >: " <<
+      "serializer_seq<std::vector<X, A> > {};"
+       << endl
+       << "template <typename X, typename C>" << endl
+       << "struct serializer<std::set<X, C> >: " <<
+      "serializer_seq<std::set<X, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct serializer<std::map<K, V, C> >: " <<
+      "serializer_map<std::map<K, V, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct serializer<std::multimap<K, V, C> >: " <<
+      "serializer_map<std::multimap<K, V, C> > {};"
+       << endl;
+
+    if (uset)
+      os << "template <typename X, typename H, typename P>" << endl
+         << "struct serializer<std::unordered_set<X, H, P> >: " <<
+        "serializer_seq<std::unordered_set<X, H, P> > {};"
+         << endl;
+
+    if (umap)
+      os << "template <typename K, typename V, typename H, typename P>" << endl
+         << "struct serializer<std::unordered_map<K, V, H, P> >: " <<
+        "serializer_map<std::unordered_map<K, V, H, P> > {};"
+         << endl;
+
+    if (fset)
+      os << "template <typename X, typename C>" << endl
+         << "struct serializer<flat_set<X, C> >: " <<
+        "serializer_seq<flat_set<X, C> > {};"
+         << endl;
+  }
+
+  // Snapshot class template & its specializations.
+  //
+  if (ctx.options.generate_snapshot ())
+  {
+    // Sizes are saved as variable-length (7 bits per byte) integers.
+    //
+    os << "inline void" << endl
+       << "snapshot_save_size (snapshot_buffer& b, std::size_t n)"
+       << "{"
+       <<   "do"
+       <<   "{"
+       <<     "unsigned char c (static_cast<unsigned char> (n & 0x7F));"
+       <<     "n >>= 7;"
+       <<     "b.push_back (static_cast<char> (n != 0 ? c | 0x80 : c));"
+       <<   "} while (n != 0);"
+       << "}";
+
+    os << "inline std::size_t" << endl
+       << "snapshot_load_size (const char*& p, const char* e)"
+       << "{"
+       <<   "std::size_t n (0);"
+       <<   "for (std::size_t s (0);; s += 7)"
+       <<   "{"
+       <<     "if (p == e || s >= sizeof (std::size_t) * 8)" << endl
+       <<       "throw invalid_snapshot ();"
+       <<                                                                  endl
+       <<     "unsigned char c (static_cast<unsigned char> (*p++));"
+       <<     "n |= static_cast<std::size_t> (c & 0x7F) << s;"
+       <<                                                                  endl
+       <<     "if ((c & 0x80) == 0)" << endl
+       <<       "return n;"
+       <<   "}"
+       << "}";
+
+    // Values of fundamental types are saved in the native representation.
+    //
+    os << "template <typename X>" << endl
+       << "struct snapshot_pod"
+       << "{"
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const X& x)"
+       <<   "{"
+       <<     "const char* d (reinterpret_cast<const char*> (&x));"
+       <<     "b.insert (b.end (), d, d + sizeof (X));"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, X& x)"
+       <<   "{"
+       <<     "if (static_cast<std::size_t> (e - p) < sizeof (X))" << endl
+       <<       "throw invalid_snapshot ();"
+       <<                                                                  endl
+       <<     "std::memcpy (&x, p, sizeof (X));"
+       <<     "p += sizeof (X);"
+       <<   "}"
+       << "};";
+
+    const char* pods[] = {
+      "char", "signed char", "unsigned char", "wchar_t",
+      "short", "unsigned short", "int", "unsigned int",
+      "long", "unsigned long", "long long", "unsigned long long",
+      "float", "double", "long double"};
+
+    for (size_t i (0); i != sizeof (pods) / sizeof (pods[0]); ++i)
+    {
+      string t (pods[i]);
+
+      if (t.find ("long long") != string::npos &&
+          ctx.options.std () < cxx_version::cxx11)
+        continue;
+
+      os << "template <>" << endl
+         << "struct snapshot<" << t << ">: snapshot_pod<" << t << "> {};"
+         << endl;
+    }
+
+    os << "template <>" << endl
+       << "struct snapshot<bool>"
+       << "{"
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, bool x)"
+       <<   "{"
+       <<     "b.push_back (x ? 1 : 0);"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, bool& x)"
+       <<   "{"
+       <<     "if (p == e || (*p != 0 && *p != 1))" << endl
+       <<       "throw invalid_snapshot ();"
+       <<                                                                  endl
+       <<     "x = *p++ != 0;"
+       <<   "}"
+       << "};";
+
+    os << "template <>" << endl
+       << "struct snapshot<std::string>"
+       << "{"
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const std::string& x)"
+       <<   "{"
+       <<     "snapshot_save_size (b, x.size ());"
+       <<     "b.insert (b.end (), x.begin (), x.end ());"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, std::string& x)"
+       <<   "{"
+       <<     "std::size_t n (snapshot_load_size (p, e));"
+       <<                                                                  endl
+       <<     "if (static_cast<std::size_t> (e - p) < n)" << endl
+       <<       "throw invalid_snapshot ();"
+       <<                                                                  endl
+       <<     "x.assign (p, n);"
+       <<     "p += n;"
+       <<   "}"
+       << "};";
+
+    // By default, save the value as a string using the stream insertion
+    // operator and load it the same way as it would have been parsed.
+    //
+    os << "template <typename X>" << endl
+       << "struct snapshot"
+       << "{"
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const X& x)"
+       <<   "{"
+       <<     "std::ostringstream os;"
+       <<     "os << x;"
+       <<     "snapshot<std::string>::save (b, os.str ());"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, X& x)"
+       <<   "{"
+       <<     "std::string s;"
+       <<     "snapshot<std::string>::load (p, e, s);"
+       <<                                                                  endl
+       <<     "std::istringstream is (s);"
+       <<     "if (!(is >> x && is.eof ()))" << endl
+       <<       "throw invalid_snapshot ();"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X, typename Y>" << endl
+       << "struct snapshot<std::pair<X, Y> >"
+       << "{"
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const std::pair<X, Y>& x)"
+       <<   "{"
+       <<     "snapshot<X>::save (b, x.first);"
+       <<     "snapshot<Y>::save (b, x.second);"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, std::pair<X, Y>& x)"
+       <<   "{"
+       <<     "snapshot<X>::load (p, e, x.first);"
+       <<     "snapshot<Y>::load (p, e, x.second);"
+       <<   "}"
+       << "};";
+
+    // Sequence and set containers are saved as the element count followed
+    // by the elements and map containers as the entry count followed by
+    // the key/value pairs.
+    //
+    os << "template <typename C>" << endl
+       << "struct snapshot_seq"
+       << "{"
+       <<   "typedef typename C::value_type X;"
+       <<                                                                  endl
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const C& c)"
+       <<   "{"
+       <<     "snapshot_save_size (b, c.size ());"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)" << endl
+       <<       "snapshot<X>::save (b, *i);"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, C& c)"
+       <<   "{"
+       <<     "c.clear ();"
+       <<     "for (std::size_t n (snapshot_load_size (p, e)); n != 0; --n)"
+       <<     "{"
+       <<       "X x;"
+       <<       "snapshot<X>::load (p, e, x);"
+       <<       "c.insert (c.end (), x);"
+       <<     "}"
+       <<   "}"
+       << "};";
+
+    os << "template <typename C>" << endl
+       << "struct snapshot_map"
+       << "{"
+       <<   "typedef typename C::key_type K;"
+       <<   "typedef typename C::mapped_type V;"
+       <<                                                                  endl
+       <<   "static void" << endl
+       <<   "save (snapshot_buffer& b, const C& c)"
+       <<   "{"
+       <<     "snapshot_save_size (b, c.size ());"
+       <<     "for (typename C::const_iterator i (c.begin ()); i != c.end (); ++i)"
+       <<     "{"
+       <<       "snapshot<K>::save (b, i->first);"
+       <<       "snapshot<V>::save (b, i->second);"
+       <<     "}"
+       <<   "}"
+       <<   "static void" << endl
+       <<   "load (const char*& p, const char* e, C& c)"
+       <<   "{"
+       <<     "c.clear ();"
+       <<     "for (std::size_t n (snapshot_load_size (p, e)); n != 0; --n)"
+       <<     "{"
+       <<       "K k;"
+       <<       "V v;"
+       <<       "snapshot<K>::load (p, e, k);"
+       <<       "snapshot<V>::load (p, e, v);"
+       <<       "c.insert (c.end (), typename C::value_type (k, v));"
+       <<     "}"
+       <<   "}"
+       << "};";
+
+    os << "template <typename X, typename A>" << endl
+       << "struct snapshot<std::vector<X, A> >: " <<
+      "snapshot_seq<std::vector<X, A> > {};"
+       << endl
+       << "template <typename X, typename C>" << endl
+       << "struct snapshot<std::set<X, C> >: " <<
+      "snapshot_seq<std::set<X, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct snapshot<std::map<K, V, C> >: " <<
+      "snapshot_map<std::map<K, V, C> > {};"
+       << endl
+       << "template <typename K, typename V, typename C>" << endl
+       << "struct snapshot<std::multimap<K, V, C> >: " <<
+      "snapshot_map<std::multimap<K, V, C> > {};"
+       << endl;
+
+    if (uset)
+      os << "template <typename X, typename H, typename P>" << endl
+         << "struct snapshot<std::unordered_set<X, H, P> >: " <<
+        "snapshot_seq<std::unordered_set<X, H, P> > {};"
+         << endl;
+
+    if (umap)
+      os << "template <typename K, typename V, typename H, typename P>" << endl
+         << "struct snapshot<std::unordered_map<K, V, H, P> >: " <<
+        "snapshot_map<std::unordered_map<K, V, H, P> > {};"
+         << endl;
+
+    // The elements are saved sorted so we can append them as is.
+    //
+    if (fset)
+      os << "template <typename X, typename C>" << endl
+         << "struct snapshot<flat_set<X, C> >"
+         << "{"
+         <<   "static void" << endl
+         <<   "save (snapshot_buffer& b, const flat_set<X, C>& c)"
+         <<   "{"
+         <<     "snapshot_seq<flat_set<X, C> >::save (b, c);"
+         <<   "}"
+         <<   "static void" << endl
+         <<   "load (const char*& p, const char* e, flat_set<X, C>& c)"
+         <<   "{"
+         <<     "c.clear ();"
+         <<     "std::size_t n (snapshot_load_size (p, e));"
+         <<                                                                  endl
+         <<     "// Each element takes at least one byte so the count of a" << endl
+         <<     "// valid snapshot cannot exceed the remaining size. Check it" << endl
+         <<     "// before reserving the space." << endl
+         <<     "//" << endl
+         <<     "if (n > static_cast<std::size_t> (e - p))" << endl
+         <<       "throw invalid_snapshot ();"
+         <<                                                                  endl
+         <<     "c.reserve (n);"
+         <<     "for (; n != 0; --n)"
+         <<     "{"
+         <<       "X x;"
+         <<       "snapshot<X>::load (p, e, x);"
+         <<       "c.insert (x);"
+         <<     "}"
+         <<   "}"
+         << "};";
+  }
+
+  // Dynamic option values. These are parsed with the parser class
+  // template so they have to come after its specializations.
+  //
+  if (complete && ctx.options.generate_dynamic_options ())
+  {
+    os << "// dynamic_values" << endl
+       << "//" << endl
+       << "dynamic_values::" << endl
+       << "dynamic_values (const dynamic_options& o)" << endl
+       << ": options_ (o), values_ (o.size ())"
+       << "{"
+       << "for (std::size_t i (0); i != values_.size (); ++i)"
+       << "{"
+       << "value& v (values_[i]);"
+       << "v.kind = static_cast<unsigned char> (o.kind (i));"
+       << "v.specified = false;"
+       << endl
+       << "switch (o.kind (i))"
+       << "{"
+       << "case dynamic_kind::flag: v.flag = false; break;"
+       << "case dynamic_kind::integer: v.integer = 0; break;"
+       << "case dynamic_kind::real: v.real = 0; break;"
+       << "case dynamic_kind::string:" << endl
+       << "{"
+       << "v.index = strings_.size ();"
+       << "strings_.push_back (std::string ());"
+       << "break;"
+       << "}"
+       << "case dynamic_kind::strings:" << endl
+       << "{"
+       << "v.index = lists_.size ();"
+       << "lists_.push_back (std::vector<std::string> ());"
+       << "break;"
+       << "}"
+       << "}"
+       << "// Parse the default value as if it was specified on the command" << endl
+       << "// line." << endl
+       << "//" << endl
+       << "const option& d (o[i]);"
+       << endl
+       << "if (!d.flag () && !d.default_value ().empty ())"
+       << "{"
+       << "int ac (2);"
+       << "char* av[] ="
+       << "{"
+       << "const_cast<char*> (d.name ().c_str ())," << endl
+       << "const_cast<char*> (d.default_value ().c_str ())"
+       << "};"
+       << "argv_scanner s (0, ac, av);"
+       << "parse (i, s);"
+       << "v.specified = false;"
+       << "}"
+       << "}"
+       << "}"
+
+       << "void dynamic_values::" << endl
+       << "parse (std::size_t i, scanner& s)"
+       << "{"
+       << "value& v (values_[i]);";
+
+    if (sp)
+      os << "bool d (false);";
+
+    string d (sp ? "d, " : "");
+
+    os << endl
+       << "switch (static_cast<dynamic_kind::value> (v.kind))"
+       << "{"
+       << "case dynamic_kind::flag:" << endl
+       << "{"
+       << "s.next ();"
+       << "v.flag = true;"
+       << "break;"
+       << "}"
+       << "case dynamic_kind::string:" << endl
+       << "{"
+       << "parser<std::string>::parse (strings_[v.index], " << d << "s);"
+       << "break;"
+       << "}"
+       << "case dynamic_kind::integer:" << endl
+       << "{"
+       << "parser<integer_type>::parse (v.integer, " << d << "s);"
+       << "break;"
+       << "}"
+       << "case dynamic_kind::real:" << endl
+       << "{"
+       << "parser<double>::parse (v.real, " << d << "s);"
+       << "break;"
+       << "}"
+       << "case dynamic_kind::strings:" << endl
+       << "{"
+       << "parser<std::vector<std::string> >::parse (lists_[v.index], " <<
+      d << "s);"
+       << "break;"
+       << "}"
+       << "}"
+       << "v.specified = true;"
+       << "}"
+
+       << "bool dynamic_values::" << endl
+       << "_parse (const char* o, scanner& s)"
+       << "{"
+       << "std::size_t i (options_.find (o));"
+       << endl
+       << "// Besides unknown, the option could have been registered after" << endl
+       << "// we were created in which case we treat it as unknown as well." << endl
+       << "//" << endl
+       << "if (i >= values_.size ())" << endl
+       << "return false;"
+       << endl
+       << "parse (i, s);"
+       << "return true;"
+       << "}"
+
+       << "bool dynamic_values::" << endl
+       << "parse (scanner& s)"
+       << "{"
+       << "bool r (false);"
+       << "while (s.more () && _parse (s.peek (), s))" << endl
+       << "r = true;"
+       << "return r;"
+       << "}";
+  }
+
   ctx.ns_close (ctx.cli);
 }
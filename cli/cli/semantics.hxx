@@ -6,6 +6,7 @@
 #define CLI_SEMANTICS_HXX
 
 #include "semantics/class.hxx"
+#include "semantics/commands.hxx"
 #include "semantics/doc.hxx"
 #include "semantics/elements.hxx"
 #include "semantics/expression.hxx"
@@ -0,0 +1,61 @@
+// file      : cli/semantics/arena.cxx
+// license   : MIT; see accompanying LICENSE file
+
+#include <new> // operator new/delete
+
+#include "arena.hxx"
+
+namespace semantics
+{
+  // Most units (for example, included ones) are small so start with a
+  // small chunk and double it up to the limit.
+  //
+  static std::size_t const min_chunk_size = 4096;
+  static std::size_t const max_chunk_size = 1024 * 1024;
+
+  arena::
+  ~arena ()
+  {
+    for (header* h (last_); h != 0; )
+    {
+      header* p (h->prev);
+      h->destroy (reinterpret_cast<char*> (h) + header_size);
+      h = p;
+    }
+
+    for (chunk* c (chunks_); c != 0; )
+    {
+      chunk* n (c->next);
+      operator delete (c);
+      c = n;
+    }
+  }
+
+  void* arena::
+  allocate (std::size_t n)
+  {
+    n = header_size + ((n + alignment - 1) & ~(alignment - 1));
+
+    if (static_cast<std::size_t> (end_ - free_) < n)
+    {
+      chunk_size_ = chunk_size_ == 0
+        ? min_chunk_size
+        : (chunk_size_ < max_chunk_size ? chunk_size_ * 2 : chunk_size_);
+
+      std::size_t s (chunk_header_size + n);
+      if (s < chunk_size_)
+        s = chunk_size_;
+
+      chunk* c (static_cast<chunk*> (operator new (s)));
+      c->next = chunks_;
+      chunks_ = c;
+
+      free_ = reinterpret_cast<char*> (c) + chunk_header_size;
+      end_ = reinterpret_cast<char*> (c) + s;
+    }
+
+    char* r (free_ + header_size);
+    free_ += n;
+    return r;
+  }
+}
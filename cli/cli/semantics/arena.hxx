@@ -0,0 +1,85 @@
+// file      : cli/semantics/arena.hxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef CLI_SEMANTICS_ARENA_HXX
+#define CLI_SEMANTICS_ARENA_HXX
+
+#include <cstddef> // std::size_t, std::max_align_t
+
+namespace semantics
+{
+  // Bump-pointer arena for the semantic graph nodes and edges. Objects are
+  // allocated contiguously in chunks of increasing size and are destroyed,
+  // in the reverse order of construction, and freed in bulk together with
+  // the arena.
+  //
+  class arena
+  {
+  public:
+    arena ()
+        : chunks_ (0), free_ (0), end_ (0), last_ (0), chunk_size_ (0)
+    {
+    }
+
+    ~arena ();
+
+    // Allocate memory for an object of the specified size. Once the object
+    // is constructed, it should be registered for destruction with
+    // constructed(). If construction fails, the memory is simply left
+    // unused.
+    //
+    void*
+    allocate (std::size_t);
+
+    template <typename T>
+    T&
+    constructed (T& x)
+    {
+      header* h (reinterpret_cast<header*> (
+                   reinterpret_cast<char*> (&x) - header_size));
+      h->destroy = &destroy<T>;
+      h->prev = last_;
+      last_ = h;
+      return x;
+    }
+
+  private:
+    arena (arena const&);
+    arena& operator= (arena const&);
+
+    template <typename T>
+    static void
+    destroy (void* p)
+    {
+      static_cast<T*> (p)->~T ();
+    }
+
+    struct chunk
+    {
+      chunk* next;
+    };
+
+    struct header
+    {
+      void (*destroy) (void*);
+      header* prev;
+    };
+
+    static std::size_t const alignment = alignof (std::max_align_t);
+
+    static std::size_t const header_size =
+      (sizeof (header) + alignment - 1) & ~(alignment - 1);
+
+    static std::size_t const chunk_header_size =
+      (sizeof (chunk) + alignment - 1) & ~(alignment - 1);
+
+  private:
+    chunk* chunks_;
+    char* free_;
+    char* end_;
+    header* last_; // Last constructed object.
+    std::size_t chunk_size_;
+  };
+}
+
+#endif // CLI_SEMANTICS_ARENA_HXX
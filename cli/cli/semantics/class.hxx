@@ -5,6 +5,7 @@
 #ifndef CLI_SEMANTICS_CLASS_HXX
 #define CLI_SEMANTICS_CLASS_HXX
 
+#include <set>
 #include <vector>
 
 #include "elements.hxx"
@@ -79,6 +80,24 @@ namespace semantics
       return inherits_.end ();
     }
 
+    // C++ member names of the generated class that have been taken by the
+    // name processor.
+    //
+  public:
+    typedef std::set<string> name_set;
+
+    name_set&
+    cxx_member_names ()
+    {
+      return cxx_member_names_;
+    }
+
+    name_set const&
+    cxx_member_names () const
+    {
+      return cxx_member_names_;
+    }
+
   public:
     class_ (path const& file, size_t line, size_t column)
         : node (file, line, column), abstract_ (false)
@@ -100,6 +119,7 @@ namespace semantics
   private:
     bool abstract_;
     inherits_list inherits_;
+    name_set cxx_member_names_;
   };
 }
 
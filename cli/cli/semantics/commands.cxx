@@ -0,0 +1,26 @@
+// file      : cli/semantics/commands.cxx
+// license   : MIT; see accompanying LICENSE file
+
+#include <libcutl/compiler/type-info.hxx>
+
+#include "commands.hxx"
+
+namespace semantics
+{
+  // type info
+  //
+  namespace
+  {
+    struct init
+    {
+      init ()
+      {
+        using compiler::type_info;
+
+        type_info ti (typeid (commands));
+        ti.add_base (typeid (nameable));
+        insert (ti);
+      }
+    } init_;
+  }
+}
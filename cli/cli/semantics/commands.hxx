@@ -0,0 +1,71 @@
+// file      : cli/semantics/commands.hxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef CLI_SEMANTICS_COMMANDS_HXX
+#define CLI_SEMANTICS_COMMANDS_HXX
+
+#include <vector>
+
+#include "elements.hxx"
+
+namespace semantics
+{
+  class class_;
+
+  // Command group. Each command has an options class and one or more
+  // names, the first of which is the primary name.
+  //
+  class commands: public nameable
+  {
+  public:
+    struct command
+    {
+      class_* options;
+      std::vector<string> names;
+    };
+
+    typedef std::vector<command> command_list;
+
+    command_list&
+    list ()
+    {
+      return commands_;
+    }
+
+    command_list const&
+    list () const
+    {
+      return commands_;
+    }
+
+    // C++ enumerator names assigned to the commands by the name processor,
+    // in the command order.
+    //
+  public:
+    typedef std::vector<string> strings;
+
+    strings&
+    cxx_enumerators ()
+    {
+      return cxx_enumerators_;
+    }
+
+    strings const&
+    cxx_enumerators () const
+    {
+      return cxx_enumerators_;
+    }
+
+  public:
+    commands (path const& file, size_t line, size_t column)
+        : node (file, line, column)
+    {
+    }
+
+  private:
+    command_list commands_;
+    strings cxx_enumerators_;
+  };
+}
+
+#endif // CLI_SEMANTICS_COMMANDS_HXX
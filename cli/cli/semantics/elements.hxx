@@ -16,7 +16,6 @@
 
 #include <libcutl/fs/path.hxx>
 
-#include <libcutl/container/graph.hxx>
 #include <libcutl/container/pointer-iterator.hxx>
 
 #include <libcutl/compiler/context.hxx>
@@ -28,7 +27,6 @@ namespace semantics
   using std::size_t;
   using std::string;
 
-  using container::graph;
   using container::pointer_iterator;
 
   using compiler::context;
@@ -277,6 +275,21 @@ namespace semantics
       return *named_;
     }
 
+    // Name of the corresponding C++ entity assigned by the name processor.
+    //
+  public:
+    string const&
+    cxx_name () const
+    {
+      return cxx_name_;
+    }
+
+    void
+    cxx_name (string const& n)
+    {
+      cxx_name_ = n;
+    }
+
   public:
     nameable ()
         : named_ (0)
@@ -301,6 +314,7 @@ namespace semantics
 
   private:
     names* named_;
+    string cxx_name_;
   };
 
 
@@ -161,6 +161,105 @@ namespace semantics
       return doc_;
     }
 
+    // Option attributes, for example, [separator = ',']. The attribute
+    // value is stored as it appears in the source (for example, ',' for
+    // a character literal) and is empty if the attribute has no value.
+    //
+  public:
+    typedef std::map<string, string> attribute_map;
+
+    bool
+    attribute_p (string const& n) const
+    {
+      return attributes_.find (n) != attributes_.end ();
+    }
+
+    string const&
+    attribute (string const& n) const
+    {
+      attribute_map::const_iterator i (attributes_.find (n));
+      assert (i != attributes_.end ());
+      return i->second;
+    }
+
+    attribute_map const&
+    attributes () const
+    {
+      return attributes_;
+    }
+
+    attribute_map&
+    attributes ()
+    {
+      return attributes_;
+    }
+
+    // Names of the C++ members and accessors assigned by the name
+    // processor (see also nameable::cxx_name()). The specifier names are
+    // empty unless specifiers are generated for the option. The default
+    // and materialized names are empty unless the option is lazy.
+    //
+  public:
+    string const&
+    cxx_member () const
+    {
+      return cxx_member_;
+    }
+
+    void
+    cxx_member (string const& n)
+    {
+      cxx_member_ = n;
+    }
+
+    string const&
+    cxx_specifier () const
+    {
+      return cxx_specifier_;
+    }
+
+    void
+    cxx_specifier (string const& n)
+    {
+      cxx_specifier_ = n;
+    }
+
+    string const&
+    cxx_specifier_member () const
+    {
+      return cxx_specifier_member_;
+    }
+
+    void
+    cxx_specifier_member (string const& n)
+    {
+      cxx_specifier_member_ = n;
+    }
+
+    string const&
+    cxx_default () const
+    {
+      return cxx_default_;
+    }
+
+    void
+    cxx_default (string const& n)
+    {
+      cxx_default_ = n;
+    }
+
+    string const&
+    cxx_materialized_member () const
+    {
+      return cxx_materialized_member_;
+    }
+
+    void
+    cxx_materialized_member (string const& n)
+    {
+      cxx_materialized_member_ = n;
+    }
+
   public:
     option (path const& file, size_t line, size_t column)
         : node (file, line, column), initialized_ (0)
@@ -183,6 +282,13 @@ namespace semantics
     belongs_type* belongs_;
     initialized_type* initialized_;
     doc_strings doc_;
+    attribute_map attributes_;
+
+    string cxx_member_;
+    string cxx_specifier_;
+    string cxx_specifier_member_;
+    string cxx_default_;
+    string cxx_materialized_member_;
   };
 }
 
@@ -2,12 +2,93 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#include <set>
+#include <vector>
+
 #include <libcutl/compiler/type-info.hxx>
 
 #include "unit.hxx"
 
 namespace semantics
 {
+  // cli_unit
+  //
+  static void
+  collect_units (cli_unit& u,
+                 std::vector<cli_unit*>& units,
+                 std::set<cli_unit*>& visited)
+  {
+    if (!visited.insert (&u).second)
+      return;
+
+    units.push_back (&u);
+
+    for (cli_unit::includes_iterator i (u.includes_begin ());
+         i != u.includes_end (); ++i)
+    {
+      if (cli_includes* ci = dynamic_cast<cli_includes*> (&*i))
+        collect_units (ci->includee (), units, visited);
+    }
+  }
+
+  void cli_unit::
+  build_index ()
+  {
+    index_.clear ();
+
+    // Enter the units in the order in which lookup() examines them: this
+    // unit first followed by its includes, depth-first.
+    //
+    std::vector<cli_unit*> units;
+    {
+      std::set<cli_unit*> visited;
+      collect_units (*this, units, visited);
+    }
+
+    for (std::vector<cli_unit*>::const_iterator i (units.begin ());
+         i != units.end (); ++i)
+      index_names_ (**i, "");
+
+    indexed_ = true;
+  }
+
+  void cli_unit::
+  index_names_ (semantics::scope& s, string const& fq)
+  {
+    // Enter each name in the order in which scope::find() returns it.
+    //
+    for (scope::names_iterator i (s.names_begin ()); i != s.names_end (); ++i)
+    {
+      for (names::name_iterator j (i->name_begin ()); j != i->name_end (); ++j)
+        index_[fq + "::" + *j].push_back (&i->named ());
+    }
+
+    // Then descend into inner scopes. As in lookup(), a qualified name only
+    // resolves through the first scope with the corresponding name.
+    //
+    std::set<string> seen;
+
+    for (scope::names_iterator i (s.names_begin ()); i != s.names_end (); ++i)
+    {
+      for (names::name_iterator j (i->name_begin ()); j != i->name_end (); ++j)
+      {
+        if (!seen.insert (*j).second)
+          continue;
+
+        scope::names_iterator_pair ip (s.find (*j));
+
+        for (; ip.first != ip.second; ++ip.first)
+        {
+          if (scope* c = dynamic_cast<scope*> (&ip.first->named ()))
+          {
+            index_names_ (*c, fq + "::" + *j);
+            break;
+          }
+        }
+      }
+    }
+  }
+
   // type info
   //
   namespace
@@ -6,9 +6,13 @@
 #define CLI_SEMANTICS_UNIT_HXX
 
 #include <map>
+#include <set>
+#include <new>    // placement new
 #include <vector>
 #include <string>
+#include <unordered_map>
 
+#include "arena.hxx"
 #include "elements.hxx"
 #include "namespace.hxx"
 
@@ -134,7 +138,11 @@ namespace semantics
 
   //
   //
-  class cli_unit: public graph<node, edge>, public namespace_
+  // The root unit owns all the nodes and edges of the semantic graph
+  // (including the included units). They are allocated in the unit's
+  // arena and destroyed together with it.
+  //
+  class cli_unit: public namespace_
   {
     typedef std::vector<includes*> includes_list;
 
@@ -156,6 +164,15 @@ namespace semantics
             std::string const& name,
             bool outer = true);
 
+    // Build the qualified name index over this unit and all the units that
+    // it includes, transitively, visiting each unit once. Once the index is
+    // built, lookup() is a hash probe per scope level instead of a walk over
+    // the include graph. Adding edges through this unit drops the index so
+    // it should only be built once the graph is complete.
+    //
+    void
+    build_index ();
+
   public:
     typedef
     pointer_iterator<includes_list::const_iterator>
@@ -175,7 +192,7 @@ namespace semantics
 
   public:
     cli_unit (path const& file, size_t line, size_t column)
-        : node (file, line, column), graph_ (*this)
+        : node (file, line, column), indexed_ (false)
     {
       // Use a special edge to get this->name() return the global
       // namespace name ("").
@@ -188,14 +205,16 @@ namespace semantics
     T&
     new_node (path const& file, size_t line, size_t column)
     {
-      return graph_.new_node<T> (file, line, column);
+      return arena_.constructed (
+        *new (arena_.allocate (sizeof (T))) T (file, line, column));
     }
 
     template <typename T, typename A0>
     T&
     new_node (path const& file, size_t line, size_t column, A0 const& a0)
     {
-      return graph_.new_node<T> (file, line, column, a0);
+      return arena_.constructed (
+        *new (arena_.allocate (sizeof (T))) T (file, line, column, a0));
     }
 
     template <typename T, typename A0, typename A1>
@@ -203,7 +222,8 @@ namespace semantics
     new_node (path const& file, size_t line, size_t column,
               A0 const& a0, A1 const& a1)
     {
-      return graph_.new_node<T> (file, line, column, a0, a1);
+      return arena_.constructed (
+        *new (arena_.allocate (sizeof (T))) T (file, line, column, a0, a1));
     }
 
     template <typename T, typename A0, typename A1, typename A2>
@@ -211,7 +231,9 @@ namespace semantics
     new_node (path const& file, size_t line, size_t column,
               A0 const& a0, A1 const& a1, A2 const& a2)
     {
-      return graph_.new_node<T> (file, line, column, a0, a1, a2);
+      return arena_.constructed (
+        *new (arena_.allocate (sizeof (T))) T (
+          file, line, column, a0, a1, a2));
     }
 
     template <typename T, typename A0, typename A1, typename A2, typename A3>
@@ -219,7 +241,66 @@ namespace semantics
     new_node (path const& file, size_t line, size_t column,
               A0 const& a0, A1 const& a1, A2 const& a2, A3 const& a3)
     {
-      return graph_.new_node<T> (file, line, column, a0, a1, a2, a3);
+      return arena_.constructed (
+        *new (arena_.allocate (sizeof (T))) T (
+          file, line, column, a0, a1, a2, a3));
+    }
+
+  public:
+    template <typename T, typename L, typename R>
+    T&
+    new_edge (L& l, R& r)
+    {
+      return connect (
+        l, r, arena_.constructed (*new (arena_.allocate (sizeof (T))) T));
+    }
+
+    template <typename T, typename L, typename R, typename A0>
+    T&
+    new_edge (L& l, R& r, A0 const& a0)
+    {
+      return connect (
+        l, r, arena_.constructed (*new (arena_.allocate (sizeof (T))) T (a0)));
+    }
+
+    template <typename T, typename L, typename R, typename A0, typename A1>
+    T&
+    new_edge (L& l, R& r, A0 const& a0, A1 const& a1)
+    {
+      return connect (
+        l, r,
+        arena_.constructed (*new (arena_.allocate (sizeof (T))) T (a0, a1)));
+    }
+
+    template <typename T, typename L, typename R,
+              typename A0, typename A1, typename A2>
+    T&
+    new_edge (L& l, R& r, A0 const& a0, A1 const& a1, A2 const& a2)
+    {
+      return connect (
+        l, r,
+        arena_.constructed (
+          *new (arena_.allocate (sizeof (T))) T (a0, a1, a2)));
+    }
+
+  private:
+    template <typename T, typename L, typename R>
+    T&
+    connect (L& l, R& r, T& e)
+    {
+      e.set_left_node (l);
+      e.set_right_node (r);
+
+      l.add_edge_left (e);
+      r.add_edge_right (e);
+
+      if (indexed_)
+      {
+        index_.clear ();
+        indexed_ = false;
+      }
+
+      return e;
     }
 
   public:
@@ -295,13 +376,31 @@ namespace semantics
     using namespace_::add_edge_left;
     using namespace_::add_edge_right;
 
+  private:
+    template <typename T>
+    T*
+    lookup_ (std::string const& scope,
+             std::string const& name,
+             std::set<cli_unit*>& visited);
+
+    void
+    index_names_ (semantics::scope&, string const& fq_name);
+
   private:
     typedef std::map<string, type*> type_map;
 
+    // Fully-qualified name to the nodes it resolves to, in the lookup
+    // order.
+    //
+    typedef std::vector<nameable*> nameables;
+    typedef std::unordered_map<string, nameables> name_index;
+
   private:
-    graph<node, edge>& graph_;
+    arena arena_;
     includes_list includes_;
     type_map types_;
+    name_index index_;
+    bool indexed_;
   };
 }
 
@@ -10,6 +10,50 @@ namespace semantics
   {
     using std::string;
 
+    // Search the starting scope and then, if requested, each outer scope
+    // up to and including the global namespace.
+    //
+    for (string s (ss);; s = string (s, 0, s.rfind ("::")))
+    {
+      if (indexed_)
+      {
+        name_index::const_iterator i (index_.find (s + "::" + name));
+
+        if (i != index_.end ())
+        {
+          for (nameables::const_iterator j (i->second.begin ());
+               j != i->second.end (); ++j)
+          {
+            if (T* r = dynamic_cast<T*> (*j))
+              return r;
+          }
+        }
+      }
+      else
+      {
+        std::set<cli_unit*> visited;
+
+        if (T* r = lookup_<T> (s, name, visited))
+          return r;
+      }
+
+      if (!outer || s.empty ())
+        break;
+    }
+
+    return 0;
+  }
+
+  template <typename T>
+  T* cli_unit::
+  lookup_ (std::string const& ss,
+           std::string const& name,
+           std::set<cli_unit*>& visited)
+  {
+    using std::string;
+
+    visited.insert (this);
+
     // Resolve the starting scope in this unit, if any.
     //
     string::size_type b (0), e;
@@ -85,22 +129,21 @@ namespace semantics
     }
 
     // If we are here, then that means the lookup didn't find anything in
-    // this unit. The next step is to examine all the included units.
+    // this unit. The next step is to examine all the included units. A
+    // unit that is included more than once has already been examined.
     //
     for (includes_iterator i (includes_begin ()); i != includes_end (); ++i)
     {
       if (cli_includes* ci = dynamic_cast<cli_includes*> (&*i))
-        if (T* r = ci->includee ().lookup<T> (ss, name, false))
-          return r;
-    }
+      {
+        cli_unit& u (ci->includee ());
 
-    // If we still haven't found anything, then the next step is to search
-    // one-outer scope, unless it is the global namespace.
-    //
-    if (outer && !ss.empty ())
-    {
-      string n (ss, 0, ss.rfind ("::"));
-      return lookup<T> (n, name, true);
+        if (visited.find (&u) == visited.end ())
+        {
+          if (T* r = u.lookup_<T> (ss, name, visited))
+            return r;
+        }
+      }
     }
 
     return 0;
@@ -0,0 +1,348 @@
+// file      : cli/server.cxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef _WIN32
+#  include <signal.h>     // signal(), raise()
+#  include <unistd.h>     // read(), write(), close(), unlink()
+#  include <sys/types.h>
+#  include <sys/stat.h>   // lstat(), umask()
+#  include <sys/socket.h> // socket(), bind(), listen(), accept()
+#  include <sys/un.h>     // sockaddr_un
+#endif
+
+#include <cerrno>
+#include <cstring>  // memset(), strerror()
+#include <set>
+#include <mutex>
+#include <thread>
+#include <sstream>
+#include <condition_variable>
+#include <streambuf>
+
+#include "server.hxx"
+
+using namespace std;
+
+server::
+server (handler const& h)
+    : handler_ (h)
+{
+#ifndef _WIN32
+  // Clients that disconnect before receiving the response (or close the
+  // pipe in the stdin/stdout mode) should not terminate the server.
+  //
+  signal (SIGPIPE, SIG_IGN);
+#endif
+}
+
+void server::
+serve (istream& is, ostream& os)
+{
+  for (;;)
+  {
+    // Read the request arguments. End the session on an incomplete or
+    // malformed request.
+    //
+    vector<string> args;
+
+    for (;;)
+    {
+      int c (is.get ());
+
+      if (c == '\n')
+        break;
+
+      if (c < '0' || c > '9')
+        return;
+
+      size_t n (0);
+      for (; c >= '0' && c <= '9'; c = is.get ())
+      {
+        if (n > 0xFFFFFFF)
+          return;
+
+        n = n * 10 + static_cast<size_t> (c - '0');
+      }
+
+      if (c != ' ')
+        return;
+
+      string a (n, '\0');
+
+      if (n != 0 && !is.read (&a[0], static_cast<streamsize> (n)))
+        return;
+
+      if (is.get () != '\n')
+        return;
+
+      args.push_back (move (a));
+    }
+
+    ostringstream out, diag;
+    int r (handler_ (args, out, diag));
+
+    string const& o (out.str ());
+    string const& d (diag.str ());
+
+    os << r << ' ' << o.size () << ' ' << d.size () << '\n' << o << d;
+    os.flush ();
+
+    if (!os)
+      return;
+  }
+}
+
+#ifndef _WIN32
+
+namespace
+{
+  // Stream buffer for a socket.
+  //
+  class fdbuf: public streambuf
+  {
+  public:
+    explicit
+    fdbuf (int fd)
+        : fd_ (fd)
+    {
+      setg (ibuf_, ibuf_, ibuf_);
+      setp (obuf_, obuf_ + sizeof (obuf_));
+    }
+
+  protected:
+    virtual int_type
+    underflow ()
+    {
+      ssize_t n;
+      while ((n = read (fd_, ibuf_, sizeof (ibuf_))) < 0 && errno == EINTR) ;
+
+      if (n <= 0)
+        return traits_type::eof ();
+
+      setg (ibuf_, ibuf_, ibuf_ + n);
+      return traits_type::to_int_type (*gptr ());
+    }
+
+    virtual int_type
+    overflow (int_type c)
+    {
+      if (!flush ())
+        return traits_type::eof ();
+
+      if (!traits_type::eq_int_type (c, traits_type::eof ()))
+      {
+        *pptr () = traits_type::to_char_type (c);
+        pbump (1);
+      }
+
+      return traits_type::not_eof (c);
+    }
+
+    virtual int
+    sync ()
+    {
+      return flush () ? 0 : -1;
+    }
+
+  private:
+    bool
+    flush ()
+    {
+      for (char* p (pbase ()); p != pptr (); )
+      {
+        ssize_t n (write (fd_, p, pptr () - p));
+
+        if (n < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          return false;
+        }
+
+        p += n;
+      }
+
+      setp (obuf_, obuf_ + sizeof (obuf_));
+      return true;
+    }
+
+  private:
+    int fd_;
+    char ibuf_[4096];
+    char obuf_[4096];
+  };
+
+  // Path of the socket that the server is listening on, if any. It is
+  // removed if the server is terminated with a signal.
+  //
+  char socket_path[sizeof (sockaddr_un::sun_path)];
+
+  extern "C" void
+  handle_termination (int sig)
+  {
+    // Only async-signal-safe functions from here on.
+    //
+    if (socket_path[0] != '\0')
+      unlink (socket_path);
+
+    signal (sig, SIG_DFL);
+    raise (sig);
+  }
+
+  // Sessions in progress. We keep track of them (and of their connections)
+  // so that we can end them and wait for their completion before returning
+  // from listen() since they refer to the server (and whatever the handler
+  // refers to).
+  //
+  struct sessions
+  {
+    mutex m;
+    condition_variable cv;
+    set<int> fds; // Connections of the sessions in progress.
+
+    // Shut down the connections and wait for the sessions to complete.
+    //
+    void
+    stop ()
+    {
+      unique_lock<mutex> l (m);
+
+      for (int fd: fds)
+        shutdown (fd, SHUT_RDWR);
+
+      cv.wait (l, [this] {return fds.empty ();});
+    }
+  };
+}
+
+void server::
+listen (string const& path, ostream& diag)
+{
+  sockaddr_un a;
+  memset (&a, 0, sizeof (a));
+  a.sun_family = AF_UNIX;
+
+  if (path.size () >= sizeof (a.sun_path))
+  {
+    diag << "error: socket path '" << path << "' is too long" << endl;
+    throw failed ();
+  }
+
+  strcpy (a.sun_path, path.c_str ());
+
+  int s (socket (AF_UNIX, SOCK_STREAM, 0));
+
+  if (s < 0)
+  {
+    diag << "error: unable to create socket: " << strerror (errno) << endl;
+    throw failed ();
+  }
+
+  // Only replace a socket (presumably left behind by a previous server)
+  // rather than any file that happens to be at this path.
+  //
+  struct stat st;
+  if (lstat (path.c_str (), &st) == 0)
+  {
+    if (!S_ISSOCK (st.st_mode))
+    {
+      diag << "error: '" << path << "' exists and is not a socket" << endl;
+      close (s);
+      throw failed ();
+    }
+
+    unlink (path.c_str ());
+  }
+  else if (errno != ENOENT)
+  {
+    diag << "error: unable to stat '" << path << "': " << strerror (errno)
+         << endl;
+    close (s);
+    throw failed ();
+  }
+
+  // Since the server writes files on behalf of the clients, only allow the
+  // owner to connect.
+  //
+  mode_t m (umask (0077));
+  int r (bind (s, reinterpret_cast<sockaddr*> (&a), sizeof (a)));
+  umask (m);
+
+  if (r != 0 || ::listen (s, 16) != 0)
+  {
+    diag << "error: unable to listen on '" << path << "': "
+         << strerror (errno) << endl;
+
+    if (r == 0)
+      unlink (path.c_str ());
+
+    close (s);
+    throw failed ();
+  }
+
+  // Remove the socket when the server exits, normally by being terminated.
+  //
+  strcpy (socket_path, path.c_str ());
+  signal (SIGTERM, &handle_termination);
+  signal (SIGINT, &handle_termination);
+  signal (SIGHUP, &handle_termination);
+
+  sessions ss;
+
+  for (;;)
+  {
+    int c (accept (s, 0, 0));
+
+    if (c < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+
+      diag << "error: unable to accept connection: " << strerror (errno)
+           << endl;
+      close (s);
+      unlink (path.c_str ());
+      socket_path[0] = '\0';
+      ss.stop ();
+      throw failed ();
+    }
+
+    {
+      lock_guard<mutex> l (ss.m);
+      ss.fds.insert (c);
+    }
+
+    thread ([this, c, &ss] ()
+            {
+              {
+                fdbuf b (c);
+                istream is (&b);
+                ostream os (&b);
+                serve (is, os);
+              }
+
+              // Close the connection while holding the lock so that stop()
+              // cannot shut down its descriptor reused by another
+              // connection. Notify the waiter (if any) only after this
+              // thread has released everything, including the lock.
+              //
+              unique_lock<mutex> l (ss.m);
+              ss.fds.erase (c);
+              close (c);
+              notify_all_at_thread_exit (ss.cv, move (l));
+            }).detach ();
+  }
+}
+
+#else
+
+void server::
+listen (string const&, ostream& diag)
+{
+  diag << "error: UNIX domain sockets are not supported on this platform"
+       << endl;
+  throw failed ();
+}
+
+#endif
@@ -0,0 +1,74 @@
+// file      : cli/server.hxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef CLI_SERVER_HXX
+#define CLI_SERVER_HXX
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <functional>
+
+// Compiler server (see --server). A client sends compile requests each
+// consisting of the command line arguments (without the program name), one
+// per line, terminated by an empty line. Each argument line is in the form:
+//
+// <size> <argument>
+//
+// Where <size> is the number of bytes in <argument>, which can therefore be
+// empty or contain newlines. For each request the server sends
+// back the response that starts with the line in the form:
+//
+// <status> <output-size> <diagnostics-size>
+//
+// Where <status> is the exit status of the equivalent cli invocation and
+// the sizes are the number of bytes of the output it would have written to
+// STDOUT and of its diagnostics. This line is followed by the output and
+// then the diagnostics. The requests of a session are handled in order and
+// the session ends when the client closes its end of the connection.
+//
+class server
+{
+public:
+  // Handle the request writing the output and diagnostics to the specified
+  // streams and returning the exit status. The handler may be called
+  // concurrently for requests of different sessions.
+  //
+  typedef std::function<int (std::vector<std::string> const& args,
+                             std::ostream& out,
+                             std::ostream& diag)> handler;
+
+  server (handler const&);
+
+  class failed {};
+
+  // Handle the requests read from the input stream writing responses to
+  // the output stream until the end of the input stream.
+  //
+  void
+  serve (std::istream&, std::ostream&);
+
+  // Accept connections on the UNIX domain socket handling each in a
+  // separate session. The socket is only accessible by the owner. An
+  // existing socket at the socket path is replaced (but not any other
+  // file) and the socket is removed when the server is terminated with
+  // SIGTERM, SIGINT, or SIGHUP.
+  // Only return (by throwing failed) if unable to create the socket or to
+  // accept a connection, in which case the sessions in progress are ended
+  // and waited for.
+  //
+  void
+  listen (std::string const& socket, std::ostream& diag);
+
+private:
+  server (server const&);
+
+  server&
+  operator= (server const&);
+
+private:
+  handler handler_;
+};
+
+#endif // CLI_SERVER_HXX
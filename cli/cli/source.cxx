@@ -2,6 +2,7 @@
 // author    : Boris Kolpackov <boris@codesynthesis.com>
 // license   : MIT; see accompanying LICENSE file
 
+#include <sstream>
 #include <iostream>
 
 #include "source.hxx"
@@ -30,7 +31,13 @@ namespace
 
       os << emember (o);
 
-      if (o.initialized_p ())
+      // Lazy members are materialized from the default value constant (see
+      // option_lazy below) on the first modification.
+      //
+      if (lazy (o))
+        os << " ()," << endl
+           << "  " << ematerialized_member (o) << " (false)";
+      else if (o.initialized_p ())
       {
         using semantics::expression;
         expression const& i (o.initializer ());
@@ -80,15 +87,73 @@ namespace
       string spec_member (b ? member : especifier_member (o));
 
       os << "if (a." << spec_member << ")"
-         << "{"
-         <<   cli << "::parser< " << type << ">::merge (" << endl
-         <<     "this->" << member << ", a." << member << ");";
+         << "{";
+
+      if (lazy (o))
+      {
+        string m (ematerialized_member (o));
+
+        os << "if (!this->" << m << ")"
+           << "{"
+           << "this->" << member << " = " << edefault (o) << " ();"
+           << "this->" << m << " = true;"
+           << "}"
+           <<   cli << "::parser< " << type << " >::merge (" << endl
+           <<     "this->" << member << ", a." << ename (o) << " ());";
+      }
+      else
+        os <<   cli << "::parser< " << type << " >::merge (" << endl
+           <<     "this->" << member << ", a." << member << ");";
+
       if (!b)
         os << "this->" << spec_member << " = true;";
       os << "}";
     }
   };
 
+  // Emit the name of the function that parses the option value.
+  //
+  void
+  option_thunk (context& c, semantics::option& o)
+  {
+    ostream& os (c.os);
+
+    string member (c.emember (o));
+    string type (o.type ().name ());
+    string scope (c.escape (o.scope ().name ()));
+
+    // Lazy options go through the thunk that materializes the member first
+    // (see option_lazy below).
+    //
+    if (c.lazy (o))
+    {
+      os << "_cli_" << scope << "_" << member << "thunk";
+      return;
+    }
+
+    // List options (those with the separator attribute) are parsed with the
+    // list thunk that splits the value into elements.
+    //
+    bool list (o.attribute_p ("separator"));
+
+    os << c.cli << "::" << (list ? "list_thunk" : "thunk")
+       << "< " << scope;
+
+    if (type != "bool")
+      os << ", " << type;
+
+    os << ", " << "&" << scope << "::" << member;
+
+    if (c.gen_specifier && type != "bool")
+      os << "," << endl
+         << "  &" << scope << "::" << c.especifier_member (o);
+
+    if (list)
+      os << ", " << o.attribute ("separator");
+
+    os << " >";
+  }
+
   //
   //
   struct option_map: traversal::option, context
@@ -100,29 +165,105 @@ namespace
     {
       using semantics::names;
 
-      string member (emember (o));
-      string type (o.type ().name ());
       string scope (escape (o.scope ().name ()));
-      string map ("_cli_" + scope + "_map_");
 
       names& n (o.named ());
 
       for (names::name_iterator i (n.name_begin ()); i != n.name_end (); ++i)
       {
         os << "_cli_" << scope << "_map_[\"" << *i << "\"] =" << endl
-           << "&" << cli << "::thunk< " << scope;
+           << "&";
+        option_thunk (*this, o);
+        os << ";";
+      }
+    }
+  };
+
+  // Collect the class's own options by name.
+  //
+  typedef std::map<string, semantics::option*> option_names;
 
-        if (type != "bool")
-          os << ", " << type;
+  struct option_name: traversal::option
+  {
+    option_name (option_names& n): names_ (n) {}
 
-        os << ", " << "&" << scope << "::" << member;
+    virtual void
+    traverse (type& o)
+    {
+      using semantics::names;
 
-        if (gen_specifier && type != "bool")
-          os << "," << endl
-             << "  &" << scope << "::" << especifier_member (o);
+      names& n (o.named ());
 
-        os << " >;";
-      }
+      for (names::name_iterator i (n.name_begin ()); i != n.name_end (); ++i)
+        names_[*i] = &o;
+    }
+
+  private:
+    option_names& names_;
+  };
+
+  //
+  //
+  // Default value constant and materializing thunk for lazy options.
+  //
+  struct option_lazy: traversal::option, context
+  {
+    option_lazy (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      if (!lazy (o))
+        return;
+
+      using semantics::expression;
+
+      string member (emember (o));
+      string mat (ematerialized_member (o));
+      string type (o.type ().name ());
+      string scope (escape (o.scope ().name ()));
+      string def (edefault (o));
+
+      expression const& i (o.initializer ());
+
+      // Note that we use a function-local static to sidestep the static
+      // initialization order issues.
+      //
+      os << "const " << type << "& " << scope << "::" << endl
+         << def << " ()"
+         << "{"
+         << "static const " << type << " d";
+
+      if (i.type () == expression::call_expr)
+        os << " " << i.value ();
+      else
+        os << " (" << i.value () << ")";
+
+      os << ";"
+         << "return d;"
+         << "}";
+
+      os << "static void" << endl
+         << "_cli_" << scope << "_" << member << "thunk (" <<
+        scope << "& x, " << cli << "::scanner& s)"
+         << "{"
+         << "if (!x." << mat << ")"
+         << "{"
+         << "x." << member << " = " << scope << "::" << def << " ();"
+         << "x." << mat << " = true;"
+         << "}"
+         << cli << "::" << (o.attribute_p ("separator") ? "list_thunk" : "thunk")
+         << "< " << scope << ", " << type << ", &" << scope << "::" << member;
+
+      if (gen_specifier)
+        os << "," << endl
+           << "  &" << scope << "::" << especifier_member (o);
+
+      if (o.attribute_p ("separator"))
+        os << ", " << o.attribute ("separator");
+
+      os << " > (x, s);"
+         << "}";
     }
   };
 
@@ -513,6 +654,287 @@ namespace
     paragraph& para_;
   };
 
+  // Collect the option names, including inherited, for the abbreviation
+  // table. The names of the same option get the same index. If the same
+  // name is found in several classes, then the first one in the _parse()
+  // lookup order wins.
+  //
+  typedef std::map<string, size_t> abbrev_names;
+
+  struct option_abbrev: traversal::option
+  {
+    option_abbrev (abbrev_names& n, size_t& i): names_ (n), index_ (i) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      semantics::names& n (o.named ());
+
+      for (semantics::names::name_iterator i (n.name_begin ());
+           i != n.name_end ();
+           ++i)
+        names_.insert (abbrev_names::value_type (*i, index_));
+
+      index_++;
+    }
+
+  private:
+    abbrev_names& names_;
+    size_t& index_;
+  };
+
+  struct class_abbrev: traversal::class_
+  {
+    class_abbrev (abbrev_names& n, size_t& i)
+        : option_ (n, i)
+    {
+      names_ >> option_;
+      inherits_ >> *this;
+    }
+
+    virtual void
+    traverse (type& c)
+    {
+      names (c, names_);
+      inherits (c, inherits_);
+    }
+
+  private:
+    option_abbrev option_;
+    traversal::names names_;
+    traversal::inherits inherits_;
+  };
+
+  // 32-bit FNV-1a hash with the specified offset basis.
+  //
+  unsigned long
+  fnv_hash (string const& s, unsigned long h = 2166136261UL)
+  {
+    for (size_t i (0); i != s.size (); ++i)
+      h = ((h ^ static_cast<unsigned char> (s[i])) * 16777619UL) &
+        0xFFFFFFFFUL;
+
+    return h;
+  }
+
+  // Collect the snapshot schema of the class, that is, the types and names
+  // of its options, including inherited, in the order they are saved.
+  //
+  struct option_schema: traversal::option, context
+  {
+    option_schema (context& c, string& s): context (c), schema_ (s) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      string type (o.type ().name ());
+
+      schema_ += type + ' ' + o.name ();
+
+      if (gen_specifier && type != "bool")
+        schema_ += '?';
+
+      schema_ += ';';
+    }
+
+  private:
+    string& schema_;
+  };
+
+  struct class_schema: traversal::class_
+  {
+    class_schema (context& c, string& s)
+        : option_ (c, s)
+    {
+      names_ >> option_;
+      inherits_ >> *this;
+    }
+
+    virtual void
+    traverse (type& c)
+    {
+      inherits (c, inherits_);
+      names (c, names_);
+    }
+
+  private:
+    option_schema option_;
+    traversal::names names_;
+    traversal::inherits inherits_;
+  };
+
+  // Save/load the option values and specifiers into/from the snapshot.
+  //
+  struct option_snapshot: traversal::option, context
+  {
+    option_snapshot (context& c, bool save): context (c), save_ (save) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      string type (o.type ().name ());
+      string member (emember (o));
+      string t (cli + "::snapshot< " + type + " >");
+      string tb (cli + "::snapshot< bool >");
+
+      bool l (lazy (o));
+      bool sp (gen_specifier && type != "bool");
+
+      if (save_)
+      {
+        // Lazy members may still be unmaterialized so go through the
+        // accessor.
+        //
+        os << t << "::save (b, this->" <<
+          (l ? ename (o) + " ()" : member) << ");";
+
+        if (sp)
+          os << tb << "::save (b, this->" << especifier_member (o) << ");";
+      }
+      else
+      {
+        os << t << "::load (p, e, this->" << member << ");";
+
+        if (l)
+          os << "this->" << ematerialized_member (o) << " = true;";
+
+        if (sp)
+          os << tb << "::load (p, e, this->" << especifier_member (o) << ");";
+      }
+    }
+
+  private:
+    bool save_;
+  };
+
+  // Compare/hash the option values and specifiers.
+  //
+  struct option_hash: traversal::option, context
+  {
+    option_hash (context& c, bool hash): context (c), hash_ (hash) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      if (o.attribute_p ("transient"))
+        return;
+
+      string type (o.type ().name ());
+      bool sp (gen_specifier && type != "bool");
+
+      // Lazy members may still be unmaterialized so go through the
+      // accessor.
+      //
+      string v (lazy (o) ? ename (o) + " ()" : emember (o));
+
+      if (hash_)
+      {
+        os << cli << "::hash_combine (" << endl
+           << "h, " << cli << "::hasher< " << type << " >::hash (this->" <<
+          v << "));";
+
+        if (sp)
+          os << cli << "::hash_combine (h, this->" <<
+            especifier_member (o) << " ? 1 : 0);";
+      }
+      else
+      {
+        os << "if (!(this->" << v << " == x." << v << "))" << endl
+           << "return false;"
+           << endl;
+
+        if (sp)
+        {
+          string const& s (especifier_member (o));
+          os << "if (this->" << s << " != x." << s << ")" << endl
+             << "return false;"
+             << endl;
+        }
+      }
+    }
+
+  private:
+    bool hash_;
+  };
+
+  struct base_hash: traversal::class_, context
+  {
+    base_hash (context& c, bool hash): context (c), hash_ (hash) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      os << "// " << escape (c.name ()) << " base" << endl
+         << "//" << endl;
+
+      if (hash_)
+        os << fq_name (c) << "::_hash (h);"
+           << endl;
+      else
+        os << "if (!" << fq_name (c) << "::operator== (x))" << endl
+           << "return false;"
+           << endl;
+    }
+
+  private:
+    bool hash_;
+  };
+
+  // Serialize the specified options.
+  //
+  struct option_argv: traversal::option, context
+  {
+    option_argv (context& c): context (c) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      string type (o.type ().name ());
+      string v (lazy (o) ? ename (o) + " ()" : emember (o));
+
+      if (type == "bool")
+        os << "if (this->" << v << ")" << endl
+           << "b.option (\"" << o.name () << "\");"
+           << endl;
+      else
+        os << "if (this->" << especifier_member (o) << ")" << endl
+           << cli << "::serializer< " << type << " >::write (" << endl
+           << "b, \"" << o.name () << "\", this->" << v << ");"
+           << endl;
+    }
+  };
+
+  struct base_argv: traversal::class_, context
+  {
+    base_argv (context& c): context (c) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      os << "// " << escape (c.name ()) << " base" << endl
+         << "//" << endl
+         << fq_name (c) << "::_to_argv (b);"
+         << endl;
+    }
+  };
+
+  struct base_snapshot: traversal::class_, context
+  {
+    base_snapshot (context& c, bool save): context (c), save_ (save) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      os << "// " << escape (c.name ()) << " base" << endl
+         << "//" << endl
+         << fq_name (c) << (save_ ? "::_save (b);" : "::_load (p, e);")
+         << endl;
+    }
+
+  private:
+    bool save_;
+  };
+
   //
   //
   struct base_parse: traversal::class_, context
@@ -600,6 +1022,7 @@ namespace
           base_desc_ (c),
           option_merge_ (c),
           option_map_ (c),
+          option_lazy_ (c),
           option_desc_ (c)
     {
       inherits_base_parse_ >> base_parse_;
@@ -607,6 +1030,7 @@ namespace
       inherits_base_desc_ >> base_desc_;
       names_option_merge_ >> option_merge_;
       names_option_map_ >> option_map_;
+      names_option_lazy_ >> option_lazy_;
       names_option_desc_ >> option_desc_;
     }
 
@@ -738,6 +1162,24 @@ namespace
            << res << "_parse (s, opt, arg);"
            << ret
            << "}";
+
+        if (options.generate_dynamic_options ())
+        {
+          os << n << " (" << cli << "::scanner& s," << endl
+             << cli << "::dynamic_values& d," << endl
+             << um << " opt," << endl
+             << um << " arg)";
+          if (!p)
+          {
+            option_init init (*this);
+            traversal::names names_init (init);
+            names (c, names_init);
+          }
+          os << "{"
+             << res << "_parse (s, opt, arg, &d);"
+             << ret
+             << "}";
+        }
       }
 
       // merge()
@@ -761,6 +1203,169 @@ namespace
         os << "}";
       }
 
+      // operator==(), hash()
+      //
+      if (options.generate_hash ())
+      {
+        os << "bool " << name << "::" << endl
+           << "operator== (const " << name << "& x) const"
+           << "{"
+           << "CLI_POTENTIALLY_UNUSED (x);"
+           << endl;
+        {
+          base_hash bh (*this, false);
+          traversal::inherits ib (bh);
+          inherits (c, ib);
+
+          option_hash oh (*this, false);
+          traversal::names no (oh);
+          names (c, no);
+        }
+        os << "return true;"
+           << "}";
+
+        os << "std::size_t " << name << "::" << endl
+           << "hash () const"
+           << "{"
+           << "std::size_t h (0);"
+           << "_hash (h);"
+           << "return h;"
+           << "}";
+
+        os << "void " << name << "::" << endl
+           << "_hash (std::size_t& h) const"
+           << "{"
+           << "CLI_POTENTIALLY_UNUSED (h);"
+           << endl;
+        {
+          base_hash bh (*this, true);
+          traversal::inherits ib (bh);
+          inherits (c, ib);
+
+          option_hash oh (*this, true);
+          traversal::names no (oh);
+          names (c, no);
+        }
+        os << "}";
+      }
+
+      // to_argv(), to_options_file()
+      //
+      if (options.generate_argv ())
+      {
+        // The first pass calculates the size, the second writes.
+        //
+        os << "void " << name << "::" << endl
+           << "to_argv (" << cli << "::argv_buffer& b," << endl
+           << "const char* program) const"
+           << "{"
+           << "b.start (program);"
+           << "_to_argv (b);"
+           << "b.allocate ();"
+           << "_to_argv (b);"
+           << "}";
+
+        os << "void " << name << "::" << endl
+           << "to_options_file (std::string& s) const"
+           << "{"
+           << cli << "::options_file_buffer b (s);"
+           << "_to_argv (b);"
+           << "b.allocate ();"
+           << "_to_argv (b);"
+           << "}";
+
+        os << "void " << name << "::" << endl
+           << "_to_argv (" << cli << "::argument_sink& b) const"
+           << "{"
+           << "CLI_POTENTIALLY_UNUSED (b);"
+           << endl;
+        {
+          base_argv ba (*this);
+          traversal::inherits ib (ba);
+          inherits (c, ib);
+
+          option_argv oa (*this);
+          traversal::names no (oa);
+          names (c, no);
+        }
+        os << "}";
+      }
+
+      // save(), load()
+      //
+      if (options.generate_snapshot ())
+      {
+        string buf (cli + "::snapshot_buffer");
+
+        // The snapshot starts with the format version followed by the
+        // hash of the class schema.
+        //
+        string schema;
+        {
+          class_schema cs (*this, schema);
+          cs.traverse (c);
+        }
+
+        unsigned long h (fnv_hash (schema));
+
+        os << "void " << name << "::" << endl
+           << "save (" << buf << "& b) const"
+           << "{"
+           << "b.push_back (1);"
+           << cli << "::snapshot_save_size (b, " << h << "UL);"
+           << "_save (b);"
+           << "}";
+
+        os << "void " << name << "::" << endl
+           << "load (const void* d, std::size_t n)"
+           << "{"
+           << "const char* p (static_cast<const char*> (d));"
+           << "const char* e (p + n);"
+           << endl
+           << "if (p == e || *p++ != 1 ||" << endl
+           << cli << "::snapshot_load_size (p, e) != " << h << "UL)" << endl
+           << "throw " << cli << "::invalid_snapshot ();"
+           << endl
+           << "_load (p, e);"
+           << endl
+           << "if (p != e)" << endl
+           << "throw " << cli << "::invalid_snapshot ();"
+           << "}";
+
+        os << "void " << name << "::" << endl
+           << "_save (" << buf << "& b) const"
+           << "{"
+           << "CLI_POTENTIALLY_UNUSED (b);"
+           << endl;
+        {
+          base_snapshot bs (*this, true);
+          traversal::inherits ib (bs);
+          inherits (c, ib);
+
+          option_snapshot os_ (*this, true);
+          traversal::names no (os_);
+          names (c, no);
+        }
+        os << "}";
+
+        os << "void " << name << "::" << endl
+           << "_load (const char*& p, const char* e)"
+           << "{"
+           << "CLI_POTENTIALLY_UNUSED (p);"
+           << "CLI_POTENTIALLY_UNUSED (e);"
+           << endl;
+        {
+          base_snapshot bs (*this, false);
+          traversal::inherits ib (bs);
+          inherits (c, ib);
+
+          option_snapshot os_ (*this, false);
+          traversal::names no (os_);
+          names (c, no);
+        }
+        os << "}";
+      }
+
       // Usage.
       //
       if (gen_usage != ut_none)
@@ -808,16 +1413,16 @@ namespace
                 if (len == d_len)
                   continue;
 
-                cerr << c.file () << ":" << c.line () << ":" << c.column ()
+                diag << c.file () << ":" << c.line () << ":" << c.column ()
                      << " warning: derived class option length is greater "
                      << "than that of a base class '" << b.name () << "'"
                      << endl;
 
-                cerr << b.file () << ":" << b.line () << ":" << b.column ()
+                diag << b.file () << ":" << b.line () << ":" << b.column ()
                      << " note: class '" << b.name () << "' is defined here"
                      << endl;
 
-                cerr << c.file () << ":" << c.line () << ":" << c.column ()
+                diag << c.file () << ":" << c.line () << ":" << c.column ()
                      << " note: use --option-length to specify uniform length"
                      << endl;
               }
@@ -831,7 +1436,7 @@ namespace
           {
             if (len > max)
             {
-              cerr << o->file () << ":" << o->line () << ":" << o->column ()
+              diag << o->file () << ":" << o->line () << ":" << o->column ()
                    << " error: option length " << len << " is greater than "
                    << max << " specified with --option-length" << endl;
               throw generation_failed ();
@@ -964,6 +1569,11 @@ namespace
            << "}";
       }
 
+      // Lazy options.
+      //
+      if (gen_lazy)
+        names (c, names_option_lazy_);
+
       // _parse ()
       //
       string map ("_cli_" + name + "_map");
@@ -988,15 +1598,93 @@ namespace
          << "static " << map << "_init " << map << "_init_;"
          << endl;
 
+      bool instr (options.generate_instrumentation ());
+
       os << "bool " << name << "::" << endl
          << "_parse (const char* o, " << cli << "::scanner& s)"
-         << "{"
-         << map << "::const_iterator i (" << map << "_.find (o));"
+         << "{";
+
+      // Capture the position and scanner kind before the value is parsed.
+      //
+      if (instr)
+        os << "#ifdef CLI_INSTRUMENT" << endl
+           << cli << "::parse_observer* ob (" << cli << "::parse_observer::current);"
+           << cli << "::parse_observer::tick_type ot (" << endl
+           << "ob != 0 ? " << cli << "::parse_observer::ticks () : 0);"
+           << "std::size_t op (ob != 0 ? s.position () : 0);"
+           << "const char* ok (ob != 0 ? " << cli << "::parse_observer::kind (s) : 0);"
+           << "#endif" << endl
+           << endl;
+
+      // Check the hot options from the profile (--option-profile) that
+      // belong to this class first, in the profile order.
+      //
+      if (unit.context ().count ("hot-options"))
+      {
+        typedef std::vector<string> strings;
+        strings const& hot (unit.context ().get<strings> ("hot-options"));
+
+        option_names on;
+        {
+          option_name n (on);
+          traversal::names ns (n);
+          names (c, ns);
+        }
+
+        bool first (true);
+        for (strings::const_iterator i (hot.begin ()); i != hot.end (); ++i)
+        {
+          option_names::const_iterator j (on.find (*i));
+
+          if (j == on.end ())
+            continue;
+
+          if (first)
+          {
+            os << "// Hot options (--option-profile)." << endl
+               << "//" << endl
+               << "std::size_t n (std::strlen (o));"
+               << endl;
+            first = false;
+          }
+
+          os << "if (n == " << i->size () << " && " <<
+            "std::memcmp (o, \"" << *i << "\", " << i->size () << ") == 0)"
+             << "{";
+
+          option_thunk (*this, *j->second);
+          os << " (*this, s);";
+
+          if (instr)
+            os << endl
+               << "#ifdef CLI_INSTRUMENT" << endl
+               << "if (ob != 0)" << endl
+               << "ob->parsed (\"" << *i << "\", op, ok, " << endl
+               << cli << "::parse_observer::ticks () - ot);"
+               << "#endif" << endl
+               << endl;
+
+          os << "return true;"
+             << "}";
+        }
+      }
+
+      os << map << "::const_iterator i (" << map << "_.find (o));"
          << endl
          << "if (i != " << map << "_.end ())"
          << "{"
-         << "(*(i->second)) (*this, s);"
-         << "return true;"
+         << "(*(i->second)) (*this, s);";
+
+      if (instr)
+        os << endl
+           << "#ifdef CLI_INSTRUMENT" << endl
+           << "if (ob != 0)" << endl
+           << "ob->parsed (i->first.c_str (), op, ok, " << endl
+           << cli << "::parse_observer::ticks () - ot);"
+           << "#endif" << endl
+           << endl;
+
+      os << "return true;"
          << "}";
 
       // Try our bases, from left-to-right.
@@ -1014,10 +1702,58 @@ namespace
         bool comb_flags (pfx && !options.no_combined_flags ());
         bool comb_values (pfx && !options.no_combined_values ());
 
+        // Option abbreviations table.
+        //
+        string abbrev;
+        size_t abbrev_n (0);
+
+        if (pfx && options.allow_abbreviations ())
+        {
+          abbrev_names an;
+          size_t ai (0);
+          class_abbrev ca (an, ai);
+          ca.traverse (c);
+
+          if (!an.empty ())
+          {
+            abbrev = "_cli_" + name + "_abbreviation_";
+            abbrev_n = an.size ();
+
+            // Names and their option indexes as parallel arrays.
+            //
+            os << "static const char* const " << abbrev << "names_[] ="
+               << "{";
+
+            for (abbrev_names::const_iterator i (an.begin ());
+                 i != an.end ();)
+            {
+              os << "\"" << i->first << "\"";
+              os << (++i != an.end () ? "," : "") << endl;
+            }
+
+            os << "};";
+
+            os << "static const std::size_t " << abbrev << "options_[] ="
+               << "{";
+
+            for (abbrev_names::const_iterator i (an.begin ());
+                 i != an.end ();)
+            {
+              os << i->second;
+              os << (++i != an.end () ? "," : "") << endl;
+            }
+
+            os << "};";
+          }
+        }
+
+        bool dyn (options.generate_dynamic_options ());
+
         os << "bool " << name << "::" << endl
            << "_parse (" << cli << "::scanner& s," << endl
            << um << (pfx ? " opt_mode" : "") << "," << endl
-           << um << " arg_mode)"
+           << um << " arg_mode" <<
+          (dyn ? ",\n" + cli + "::dynamic_values* d" : "") << ")"
            << "{";
 
         if (comb_flags)
@@ -1063,6 +1799,13 @@ namespace
            << "continue;"
            << "}";
 
+        if (dyn)
+          os << "if (d != 0 && d->_parse (o, s))"
+             << "{"
+             << "r = true;"
+             << "continue;"
+             << "}";
+
         if (pfx)
         {
           size_t n (opt_prefix.size ());
@@ -1071,8 +1814,44 @@ namespace
             n << ") == 0 && o[" << n << "] != '\\0')"
              << "{";
 
+          // Note that the prefix followed by its last character (for
+          // example, -- for the - prefix) is not treated as an abbreviation
+          // (of every option). Normally it is the option separator.
+          //
+          if (!abbrev.empty ())
+            os << "// Handle option abbreviations." << endl
+               << "//" << endl
+               << "if (std::strcmp (o + " << n << ", \"" <<
+              opt_prefix[n - 1] << "\") != 0)"
+               << "{"
+               << "const char* a (" << cli << "::find_abbreviation (" << endl
+               << "o," << endl
+               << abbrev << "names_," << endl
+               << abbrev << "options_," << endl
+               << abbrev_n << "));"
+               << endl
+               << "if (a != o && _parse (a, s))"
+               << "{"
+               << "r = true;"
+               << "continue;"
+               << "}"
+               << "}";
+
           if (comb_values)
           {
+            // Resolve the option name part as a possible abbreviation.
+            //
+            string co ("co.c_str ()");
+            if (!abbrev.empty ())
+            {
+              ostringstream ostr;
+              ostr << cli << "::find_abbreviation (" << co << "," << endl
+                   << abbrev << "names_," << endl
+                   << abbrev << "options_," << endl
+                   << abbrev_n << ")";
+              co = ostr.str ();
+            }
+
             os << "// Handle combined option values." << endl
                << "//" << endl
                << "std::string co;" // Need to live until next block.
@@ -1089,7 +1868,8 @@ namespace
                <<   "};"
                <<   cli << "::argv_scanner ns (0, ac, av);"
                <<                                                          endl
-               <<   "if (_parse (co.c_str (), ns))"
+               <<   "if (_parse (" << co << ", ns)" <<
+              (dyn ? " ||\n(d != 0 && d->_parse (co.c_str (), ns))" : "") << ")"
                <<   "{"
                <<     "// Parsed the option but not its value?" << endl
                <<     "//" << endl
@@ -1138,7 +1918,8 @@ namespace
                <<     "};"
                <<     cli << "::argv_scanner ns (0, ac, av);"
                <<                                                          endl
-               <<     "if (!_parse (cf, ns))" << endl
+               <<     "if (!_parse (cf, ns)" <<
+              (dyn ? " &&\n!(d != 0 && d->_parse (cf, ns))" : "") << ")" << endl
                <<       "break;"
                <<   "}"
                <<   "if (*p == '\\0')"
@@ -1228,6 +2009,9 @@ namespace
     option_map option_map_;
     traversal::names names_option_map_;
 
+    option_lazy option_lazy_;
+    traversal::names names_option_lazy_;
+
     option_desc option_desc_;
     traversal::names names_option_desc_;
   };
@@ -1268,6 +2052,192 @@ namespace
     usage_type usage_;
     paragraph& para_;
   };
+
+  // Command group.
+  //
+  struct commands: traversal::commands, context
+  {
+    commands (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      typedef std::vector<string> strings;
+      typedef semantics::commands::command_list commands;
+
+      string name (escape (c.name ()));
+      string pfx ("_cli_" + name + "_");
+      strings const& es (c.cxx_enumerators ());
+      commands const& cl (c.list ());
+
+      // Collect all the command names with their enumerators.
+      //
+      strings ns, vs;
+      {
+        strings::const_iterator e (es.begin ());
+        for (commands::const_iterator i (cl.begin ()); i != cl.end ();
+             ++i, ++e)
+        {
+          for (strings::const_iterator j (i->names.begin ());
+               j != i->names.end (); ++j)
+          {
+            ns.push_back (*j);
+            vs.push_back (*e);
+          }
+        }
+      }
+
+      // Find a seed (FNV-1a offset basis) that gives us a perfect hash for
+      // a power of two table size that is at least twice the number of
+      // names. If we cannot find one in a reasonable number of tries, double
+      // the table size. Note that the generated code may calculate the hash
+      // in a wider type but since the table size is a power of two, the bits
+      // that we use are the same.
+      //
+      size_t n (ns.size ()), m (1);
+      unsigned long seed (0);
+
+      while (m < 2 * n)
+        m *= 2;
+
+      for (bool done (false); !done; m *= 2)
+      {
+        seed = 2166136261UL;
+
+        for (size_t t (0); t != 1024 && !done; ++t, ++seed)
+        {
+          std::vector<bool> used (m, false);
+
+          size_t i (0);
+          for (; i != n; ++i)
+          {
+            size_t h (fnv_hash (ns[i], seed) & (m - 1));
+
+            if (used[h])
+              break;
+
+            used[h] = true;
+          }
+
+          done = (i == n);
+        }
+
+        if (done)
+        {
+          --seed;
+          break;
+        }
+      }
+
+      strings tn (m), tv (m);
+      for (size_t i (0); i != n; ++i)
+      {
+        size_t h (fnv_hash (ns[i], seed) & (m - 1));
+        tn[h] = ns[i];
+        tv[h] = vs[i];
+      }
+
+      os << "// " << name << endl
+         << "//" << endl
+         << endl;
+
+      // Hash table as parallel arrays with 0 in the empty slots.
+      //
+      os << "static const char* const " << pfx << "names_[] ="
+         << "{";
+
+      for (size_t i (0); i != m;)
+      {
+        if (tn[i].empty ())
+          os << "0";
+        else
+          os << "\"" << tn[i] << "\"";
+
+        os << (++i != m ? "," : "") << endl;
+      }
+
+      os << "};";
+
+      os << "static const " << name << "::value " << pfx << "values_[] ="
+         << "{";
+
+      for (size_t i (0); i != m;)
+      {
+        os << name << "::" << (tv[i].empty () ? es.front () : tv[i]);
+        os << (++i != m ? "," : "") << endl;
+      }
+
+      os << "};";
+
+      // Primary names indexed by enumerator.
+      //
+      os << "static const char* const " << pfx << "primary_[] ="
+         << "{";
+
+      for (commands::const_iterator i (cl.begin ()); i != cl.end ();)
+      {
+        os << "\"" << i->names.front () << "\"";
+        os << (++i != cl.end () ? "," : "") << endl;
+      }
+
+      os << "};";
+
+      // find()
+      //
+      os << "bool " << name << "::" << endl
+         << "find (const char* n, value& v)"
+         << "{"
+         << "std::size_t h (" << seed << "UL);"
+         << endl
+         << "for (const char* p (n); *p != '\\0'; ++p)" << endl
+         << "h = (h ^ static_cast<unsigned char> (*p)) * 16777619UL;"
+         << endl
+         << "h &= " << m - 1 << ";"
+         << endl
+         << "const char* c (" << pfx << "names_[h]);"
+         << endl
+         << "if (c == 0 || std::strcmp (c, n) != 0)" << endl
+         << "return false;"
+         << endl
+         << "v = " << pfx << "values_[h];"
+         << "return true;"
+         << "}";
+
+      // name()
+      //
+      os << "const char* " << name << "::" << endl
+         << "name (value v)"
+         << "{"
+         << "return " << pfx << "primary_[v];"
+         << "}";
+
+      // print_usage()
+      //
+      if (gen_usage != ut_none)
+      {
+        string up (cli + "::usage_para");
+        string const& ost (options.ostream_type ());
+
+        os << up << " " << name << "::" << endl
+           << "print_usage (value v, " << ost << "& os, " << up << " p)"
+           << "{"
+           << "switch (v)"
+           << "{";
+
+        strings::const_iterator e (es.begin ());
+        for (commands::const_iterator i (cl.begin ()); i != cl.end ();
+             ++i, ++e)
+        {
+          os << "case " << *e << ":" << endl
+             << "return " << fq_name (*i->options) << "::print_usage (os, p);";
+        }
+
+        os << "}"
+           << "return p;"
+           << "}";
+      }
+    }
+  };
 }
 
 void
@@ -1282,14 +2252,17 @@ generate_source (context& ctx)
   traversal::names unit_names;
   namespace_ ns (ctx);
   class_ cl (ctx);
+  commands cmds (ctx);
 
   unit >> unit_names >> ns;
   unit_names >> cl;
+  unit_names >> cmds;
 
   traversal::names ns_names;
 
   ns >> ns_names >> ns;
   ns_names >> cl;
+  ns_names >> cmds;
 
   unit.dispatch (ctx.unit);
 
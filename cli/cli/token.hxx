@@ -81,6 +81,8 @@ public:
     p_dcolon,
     p_lcbrace,
     p_rcbrace,
+    p_lsbrace,
+    p_rsbrace,
     // p_lparen,
     // p_rparen,
     p_eq,
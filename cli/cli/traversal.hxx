@@ -6,6 +6,7 @@
 #define CLI_TRAVERSAL_HXX
 
 #include "traversal/class.hxx"
+#include "traversal/commands.hxx"
 #include "traversal/doc.hxx"
 #include "traversal/elements.hxx"
 #include "traversal/expression.hxx"
@@ -0,0 +1,15 @@
+// file      : cli/traversal/commands.hxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef CLI_TRAVERSAL_COMMANDS_HXX
+#define CLI_TRAVERSAL_COMMANDS_HXX
+
+#include "elements.hxx"
+#include "../semantics/commands.hxx"
+
+namespace traversal
+{
+  struct commands: node<semantics::commands> {};
+}
+
+#endif // CLI_TRAVERSAL_COMMANDS_HXX
@@ -296,7 +296,7 @@ generate_txt (context& ctx)
         cl.traverse (*c);
       else
       {
-        cerr << "error: class '" << *i << "' not found" << endl;
+        ctx.diag << "error: class '" << *i << "' not found" << endl;
         throw generation_failed ();
       }
     }
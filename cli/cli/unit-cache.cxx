@@ -0,0 +1,391 @@
+// file      : cli/unit-cache.cxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef _WIN32
+#  include <unistd.h>    // getpid()
+#  include <sys/types.h> // stat, mkdir()
+#  include <sys/stat.h>  // stat, mkdir()
+#else
+#  include <direct.h>    // _mkdir()
+#  include <process.h>   // _getpid()
+#  include <sys/types.h> // _stat
+#  include <sys/stat.h>  // _stat()
+#endif
+
+#include <cstdio>   // rename(), remove()
+#include <fstream>
+#include <sstream>
+#include <thread>   // this_thread::get_id()
+#include <iterator> // istreambuf_iterator
+
+#include "unit-cache.hxx"
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#else
+  #ifndef CLI_BOOTSTRAP
+  #  include "version.hxx"
+  #else
+  #  define CLI_VERSION_FULL 0
+  #endif
+#endif
+
+using namespace std;
+
+// Bump this version whenever the entry format or the parser behavior
+// changes. Since this is easy to forget during development, the entries
+// are also tied to the cli version (see format_line()).
+//
+static const char format[] = "cli-unit-cache 1";
+
+static string
+format_line ()
+{
+  ostringstream os;
+  os << format << ' ' << CLI_VERSION_FULL;
+  return os.str ();
+}
+
+//
+// SHA-256 (FIPS 180-4).
+//
+
+typedef unsigned int uint32;
+
+static const uint32 sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32
+rotr (uint32 x, unsigned int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+static void
+sha256_block (uint32* h, unsigned char const* p)
+{
+  uint32 w[64];
+
+  for (size_t i (0); i != 16; ++i, p += 4)
+    w[i] = (uint32 (p[0]) << 24) | (uint32 (p[1]) << 16) |
+      (uint32 (p[2]) << 8) | uint32 (p[3]);
+
+  for (size_t i (16); i != 64; ++i)
+  {
+    uint32 s0 (rotr (w[i - 15], 7) ^ rotr (w[i - 15], 18) ^ (w[i - 15] >> 3));
+    uint32 s1 (rotr (w[i - 2], 17) ^ rotr (w[i - 2], 19) ^ (w[i - 2] >> 10));
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32 a (h[0]), b (h[1]), c (h[2]), d (h[3]);
+  uint32 e (h[4]), f (h[5]), g (h[6]), k (h[7]);
+
+  for (size_t i (0); i != 64; ++i)
+  {
+    uint32 s1 (rotr (e, 6) ^ rotr (e, 11) ^ rotr (e, 25));
+    uint32 t1 (k + s1 + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i]);
+    uint32 s0 (rotr (a, 2) ^ rotr (a, 13) ^ rotr (a, 22));
+    uint32 t2 (s0 + ((a & b) ^ (a & c) ^ (b & c)));
+
+    k = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+
+  h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+  h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+static string
+sha256 (string const& s)
+{
+  uint32 h[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+  size_t n (s.size ());
+  unsigned char const* p (reinterpret_cast<unsigned char const*> (s.data ()));
+
+  for (; n >= 64; n -= 64, p += 64)
+    sha256_block (h, p);
+
+  // Pad the last block(s) with 0x80, zeros, and the 64-bit message length
+  // in bits.
+  //
+  unsigned char b[128] = {};
+  for (size_t i (0); i != n; ++i)
+    b[i] = p[i];
+
+  b[n] = 0x80;
+
+  size_t bn (n < 56 ? 64 : 128);
+  unsigned long long bits (static_cast<unsigned long long> (s.size ()) * 8);
+
+  for (size_t i (0); i != 8; ++i)
+    b[bn - 1 - i] = static_cast<unsigned char> (bits >> (i * 8));
+
+  sha256_block (h, b);
+
+  if (bn == 128)
+    sha256_block (h, b + 64);
+
+  static const char hex[] = "0123456789abcdef";
+
+  string r;
+  for (size_t i (0); i != 8; ++i)
+    for (int j (28); j >= 0; j -= 4)
+      r += hex[(h[i] >> j) & 0x0f];
+
+  return r;
+}
+
+static bool
+read_file (string const& p, string& r)
+{
+  ifstream ifs (p.c_str (), ifstream::in | ifstream::binary);
+
+  if (!ifs.is_open ())
+    return false;
+
+  r.assign (istreambuf_iterator<char> (ifs), istreambuf_iterator<char> ());
+  return !ifs.bad ();
+}
+
+//
+// unit_cache
+//
+
+unit_cache::
+unit_cache (path const& dir, paths const& include_paths)
+    : dir_ (dir.string ())
+{
+  writer w;
+  w.write (include_paths.size ());
+
+  for (paths::const_iterator i (include_paths.begin ());
+       i != include_paths.end (); ++i)
+    w.write (i->string ());
+
+  key_ = w.data;
+
+  if (!dir_.empty ())
+  {
+#ifndef _WIN32
+    mkdir (dir_.c_str (), 0777);
+#else
+    _mkdir (dir_.c_str ());
+#endif
+  }
+}
+
+string unit_cache::
+entry_path (path const& unit) const
+{
+  return (path (dir_) / path (sha256 (unit.string () + '\0' + key_))).string ();
+}
+
+bool unit_cache::
+load (path const& unit, string& data)
+{
+  {
+    lock_guard<mutex> l (mutex_);
+
+    entry_map::const_iterator i (entries_.find (unit.string ()));
+    if (i != entries_.end ())
+    {
+      data = i->second;
+      return true;
+    }
+  }
+
+  string s;
+  if (dir_.empty () || !read_file (entry_path (unit), s))
+    return false;
+
+  // The entry starts with the format line followed by the body hash line.
+  //
+  string f (format_line ());
+  size_t n (f.size ());
+
+  if (s.size () < n + 66 ||
+      s.compare (0, n, f) != 0 ||
+      s[n] != '\n' ||
+      s[n + 65] != '\n')
+    return false;
+
+  data.assign (s, n + 66, string::npos);
+
+  // Make sure the entry is not damaged (and not a hash collision).
+  //
+  if (s.compare (n + 1, 64, sha256 (data)) != 0)
+    return false;
+
+  lock_guard<mutex> l (mutex_);
+  entries_[unit.string ()] = data;
+  return true;
+}
+
+void unit_cache::
+save (path const& unit, string const& data)
+{
+  {
+    lock_guard<mutex> l (mutex_);
+    entries_[unit.string ()] = data;
+  }
+
+  if (dir_.empty ())
+    return;
+
+  string p (entry_path (unit));
+
+  ostringstream t;
+#ifndef _WIN32
+  t << p << '.' << getpid () << '.' << this_thread::get_id () << ".tmp";
+#else
+  t << p << '.' << _getpid () << '.' << this_thread::get_id () << ".tmp";
+#endif
+
+  {
+    ofstream ofs (t.str ().c_str (), ofstream::out | ofstream::binary);
+
+    if (!ofs.is_open ())
+      return;
+
+    ofs << format_line () << '\n' << sha256 (data) << '\n' << data;
+
+    if (!ofs.good ())
+    {
+      ofs.close ();
+      remove (t.str ().c_str ());
+      return;
+    }
+  }
+
+#ifdef _WIN32
+  // On Windows rename() does not replace an existing file.
+  //
+  remove (p.c_str ());
+#endif
+
+  if (rename (t.str ().c_str (), p.c_str ()) != 0)
+    remove (t.str ().c_str ());
+}
+
+string unit_cache::
+content (path const& file)
+{
+  string const& p (file.string ());
+
+#ifndef _WIN32
+  struct stat s;
+  int r (stat (p.c_str (), &s));
+#else
+  struct _stat s;
+  int r (_stat (p.c_str (), &s));
+#endif
+
+  if (r != 0)
+    return string ();
+
+  // Use the nanosecond modification time resolution where available so
+  // that a change made within the same second is not missed by a server.
+  //
+  long long mtime (static_cast<long long> (s.st_mtime) * 1000000000);
+#if defined(__APPLE__)
+  mtime += s.st_mtimespec.tv_nsec;
+#elif !defined(_WIN32)
+  mtime += s.st_mtim.tv_nsec;
+#endif
+  long long size (static_cast<long long> (s.st_size));
+
+  {
+    lock_guard<mutex> l (mutex_);
+
+    file_map::const_iterator i (files_.find (p));
+    if (i != files_.end () &&
+        i->second.mtime == mtime &&
+        i->second.size == size)
+      return i->second.hash;
+  }
+
+  // Hash the file without holding the lock.
+  //
+  string c;
+  if (!read_file (p, c))
+    return string ();
+
+  file_state f;
+  f.mtime = mtime;
+  f.size = size;
+  f.hash = sha256 (c);
+
+  lock_guard<mutex> l (mutex_);
+  files_[p] = f;
+  return f.hash;
+}
+
+//
+// writer & reader
+//
+
+void unit_cache::writer::
+write (size_t n)
+{
+  // Variable-length encoding, 7 bits per byte, least significant first.
+  //
+  for (; n >= 0x80; n >>= 7)
+    data += static_cast<char> ((n & 0x7f) | 0x80);
+
+  data += static_cast<char> (n);
+}
+
+void unit_cache::writer::
+write (string const& s)
+{
+  write (s.size ());
+  data += s;
+}
+
+size_t unit_cache::reader::
+read_size ()
+{
+  size_t r (0);
+
+  for (unsigned int shift (0);; shift += 7)
+  {
+    if (pos_ == data_.size () || shift >= sizeof (size_t) * 8)
+      throw malformed ();
+
+    unsigned char c (static_cast<unsigned char> (data_[pos_++]));
+    r |= static_cast<size_t> (c & 0x7f) << shift;
+
+    if ((c & 0x80) == 0)
+      break;
+  }
+
+  return r;
+}
+
+string unit_cache::reader::
+read_string ()
+{
+  size_t n (read_size ());
+
+  if (n > data_.size () - pos_)
+    throw malformed ();
+
+  string r (data_, pos_, n);
+  pos_ += n;
+  return r;
+}
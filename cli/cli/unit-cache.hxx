@@ -0,0 +1,118 @@
+// file      : cli/unit-cache.hxx
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef CLI_UNIT_CACHE_HXX
+#define CLI_UNIT_CACHE_HXX
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef> // size_t
+
+#include "semantics/elements.hxx"
+
+// Cache of parsed included units (see --parse-cache). Each entry is an
+// opaque byte string that is produced and consumed by the parser. The
+// entries are keyed by the absolute unit path and the include search paths
+// (the only options that affect parsing). The cache only stores and checks
+// the integrity of the entries; it is up to the parser to check that an
+// entry is still up to date (see content()).
+//
+// The entries are also kept in memory so that the units included by
+// several inputs compiled in the same process are only parsed once. The
+// cache can be shared by several parsers running concurrently.
+//
+class unit_cache
+{
+public:
+  typedef semantics::path path;
+  typedef std::vector<path> paths;
+
+  // The directory is created if it does not exist. If the directory is
+  // empty, then the entries are only kept in memory.
+  //
+  unit_cache (path const& dir, paths const& include_paths);
+
+  // Load the entry for the unit returning false if there is none or it
+  // is damaged.
+  //
+  bool
+  load (path const& unit, std::string& data);
+
+  // Save the entry for the unit replacing the existing one, if any. The
+  // entry is written to a temporary file which is then renamed so that
+  // concurrent invocations sharing the cache never see a partial entry.
+  // Failure to save is silently ignored.
+  //
+  void
+  save (path const& unit, std::string const& data);
+
+  // Return the content hash (hex SHA-256) of the file or empty string if
+  // it cannot be read. The result is remembered and only recalculated if
+  // the file's modification time or size changes.
+  //
+  std::string
+  content (path const& file);
+
+  // Binary encoding of the entry data.
+  //
+public:
+  class writer
+  {
+  public:
+    void
+    write (std::size_t);
+
+    void
+    write (std::string const&);
+
+    std::string data;
+  };
+
+  // Throw malformed if an attempt is made to read past the end of the
+  // data, which can only happen if the entry (whose integrity is verified
+  // on load) was nevertheless produced by an incompatible parser.
+  //
+  class reader
+  {
+  public:
+    reader (std::string const& data): data_ (data), pos_ (0) {}
+
+    class malformed {};
+
+    std::size_t
+    read_size ();
+
+    std::string
+    read_string ();
+
+  private:
+    std::string const& data_;
+    std::size_t pos_;
+  };
+
+private:
+  std::string
+  entry_path (path const& unit) const;
+
+private:
+  struct file_state
+  {
+    long long mtime;
+    long long size;
+    std::string hash;
+  };
+
+  typedef std::map<std::string, file_state> file_map;
+  typedef std::map<std::string, std::string> entry_map;
+
+  std::string dir_;
+  std::string key_; // Serialized include paths.
+
+  std::mutex mutex_; // Protects files_ and entries_.
+  file_map files_;
+  entry_map entries_;
+};
+
+#endif // CLI_UNIT_CACHE_HXX